@@ -28,7 +28,16 @@ uint64_t elt_hash(const typename Field::Elt& k, const Field& F) {
   uint64_t crc = 0x1;
   uint8_t buf[Field::kBytes];
   F.to_bytes_field(buf, k);
-  for (size_t l = 0; l < Field::kBytes; ++l) {
+  // Consume 64-bit words, then the tail one byte at a time.
+  size_t l = 0;
+  for (; l + 8 <= Field::kBytes; l += 8) {
+    uint64_t u = 0;
+    for (size_t j = 0; j < 8; ++j) {
+      u |= static_cast<uint64_t>(buf[l + j]) << (8 * j);
+    }
+    crc = crc64::update(crc, u);
+  }
+  for (; l < Field::kBytes; ++l) {
     crc = crc64::update(crc, buf[l], 8);
   }
   return crc;
@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include <cstdint>
+#include <vector>
 
 namespace proofs {
 template <class Field>
@@ -47,6 +48,20 @@ class AlgebraUtil {
     }
   }
 
+  // a[i] = inverse(b[i]) via batch_invert(), except that a[i] = 0
+  // when b[i] = 0, rather than one zero spoiling the whole batch.
+  static void batch_invert_or_zero(size_t n, Elt a[/*n*/], const Elt b[/*n*/],
+                                   const Field& F) {
+    std::vector<Elt> nz(b, b + n);
+    for (auto& x : nz) {
+      if (x == F.zero()) x = F.one();
+    }
+    batch_invert(n, a, 1, nz.data(), 1, F);
+    for (size_t i = 0; i < n; ++i) {
+      if (b[i] == F.zero()) a[i] = F.zero();
+    }
+  }
+
   // a[i] = 1/i, with a[0]=0
   static void batch_inverse_arithmetic(size_t n, Elt a[/*n*/], const Field& F) {
     a[0] = F.zero();
@@ -44,6 +44,27 @@ TEST(Utility, BatchInverse) {
   }
 }
 
+TEST(Utility, BatchInverseOrZero) {
+  const Field F(
+      "218882428718392752222464057452572750885483644004160343436982041865758084"
+      "95617");
+  Bogorng<Field> rng(&F);
+
+  constexpr size_t n = 17;
+  Elt a[n], b[n];
+  for (size_t i = 0; i < n; ++i) {
+    b[i] = (i % 5 == 2) ? F.zero() : rng.nonzero();
+  }
+  AlgebraUtil<Field>::batch_invert_or_zero(n, a, b, F);
+  for (size_t i = 0; i < n; ++i) {
+    if (b[i] == F.zero()) {
+      EXPECT_EQ(a[i], F.zero());
+    } else {
+      EXPECT_EQ(a[i], F.invertf(b[i]));
+    }
+  }
+}
+
 //------------------------------------------------------------
 
 // a[i] /= i!, without doing too many inversions
@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
@@ -39,11 +40,27 @@ class Dense {
   using Elt = typename Field::Elt;
 
  public:
+  // A run [begin, end) of entries that are known to be zero.
+  struct ZeroExtent {
+    corner_t begin, end;
+  };
+
+  // Shorter runs of zeros are not worth tracking, and neither are
+  // extents that cover less than 1/kMinZeroFraction of the array.
+  static constexpr corner_t kMinZeroExtent = 8;
+  static constexpr corner_t kMinZeroFraction = 8;
+
   corner_t n0_, n1_;
 
   // Row-major indexing: v_[i1*n0+i0] stores the value at (i0, i1)
   std::vector<Elt> v_;
 
+  // Disjoint zero extents of v_ in increasing order.  Only maintained
+  // for n1_ == 1, after a call to track_zero_extents().  An empty
+  // vector means that nothing is known, and every method behaves as in
+  // the dense case.
+  std::vector<ZeroExtent> zeros_;
+
   explicit Dense(corner_t n0, corner_t n1) : n0_(n0), n1_(n1), v_(n0 * n1) {}
 
   // make0 replacement
@@ -66,9 +83,71 @@ class Dense {
     for (corner_t i = 0; i < n0_ * n1_; ++i) {
       d->v_[i] = v_[i];
     }
+    d->zeros_ = zeros_;
     return d;
   }
 
+  // Scan the array for runs of at least kMinZeroExtent zeros.
+  void track_zero_extents(const Field& F) {
+    check(n1_ == 1, "n1_ == 1");
+    zeros_.clear();
+    corner_t i = 0;
+    while (i < n0_) {
+      if (v_[i] != F.zero()) {
+        ++i;
+        continue;
+      }
+      corner_t b = i;
+      while (i < n0_ && v_[i] == F.zero()) {
+        ++i;
+      }
+      if (i - b >= kMinZeroExtent) {
+        zeros_.push_back(ZeroExtent{b, i});
+      }
+    }
+    if (kMinZeroFraction * known_zeros() < n0_) {
+      zeros_.clear();
+    }
+  }
+
+  corner_t known_zeros() const {
+    corner_t n = 0;
+    for (const ZeroExtent& z : zeros_) {
+      n += z.end - z.begin;
+    }
+    return n;
+  }
+
+  // Set MASK[i] to true iff v_[i] lies within a zero extent, reusing
+  // the storage of MASK.  MASK is left empty if no extents are known.
+  void zero_mask(std::vector<bool>& mask) const {
+    mask.clear();
+    if (!zeros_.empty()) {
+      mask.resize(n0_, false);
+      for (const ZeroExtent& z : zeros_) {
+        std::fill(mask.begin() + z.begin, mask.begin() + z.end, true);
+      }
+    }
+  }
+
+  // Call FN(i) for all even i < n0_ such that the pair (v_[i], v_[i+1])
+  // is not known to be zero.
+  template <class Fn>
+  void for_each_nonzero_pair(Fn fn) const {
+    corner_t i = 0;
+    for (const ZeroExtent& z : zeros_) {
+      corner_t b, e;
+      pair_extent(z, b, e);
+      for (; 2 * i < n0_ && i < b; ++i) {
+        fn(2 * i);
+      }
+      i = e > i ? e : i;
+    }
+    for (; 2 * i < n0_; ++i) {
+      fn(2 * i);
+    }
+  }
+
   void clear(const Field& F) { Blas<Field>::clear(n0_ * n1_, &v_[0], 1, F); }
 
   // For a given random number r, the binding operation computes
@@ -76,6 +155,10 @@ class Dense {
   //        = v[2 * i] + r * (v[2 * i + 1] - v[2 * i])
   // and shrinks the array v by half.
   void bind(const Elt& r, const Field& F) {
+    if (!zeros_.empty()) {
+      bind_sparse(r, F);
+      return;
+    }
     corner_t rd = 0, wr = 0;
     for (corner_t i1 = 0; i1 < n1_; ++i1) {
       corner_t i0 = 0;
@@ -131,6 +214,7 @@ class Dense {
   // fully bound.
   void reshape(corner_t n0) {
     check(n0_ == 1, "n0_ == 1");
+    zeros_.clear();
     check(n0 > 0, "n0 > 0");
     corner_t wasn1 = n1_;
     n0_ = n0;
@@ -145,6 +229,47 @@ class Dense {
     check(n1_ == 1, "n1_ == 1");
     return v_[0];
   }
+
+ private:
+  // The pairs (2i, 2i+1) for i in [b, e) lie within Z, where the entries
+  // past the end of the array count as zero.
+  void pair_extent(const ZeroExtent& z, corner_t& b, corner_t& e) const {
+    corner_t end = (z.end == n0_) ? n0_ + 1 : z.end;
+    b = (z.begin + 1) / 2;
+    e = end / 2;
+  }
+
+  // bind() for n1_ == 1, writing zeros into the pairs that are known to
+  // be zero and shrinking the extents along with the array.
+  void bind_sparse(const Elt& r, const Field& F) {
+    check(n1_ == 1, "n1_ == 1");
+    std::vector<ZeroExtent> bound;
+    corner_t wr = 0;
+    for (const ZeroExtent& z : zeros_) {
+      corner_t b, e;
+      pair_extent(z, b, e);
+      for (; wr < b; ++wr) {
+        bind_pair(wr, r, F);
+      }
+      for (; wr < e; ++wr) {
+        v_[wr] = F.zero();
+      }
+      if (e >= b + kMinZeroExtent) {
+        bound.push_back(ZeroExtent{b, e});
+      }
+    }
+    for (; 2 * wr < n0_; ++wr) {
+      bind_pair(wr, r, F);
+    }
+    n0_ = (n0_ + 1u) / 2u;
+    zeros_.swap(bound);
+  }
+
+  void bind_pair(corner_t wr, const Elt& r, const Field& F) {
+    corner_t rd = 2 * wr;
+    v_[wr] = affine_interpolation(
+        r, v_[rd], (rd + 1 < n0_) ? v_[rd + 1] : F.zero(), F);
+  }
 };
 
 // Helper class to fill a dense array a la std::vector<>
@@ -155,14 +280,19 @@ class DenseFiller {
 
  public:
   // Caller must ensure that W remains valid.
-  explicit DenseFiller(Dense<Field>& W) : pos_(0), w_(W) {
+  explicit DenseFiller(Dense<Field>& W) : pos_(0), copy_(0), w_(W) {
     // only works in this special case
     check(w_.n0_ == 1, "W_.n0_ == 1");
   }
 
+  // Fill the inputs of copy COPY of a circuit with W.n0_ copies.
+  DenseFiller(Dense<Field>& W, size_t copy) : pos_(0), copy_(copy), w_(W) {
+    check(copy_ < w_.n0_, "copy_ < w_.n0_");
+  }
+
   DenseFiller& push_back(const Elt& x) {
     check(pos_ < w_.n1_, "pos_ < w_.n1_");
-    w_.v_[pos_++] = x;
+    w_.v_[pos_++ * w_.n0_ + copy_] = x;
     return *this;
   }
 
@@ -185,8 +315,28 @@ class DenseFiller {
   // number of bits in the string, and "x" is the number to be converted. This
   // works for pushing v8, v32, etc.
   DenseFiller& push_back(uint64_t x, size_t bits, const Field& F) {
+    const Elt kbit[2] = {F.of_scalar(0), F.of_scalar(1)};
+    Elt* v = reserve(bits);
     for (size_t i = 0; i < bits; ++i) {
-      push_back(F.of_scalar((x >> i) & 1));
+      v[i * w_.n0_] = kbit[(x >> i) & 1];
+    }
+    return *this;
+  }
+
+  // Same as push_back(b[i], 8, F) for 0 <= i < n, i.e., the bits of each
+  // byte in little-endian order.  The two constants are computed once
+  // for the whole string, and the bits are stored without per-element
+  // bounds checks.
+  DenseFiller& push_back_bytes(const uint8_t b[/*n*/], size_t n,
+                               const Field& F) {
+    const Elt kbit[2] = {F.of_scalar(0), F.of_scalar(1)};
+    Elt* v = reserve(8 * n);
+    const size_t stride = w_.n0_;
+    for (size_t i = 0; i < n; ++i, v += 8 * stride) {
+      const uint8_t bi = b[i];
+      for (size_t j = 0; j < 8; ++j) {
+        v[j * stride] = kbit[(bi >> j) & 1];
+      }
     }
     return *this;
   }
@@ -194,7 +344,17 @@ class DenseFiller {
   size_t size() const { return pos_; }
 
  private:
+  // Advances the position by N and returns the storage of the N
+  // elements, with stride w_.n0_.
+  Elt* reserve(size_t n) {
+    check(n <= w_.n1_ - pos_, "pos_ + n <= w_.n1_");
+    Elt* v = w_.v_.data() + (pos_ * w_.n0_ + copy_);
+    pos_ += n;
+    return v;
+  }
+
   size_t pos_;
+  size_t copy_;
   Dense<Field>& w_;
 };
 }  // namespace proofs
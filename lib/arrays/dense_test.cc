@@ -0,0 +1,131 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "arrays/dense.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "algebra/bogorng.h"
+#include "algebra/fp.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+using Field = Fp<4>;
+using Elt = typename Field::Elt;
+
+static const Field F(
+    "21888242871839275222246405745257275088548364400416034343698204186575808495"
+    "617");
+
+// An array of N random elements in which the i-th element is zero
+// iff ZERO(i).
+template <class Pred>
+std::unique_ptr<Dense<Field>> mkdense(corner_t n, Pred zero) {
+  Bogorng<Field> rng(&F);
+  auto D = std::make_unique<Dense<Field>>(n, 1);
+  for (corner_t i = 0; i < n; ++i) {
+    D->v_[i] = zero(i) ? F.zero() : rng.next();
+  }
+  return D;
+}
+
+// Binding with zero extents must agree with the dense path.
+template <class Pred>
+void one_test_bind(corner_t n, Pred zero) {
+  Bogorng<Field> rng(&F);
+  auto D = mkdense(n, zero);
+  auto S = D->clone();
+  S->track_zero_extents(F);
+
+  while (D->n0_ > 1) {
+    // every pair that is skipped must be zero
+    std::vector<bool> visited(D->n0_, false);
+    S->for_each_nonzero_pair([&](corner_t i) { visited[i] = true; });
+    for (corner_t i = 0; i < D->n0_; i += 2) {
+      if (!visited[i]) {
+        EXPECT_EQ(D->at_corners(i, 0, F), F.zero());
+        EXPECT_EQ(D->at_corners(i + 1, 0, F), F.zero());
+      }
+    }
+
+    Elt r = rng.next();
+    D->bind(r, F);
+    S->bind(r, F);
+    EXPECT_EQ(D->n0_, S->n0_);
+    for (corner_t i = 0; i < D->n0_; ++i) {
+      EXPECT_EQ(D->v_[i], S->v_[i]);
+    }
+  }
+}
+
+TEST(Dense, BindZeroExtents) {
+  for (corner_t n : {1, 2, 7, 8, 9, 33, 100, 1000, 1025}) {
+    one_test_bind(n, [](corner_t i) { return false; });
+    one_test_bind(n, [](corner_t i) { return true; });
+    one_test_bind(n, [n](corner_t i) { return i >= n / 3; });
+    one_test_bind(n, [n](corner_t i) { return i < n / 2 + 1; });
+    one_test_bind(n, [](corner_t i) { return (i / 13) % 2 == 1; });
+    one_test_bind(n, [](corner_t i) { return (i % 50) >= 9; });
+  }
+}
+
+TEST(Dense, TrackZeroExtents) {
+  auto D = mkdense(100, [](corner_t i) {
+    return (i >= 3 && i < 10) || (i >= 20 && i < 28) || i >= 91;
+  });
+  D->track_zero_extents(F);
+  ASSERT_EQ(D->zeros_.size(), 2);
+  EXPECT_EQ(D->zeros_[0].begin, 20);
+  EXPECT_EQ(D->zeros_[0].end, 28);
+  EXPECT_EQ(D->zeros_[1].begin, 91);
+  EXPECT_EQ(D->zeros_[1].end, 100);
+}
+
+// push_back_bytes() must fill the same elements as one push_back(b, 8, F)
+// per byte, including when filling one copy of several.
+TEST(Dense, FillerPushBackBytes) {
+  std::vector<uint8_t> bytes(37);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(i * 89 + 13);
+  }
+  const size_t n1 = 8 * bytes.size() + 3;
+  for (size_t n0 : {1, 3}) {
+    for (size_t copy = 0; copy < n0; ++copy) {
+      Dense<Field> want(n0, n1), got(n0, n1);
+      want.clear(F);
+      got.clear(F);
+      DenseFiller<Field> fw(want, copy), fg(got, copy);
+      fw.push_back(F.one());
+      fg.push_back(F.one());
+      for (uint8_t b : bytes) {
+        fw.push_back(b, 8, F);
+      }
+      fg.push_back_bytes(bytes.data(), bytes.size(), F);
+      fw.push_back(5, 2, F);
+      fg.push_back(5, 2, F);
+      EXPECT_EQ(fw.size(), n1);
+      EXPECT_EQ(fg.size(), n1);
+      for (size_t i = 0; i < n0 * n1; ++i) {
+        EXPECT_EQ(want.v_[i], got.v_[i]);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace proofs
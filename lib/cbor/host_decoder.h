@@ -28,6 +28,148 @@ namespace proofs {
 enum CborTag { UNSIGNED, NEGATIVE, BYTES, TEXT, ARRAY, MAP, TAG, PRIMITIVE };
 enum CborPrimitive { FALSE, TRUE, CNULL };
 
+// A union is used to store the attributes for either singleton objects (i.e.,
+// UNSIGNED, NEGATIVE, PRIMITIVE), the start position and len of TEXT and
+// BYTES array, and the children information for ARRAY or MAP objects.
+union CborValue {
+  uint64_t u64;         /* UNSIGNED */
+  int64_t i64;          /* NEGATIVE */
+  enum CborPrimitive p; /* PRIMITIVE */
+
+  // BYTES + TEXT, represented as offset in input + length
+  struct {
+    size_t pos;
+    size_t len;
+  } string;
+
+  // arrays, maps, and tags: an array of children nodes.
+  struct {
+    // The original count in the source document.  For tags,
+    // the tag itself.
+    size_t n;
+
+    // The actual number of children (e.g. 2*n for maps).
+    size_t nchildren;
+  } items;
+};
+
+// Decodes the head of the CBOR item at IN[POS] into its tag T and
+// attributes U, and advances POS past the head and, for BYTES and TEXT,
+// past the payload.  The children of ARRAY, MAP, and TAG items are not
+// decoded; U.items.nchildren tells how many items follow.
+//
+// This function handles adversarial inputs, and returns false when the
+// item is malformed or not in the subset of CBOR used in MDOC.
+inline bool decode_cbor_head(const uint8_t in[], size_t len, size_t &pos,
+                             CborTag &t, CborValue &u) {
+  /* invariant: pos is always compared with len before it is referenced. */
+  if (pos >= len) {
+    return false;
+  }
+  uint8_t b = in[pos++];
+
+  size_t type = (b >> 5) & 0x7u;
+  size_t count0 = b & 0x1Fu;
+
+  // variable-length count
+  size_t count = 0;
+  if (count0 < 24) {
+    count = count0;
+  } else if (count0 == 24) {
+    if (pos >= len) {
+      return false;
+    }
+    count = in[pos++];
+  } else if (count0 == 25) {
+    if (pos + 1 >= len) {
+      return false;
+    }
+    count = in[pos] * 256 + in[pos + 1];
+    pos += 2;
+  } else if (count0 == 26) {
+    if (pos + 3 >= len) {
+      return false;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      count *= 256;
+      count += in[pos++];
+    }
+  } else {
+    return false;
+  }
+
+  switch (type) { /* type \in [0,7] by construction */
+    case 0:
+      t = UNSIGNED;
+      u.u64 = count;
+      break;
+    case 1:
+      t = NEGATIVE;
+      u.i64 = -(int64_t)count;
+      break;
+
+    case 2: /* BYTES */
+    case 3: /* TEXT */
+      if (pos + count > len) {
+        return false;
+      }
+      t = (type == 2) ? BYTES : TEXT;
+      u.string.pos = pos;
+      u.string.len = count;
+      pos += count;
+      break;
+
+    case 4: /* ARRAY */
+      if (pos + count > len) {
+        return false;
+      }
+      t = ARRAY;
+      u.items.n = count;
+      u.items.nchildren = count;
+      break;
+
+    case 5: /* MAP, (key,val) pairs are stored as 2*children */
+      if (pos + 2 * count > len) {
+        return false;
+      }
+      t = MAP;
+      u.items.n = count;
+      u.items.nchildren = 2 * count;
+      break;
+
+    case 6: /* TAG */
+      // Special cases for TAG
+      if (count == 1004) {  // date in the form YYYY-MM-DD
+        if (pos + 1 + 10 > len) {  // 0xDA for str length + 10 characters
+          return false;
+        }
+      }
+      t = TAG;
+      u.items.n = count;
+      u.items.nchildren = 1;
+      break;
+
+    case 7: /* PRIMITIVE */
+      t = PRIMITIVE;
+      switch (count) {
+        case 20:
+          u.p = FALSE;
+          break;
+        case 21:
+          u.p = TRUE;
+          break;
+        case 22:
+          u.p = CNULL;
+          break;
+        default:
+          return false;
+      }
+      break;
+  }
+
+  return true;
+}
+
 // CBOR decoder for a subset of CBOR used in MDOC.
 //
 // The main advantage of this decoder is that it keeps
@@ -49,31 +191,8 @@ class CborDoc {
   size_t header_pos_;
   enum CborTag t_;
 
-  // A union is used to store the attributes for either singleton objects (i.e.,
-  // UNSIGNED, NEGATIVE, PRIMITIVE), the start position and len of TEXT and
-  // BYTES array, and the children information for ARRAY or MAP objects.
-  // len of strings and byte arrays
-  union U {
-    uint64_t u64;         /* UNSIGNED */
-    int64_t i64;          /* NEGATIVE */
-    enum CborPrimitive p; /* PRIMITIVE */
-
-    // BYTES + TEXT, represented as offset in input + length
-    struct {
-      size_t pos;
-      size_t len;
-    } string;
-
-    // arrays, maps, and tags: an array of children nodes.
-    struct {
-      // The original count in the source document.  For tags,
-      // the tag itself.
-      size_t n;
-
-      // The actual number of children (e.g. 2*n for maps).
-      size_t nchildren;
-    } items;
-  } u_;
+  // The attributes of this node, see CborValue.
+  CborValue u_;
 
   // This field only applies to ARRAY, MAP nodes, but it has been moved
   // out of the union to avoid including components with non-default
@@ -91,104 +210,16 @@ class CborDoc {
   // This function can handle adversarial inputs, and returns false when the
   // input cannot be parsed.
   bool decode(const uint8_t in[], size_t len, size_t &pos, size_t offset) {
-    /* invariant: pos is always compared with len before it is referenced. */
     header_pos_ = pos + offset;
-
-    if (pos >= len) {
+    if (!decode_cbor_head(in, len, pos, t_, u_)) {
       return false;
     }
-    uint8_t b = in[pos++];
-
-    size_t type = (b >> 5) & 0x7u;
-    size_t count0 = b & 0x1Fu;
-
-    // variable-length count
-    size_t count = 0;
-    if (count0 < 24) {
-      count = count0;
-    } else if (count0 == 24) {
-      if (pos >= len) {
-        return false;
+    if (t_ == ARRAY || t_ == MAP || t_ == TAG) {
+      children_.resize(u_.items.nchildren);
+      for (size_t i = 0; i < u_.items.nchildren; ++i) {
+        if (!children_[i].decode(in, len, pos, offset)) return false;
       }
-      count = in[pos++];
-    } else if (count0 == 25) {
-      if (pos + 1 >= len) {
-        return false;
-      }
-      count = in[pos] * 256 + in[pos + 1];
-      pos += 2;
-    } else if (count0 == 26) {
-      if (pos + 3 >= len) {
-        return false;
-      }
-      for (size_t i = 0; i < 4; ++i) {
-        count *= 256;
-        count += in[pos++];
-      }
-    } else {
-      return false;
     }
-
-    switch (type) { /* type \in [0,7] by construction */
-      case 0:
-        t_ = UNSIGNED;
-        u_.u64 = count;
-        break;
-      case 1:
-        t_ = NEGATIVE;
-        u_.i64 = -(int64_t)count;
-        break;
-
-      case 2: /* BYTES */
-      case 3: /* TEXT */
-        if (pos + count > len) {
-          return false;
-        }
-        t_ = (type == 2) ? BYTES : TEXT;
-        u_.string.pos = pos;
-        u_.string.len = count;
-        pos += count;
-        break;
-
-      case 4: /* ARRAY */
-        if (pos + count > len) {
-          return false;
-        }
-        return decode_items(ARRAY, count, count, in, len, pos, offset);
-
-      case 5: /* MAP, (key,val) pairs are stored as 2*children */
-        if (pos + 2 * count > len) {
-          return false;
-        }
-        return decode_items(MAP, 2 * count, count, in, len, pos, offset);
-
-      case 6: /* TAG */
-        // Special cases for TAG
-        if (count == 1004) {  // date in the form YYYY-MM-DD
-          if (pos + 1 + 10 > len) {  // 0xDA for str length + 10 characters
-            return false;
-          }
-        }
-        return decode_items(TAG, 1, count, in, len, pos, offset);
-
-      case 7: /* PRIMITIVE */
-        t_ = PRIMITIVE;
-        switch (count) {
-          case 20:
-            u_.p = FALSE;
-            break;
-          case 21:
-            u_.p = TRUE;
-            break;
-          case 22:
-            u_.p = CNULL;
-            break;
-          default:
-            return false;
-        }
-        break;
-    }
-
     return true;
   }
 
@@ -296,20 +327,6 @@ class CborDoc {
   }
 
  private:
-  // Decodes a sequence of children nodes.
-  bool decode_items(CborTag t, size_t nchildren, size_t items_n,
-                    const uint8_t in[], size_t len, size_t &pos,
-                    size_t offset) {
-    t_ = t;
-    u_.items.n = items_n;
-    u_.items.nchildren = nchildren;
-    children_.resize(nchildren);
-    for (size_t i = 0; i < nchildren; ++i) {
-      if (!children_[i].decode(in, len, pos, offset)) return false;
-    }
-    return true;
-  }
-
   // Compares a text node to a given string of bytes.
   bool eq(const uint8_t *const in, size_t len,
           const uint8_t bytes[/*len*/]) const {
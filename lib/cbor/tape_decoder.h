@@ -0,0 +1,207 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CBOR_TAPE_DECODER_H_
+#define PRIVACY_PROOFS_ZK_LIB_CBOR_TAPE_DECODER_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "cbor/host_decoder.h"
+#include "util/panic.h"
+
+namespace proofs {
+
+// One item of a CborTape.  The items of a document are stored in
+// pre-order in one contiguous array: the children of an ARRAY, MAP, or
+// TAG item immediately follow it, and size_ counts the tokens of the
+// subtree rooted at the item, so that this + size_ is the next sibling.
+//
+// The fields have the same meaning as the ones of CborDoc, and the
+// lookup methods return pointers with the same contract: a key returned
+// by lookup() is a scalar, and therefore the value is the next token.
+struct CborToken {
+  size_t header_pos_;
+  enum CborTag t_;
+  CborValue u_;
+  size_t size_;
+
+  // The token that follows the subtree rooted at this token.
+  const CborToken *next() const { return this + size_; }
+
+  // Lookup a child node in an array. Returns null if the query is invalid.
+  // Costs O(index) skips, use next() to iterate over an array.
+  const CborToken *index(size_t index) const {
+    if (t_ == ARRAY && index < u_.items.nchildren) {
+      const CborToken *c = this + 1;
+      for (size_t i = 0; i < index; ++i) {
+        c = c->next();
+      }
+      return c;
+    }
+    return nullptr;
+  }
+
+  // Lookup a key in a map of type {bytes->elements}, see CborDoc::lookup.
+  const CborToken *lookup(const uint8_t *const in, size_t len,
+                          const uint8_t bytes[/*len*/], size_t &ndx) const {
+    return find_key(ndx, [&](const CborToken *key) {
+      return key->t_ == TEXT && key->u_.string.len == len &&
+             memcmp(bytes, &in[key->u_.string.pos], len) == 0;
+    });
+  }
+
+  // Lookup a key in a map of type {unsigned->object}.
+  // Returns null if the query is invalid.
+  const CborToken *lookup_unsigned(uint64_t k, size_t &ndx) const {
+    return find_key(ndx, [&](const CborToken *key) {
+      return key->t_ == UNSIGNED && key->u_.u64 == k;
+    });
+  }
+
+  // Lookup a key in a map of type {negative->object}.
+  // Returns null if the query is invalid.
+  const CborToken *lookup_negative(int64_t k, size_t &ndx) const {
+    return find_key(ndx, [&](const CborToken *key) {
+      return key->t_ == NEGATIVE && key->u_.i64 == k;
+    });
+  }
+
+  // Returns the index of the item with respect to the document bytes.
+  size_t position() const {
+    switch (t_) {
+      case UNSIGNED:
+      case PRIMITIVE:
+        return header_pos_;
+      case BYTES:
+      case TEXT:
+        return u_.string.pos;
+      case TAG:
+        return this[1].u_.string.pos;
+      default:
+        check(false, "valueIndex called on non-value type");
+    }
+    return 0;
+  }
+
+  // Returns the length of the item's value in bytes, see CborDoc::length.
+  size_t length() const {
+    switch (t_) {
+      case UNSIGNED:
+        if (u_.u64 < 24) {
+          return 1;
+        } else if (u_.u64 < 256) {
+          return 2;
+        } else if (u_.u64 < 65536) {
+          return 3;
+        }
+        return 5;
+      case BYTES:
+      case TEXT:
+        return u_.string.len;
+      case TAG:
+        return this[1].u_.string.len;  //  full-date #6.1004(tstr) format
+      case PRIMITIVE:
+        return 1;
+      default:
+        check(false, "valueLength called on non-value type");
+    }
+    return 0;
+  }
+
+ private:
+  // Walks the keys of a map, skipping over the values in O(1) each.
+  template <class Pred>
+  const CborToken *find_key(size_t &ndx, const Pred &match) const {
+    if (t_ == MAP) {
+      const CborToken *key = this + 1;
+      for (size_t i = 0; i < u_.items.n; ++i) {
+        if (match(key)) {
+          ndx = i;
+          return key;
+        }
+        key = key->next()->next();
+      }
+    }
+    return nullptr;
+  }
+};
+
+// Tape-style CBOR decoder for the same subset of CBOR as CborDoc.
+//
+// CborDoc allocates one vector of children per container and recurses
+// once per nesting level.  Instead, CborTape decodes the document in one
+// iterative pass into a flat array of CborTokens, and skips over a
+// subtree in constant time.  A CborTape can be reused for several
+// documents, in which case decode() reuses the storage of the previous
+// document.  The tokens are owned by the tape, and the pointers returned
+// by root() and by the lookup methods are invalidated by the next call
+// to decode().
+class CborTape {
+ public:
+  // Parse a byte sequence into the tape, with the same arguments and
+  // the same result as CborDoc::decode().  Unlike CborDoc, the nesting
+  // depth of the input does not consume native stack.
+  bool decode(const uint8_t in[], size_t len, size_t &pos, size_t offset) {
+    tokens_.clear();
+    open_.clear();
+    do {
+      size_t i = tokens_.size();
+      tokens_.push_back(CborToken{});
+      CborToken &tok = tokens_.back();
+      tok.header_pos_ = pos + offset;
+      if (!decode_cbor_head(in, len, pos, tok.t_, tok.u_)) {
+        tokens_.clear();
+        return false;
+      }
+      if ((tok.t_ == ARRAY || tok.t_ == MAP || tok.t_ == TAG) &&
+          tok.u_.items.nchildren > 0) {
+        open_.push_back(OpenItem{i, tok.u_.items.nchildren});
+        continue;
+      }
+      tok.size_ = 1;
+
+      // Close all the containers whose last child is this token.
+      while (!open_.empty() && --open_.back().pending == 0) {
+        size_t c = open_.back().ndx;
+        tokens_[c].size_ = tokens_.size() - c;
+        open_.pop_back();
+      }
+    } while (!open_.empty());
+    return true;
+  }
+
+  // The root of the last decoded document, or null if decode() failed.
+  const CborToken *root() const {
+    return tokens_.empty() ? nullptr : &tokens_[0];
+  }
+
+  size_t size() const { return tokens_.size(); }
+
+ private:
+  struct OpenItem {
+    size_t ndx;      // index of the container in tokens_
+    size_t pending;  // number of children not yet decoded
+  };
+
+  std::vector<CborToken> tokens_;
+  std::vector<OpenItem> open_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CBOR_TAPE_DECODER_H_
@@ -0,0 +1,277 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cbor/tape_decoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cbor/host_decoder.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+// helper function to encode CBOR input bytes
+static inline uint8_t X(uint8_t type, uint8_t count) {
+  return (type << 5) | count;
+}
+
+static void put_head(std::vector<uint8_t> &out, uint8_t type, size_t count) {
+  if (count < 24) {
+    out.push_back(X(type, count));
+  } else if (count < 256) {
+    out.push_back(X(type, 24));
+    out.push_back(count);
+  } else {
+    out.push_back(X(type, 25));
+    out.push_back(count >> 8);
+    out.push_back(count & 0xff);
+  }
+}
+
+// Appends a random item of nesting depth at most DEPTH to OUT.
+static void random_item(std::mt19937 &rng, size_t depth,
+                        std::vector<uint8_t> &out) {
+  size_t kind = rng() % (depth > 0 ? 8 : 5);
+  switch (kind) {
+    case 0:
+      put_head(out, 0, rng() % 1000);
+      break;
+    case 1:
+      put_head(out, 1, rng() % 1000);
+      break;
+    case 2:
+    case 3: {
+      size_t n = rng() % 40;
+      put_head(out, kind, n);
+      for (size_t i = 0; i < n; ++i) out.push_back('a' + rng() % 4);
+      break;
+    }
+    case 4:
+      out.push_back(X(7, 20 + rng() % 3));
+      break;
+    case 5: {
+      size_t n = rng() % 6;
+      put_head(out, 4, n);
+      for (size_t i = 0; i < n; ++i) random_item(rng, depth - 1, out);
+      break;
+    }
+    case 6: {
+      size_t n = rng() % 6;
+      put_head(out, 5, n);
+      for (size_t i = 0; i < n; ++i) {
+        put_head(out, 3, 1);
+        out.push_back('a' + rng() % 8);
+        random_item(rng, depth - 1, out);
+      }
+      break;
+    }
+    case 7:
+      put_head(out, 6, 24);
+      random_item(rng, depth - 1, out);
+      break;
+  }
+}
+
+// Checks that the subtree of the tape at T is the tree D, and returns the
+// token that follows the subtree.
+static const CborToken *expect_same(const CborDoc &d, const CborToken *t) {
+  EXPECT_EQ(d.header_pos_, t->header_pos_);
+  EXPECT_EQ(d.t_, t->t_);
+  switch (d.t_) {
+    case UNSIGNED:
+      EXPECT_EQ(d.u_.u64, t->u_.u64);
+      break;
+    case NEGATIVE:
+      EXPECT_EQ(d.u_.i64, t->u_.i64);
+      break;
+    case PRIMITIVE:
+      EXPECT_EQ(d.u_.p, t->u_.p);
+      break;
+    case BYTES:
+    case TEXT:
+      EXPECT_EQ(d.u_.string.pos, t->u_.string.pos);
+      EXPECT_EQ(d.u_.string.len, t->u_.string.len);
+      break;
+    case ARRAY:
+    case MAP:
+    case TAG: {
+      EXPECT_EQ(d.u_.items.n, t->u_.items.n);
+      EXPECT_EQ(d.u_.items.nchildren, t->u_.items.nchildren);
+      const CborToken *c = t + 1;
+      for (const CborDoc &dc : d.children_) {
+        c = expect_same(dc, c);
+      }
+      EXPECT_EQ(c, t->next());
+      break;
+    }
+  }
+  return t->next();
+}
+
+TEST(TapeDecoderTest, MatchesCborDoc) {
+  std::mt19937 rng(7);
+  CborTape tape;
+  for (size_t iter = 0; iter < 300; ++iter) {
+    std::vector<uint8_t> in;
+    random_item(rng, 1 + iter % 6, in);
+    size_t pos = 0, tpos = 0;
+    CborDoc doc;
+    EXPECT_TRUE(doc.decode(in.data(), in.size(), pos, 3));
+    EXPECT_TRUE(tape.decode(in.data(), in.size(), tpos, 3));
+    EXPECT_EQ(pos, tpos);
+    EXPECT_EQ(expect_same(doc, tape.root()), tape.root() + tape.size());
+
+    // Both decoders must agree on every truncation and on corrupted
+    // inputs.
+    for (size_t len = 0; len < in.size(); ++len) {
+      pos = tpos = 0;
+      EXPECT_EQ(doc.decode(in.data(), len, pos, 0),
+                tape.decode(in.data(), len, tpos, 0));
+    }
+    for (size_t k = 0; k < 8 && !in.empty(); ++k) {
+      std::vector<uint8_t> bad = in;
+      bad[rng() % bad.size()] = rng();
+      pos = tpos = 0;
+      CborDoc bdoc;
+      bool ok = bdoc.decode(bad.data(), bad.size(), pos, 0);
+      EXPECT_EQ(ok, tape.decode(bad.data(), bad.size(), tpos, 0));
+      if (ok) {
+        EXPECT_EQ(pos, tpos);
+        expect_same(bdoc, tape.root());
+      } else {
+        EXPECT_EQ(tape.root(), nullptr);
+      }
+    }
+  }
+}
+
+TEST(TapeDecoderTest, Lookup) {
+  // {"a": [1, {"x": 2}], "bb": 0("c"), 7: n2, n1: 200, "d": [[], {}]},
+  // where nK is the NEGATIVE item with count K, which decodes to -K.
+  std::vector<uint8_t> in = {X(5, 5), X(3, 1), 'a', X(4, 2), 1, X(5, 1),
+                             X(3, 1), 'x', 2, X(3, 2), 'b', 'b', X(6, 0),
+                             X(3, 1), 'c', 7, X(1, 2), X(1, 1), X(0, 24), 200,
+                             X(3, 1), 'd', X(4, 2), X(4, 0), X(5, 0)};
+  CborTape tape;
+  size_t pos = 0, ndx;
+  ASSERT_TRUE(tape.decode(in.data(), in.size(), pos, 0));
+  EXPECT_EQ(pos, in.size());
+  const CborToken *root = tape.root();
+
+  const CborToken *a = root->lookup(in.data(), 1, (const uint8_t *)"a", ndx);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(ndx, 0u);
+  EXPECT_EQ(a[1].t_, ARRAY);
+  EXPECT_EQ(a[1].index(0)->u_.u64, 1u);
+  const CborToken *x =
+      a[1].index(1)->lookup(in.data(), 1, (const uint8_t *)"x", ndx);
+  ASSERT_NE(x, nullptr);
+  EXPECT_EQ(x[1].u_.u64, 2u);
+  EXPECT_EQ(a[1].index(2), nullptr);
+
+  const CborToken *bb = root->lookup(in.data(), 2, (const uint8_t *)"bb", ndx);
+  ASSERT_NE(bb, nullptr);
+  EXPECT_EQ(ndx, 1u);
+  EXPECT_EQ(bb[1].t_, TAG);
+  EXPECT_EQ(bb[1].position(), 14u);
+  EXPECT_EQ(bb[1].length(), 1u);
+
+  const CborToken *k7 = root->lookup_unsigned(7, ndx);
+  ASSERT_NE(k7, nullptr);
+  EXPECT_EQ(ndx, 2u);
+  EXPECT_EQ(k7[1].u_.i64, -2);
+
+  const CborToken *kn1 = root->lookup_negative(-1, ndx);
+  ASSERT_NE(kn1, nullptr);
+  EXPECT_EQ(ndx, 3u);
+  EXPECT_EQ(kn1[1].length(), 2u);
+
+  const CborToken *d = root->lookup(in.data(), 1, (const uint8_t *)"d", ndx);
+  ASSERT_NE(d, nullptr);
+  EXPECT_EQ(ndx, 4u);
+  EXPECT_EQ(d[1].index(1)->t_, MAP);
+  EXPECT_EQ(d[1].next(), root->next());
+
+  EXPECT_EQ(root->lookup(in.data(), 1, (const uint8_t *)"c", ndx), nullptr);
+  EXPECT_EQ(root->lookup_unsigned(1, ndx), nullptr);
+  EXPECT_EQ(root->lookup_negative(-3, ndx), nullptr);
+  EXPECT_EQ(root->index(0), nullptr);
+}
+
+TEST(TapeDecoderTest, DeepNesting) {
+  // A nesting depth that would exhaust the native stack of a recursive
+  // decoder.
+  constexpr size_t kDepth = 1 << 20;
+  std::vector<uint8_t> in(kDepth, X(4, 1));
+  in.push_back(0);
+  CborTape tape;
+  size_t pos = 0;
+  EXPECT_TRUE(tape.decode(in.data(), in.size(), pos, 0));
+  EXPECT_EQ(tape.size(), kDepth + 1);
+  EXPECT_EQ(tape.root()->size_, kDepth + 1);
+
+  in.pop_back();
+  pos = 0;
+  EXPECT_FALSE(tape.decode(in.data(), in.size(), pos, 0));
+}
+
+// An array of N maps that resemble the encoded attributes of an mdoc.
+static std::vector<uint8_t> attribute_list(size_t n) {
+  std::vector<uint8_t> out;
+  put_head(out, 4, n);
+  for (size_t i = 0; i < n; ++i) {
+    put_head(out, 5, 4);
+    for (std::string_view k :
+         {"digestID", "random", "elementIdentifier", "elementValue"}) {
+      put_head(out, 3, k.size());
+      out.insert(out.end(), k.begin(), k.end());
+      if (k == "digestID") {
+        put_head(out, 0, i);
+      } else {
+        put_head(out, 2, 16);
+        out.insert(out.end(), 16, 'z');
+      }
+    }
+  }
+  return out;
+}
+
+void BM_CborDocDecode(benchmark::State &state) {
+  std::vector<uint8_t> in = attribute_list(state.range(0));
+  for (auto s : state) {
+    CborDoc doc;
+    size_t pos = 0;
+    benchmark::DoNotOptimize(doc.decode(in.data(), in.size(), pos, 0));
+  }
+}
+BENCHMARK(BM_CborDocDecode)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_CborTapeDecode(benchmark::State &state) {
+  std::vector<uint8_t> in = attribute_list(state.range(0));
+  CborTape tape;
+  for (auto s : state) {
+    size_t pos = 0;
+    benchmark::DoNotOptimize(tape.decode(in.data(), in.size(), pos, 0));
+  }
+}
+BENCHMARK(BM_CborTapeDecode)->Arg(8)->Arg(64)->Arg(512);
+
+}  // namespace
+}  // namespace proofs
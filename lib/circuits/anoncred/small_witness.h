@@ -87,9 +87,7 @@ class SmallWitness {
     dkw_.fill_witness(filler);
 
     filler.push_back(numb_, 8, ec_.f_);
-    for (size_t i = 0; i < kMaxSHABlocks * 64; ++i) {
-      filler.push_back(signed_bytes_[i], 8, ec_.f_);
-    }
+    filler.push_back_bytes(signed_bytes_, kMaxSHABlocks * 64, ec_.f_);
     for (size_t j = 0; j < kMaxSHABlocks; j++) {
       fill_sha(filler, bw_[j]);
     }
@@ -14,11 +14,14 @@
 
 #include "circuits/base64/decode.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <vector>
 
+#include "circuits/base64/decode_util.h"
 #include "circuits/logic/evaluation_backend.h"
 #include "circuits/logic/logic.h"
 #include "ec/p256.h"
@@ -114,5 +117,34 @@ TEST(Base64, DecodeBase64) {
   test_strings(p256_base);
 }
 
+TEST(Base64, DecodeUtil) {
+  struct test {
+    const char *b64;
+    std::vector<uint8_t> want;
+  };
+  // A partial quad at the end is padded with zero sextets.
+  const test cases[] = {
+      {"", {}},
+      {"cw", {'s', 0, 0}},
+      {"MzMz", {'3', '3', '3'}},
+      {"NDQ0NA", {'4', '4', '4', '4', 0, 0}},
+      {"-_8", {0xfb, 0xff, 0}},
+  };
+  for (const test &tc : cases) {
+    std::vector<uint8_t> out = {7};
+    EXPECT_TRUE(base64_decode_url(tc.b64, out));
+    ASSERT_EQ(out.size(), 1 + tc.want.size());
+    EXPECT_EQ(out[0], 7);
+    EXPECT_TRUE(std::equal(tc.want.begin(), tc.want.end(), out.begin() + 1));
+  }
+
+  // Invalid characters anywhere fail, and leave OUT unchanged.
+  for (const char *bad : {"aGV=", "a+Vs", "aGVsb/8", "aGVsbG8\n", "\xff"}) {
+    std::vector<uint8_t> out = {7};
+    EXPECT_FALSE(base64_decode_url(bad, out));
+    EXPECT_EQ(out, std::vector<uint8_t>{7});
+  }
+}
+
 }  // namespace
 }  // namespace proofs
@@ -22,24 +22,54 @@
 
 namespace proofs {
 
-bool base64_decode_url(std::string inp, std::vector<uint8_t>& out) {
-  std::string valid =
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+namespace {
 
-  for (size_t i = 0; i < inp.size(); i += 4) {
+constexpr uint8_t kInvalid = 0xff;
+
+struct Base64UrlTable {
+  uint8_t v[256];
+
+  constexpr Base64UrlTable() : v() {
+    const char valid[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    for (size_t c = 0; c < 256; ++c) {
+      v[c] = kInvalid;
+    }
+    for (size_t i = 0; i < 64; ++i) {
+      v[static_cast<uint8_t>(valid[i])] = static_cast<uint8_t>(i);
+    }
+  }
+};
+
+// Sextet of each base64url character, or kInvalid.
+constexpr Base64UrlTable kSextet;
+
+}  // namespace
+
+// Decodes four characters at a time through a lookup table.  A partial
+// quad at the end is padded with zero sextets, so the output always has
+// 3 * ceil(n / 4) bytes.
+bool base64_decode_url(const std::string& inp, std::vector<uint8_t>& out) {
+  const size_t n = inp.size();
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(inp.data());
+  size_t o = out.size();
+  out.resize(o + 3 * ((n + 3) / 4));
+  uint8_t* res = out.data() + o;
+
+  for (size_t i = 0; i < n; i += 4, res += 3) {
     uint8_t quad[4] = {0}; /* a quad of 6 bits */
-    for (size_t j = 0; j < 4 && i + j < inp.size(); ++j) {
-      size_t ind = valid.find(inp[i + j]);
-      if (ind == std::string::npos) {
-        return false;
-      }
-      quad[j] = (uint8_t)ind;
+    uint8_t bad = 0;
+    for (size_t j = 0; j < 4 && i + j < n; ++j) {
+      quad[j] = kSextet.v[in[i + j]];
+      bad |= quad[j];
+    }
+    if (bad == kInvalid) {
+      out.resize(o);
+      return false;
     }
-    uint8_t res[3] = {0};
     res[0] = quad[0] << 2 | quad[1] >> 4;
     res[1] = quad[1] << 4 | quad[2] >> 2;
     res[2] = quad[2] << 6 | quad[3];
-    out.insert(out.end(), res, res + 3);
   }
   return true;
 }
@@ -22,7 +22,7 @@
 
 namespace proofs {
 
-bool base64_decode_url(std::string inp, std::vector<uint8_t>& out);
+bool base64_decode_url(const std::string& inp, std::vector<uint8_t>& out);
 
 }  // namespace proofs
 
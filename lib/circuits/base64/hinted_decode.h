@@ -0,0 +1,192 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "circuits/base64/hinted_decode_constants.h"
+#include "circuits/logic/counter.h"
+#include "util/ceildiv.h"
+#include "util/panic.h"
+
+namespace proofs {
+
+// An alternative to Base64Decoder in which the prover supplies the
+// decoded sextet of each character, and the circuit checks it instead of
+// computing it with the espresso-minimized function.
+//
+// The alphabet consists of five classes of consecutive characters that
+// map to consecutive sextets (A-Z, a-z, 0-9, -, _).  Besides the sextet
+// S, the prover supplies the class T of the character C in binary, and
+// the offset R of C within the class.  The circuit checks
+//
+//    C = base[T] + R,   S = sextet_base[T] + R,
+//    R2 = R + (32 - class_size[T]),
+//
+// where R and R2 are 5-bit witnesses, which bounds R to the class.
+// The equations are over counters (see counter.h), which are linear
+// in fields of large characteristic and cost one multiplication per bit
+// in fields of characteristic two.
+template <class LogicCircuit>
+class Base64HintedDecoder {
+  using Field = typename LogicCircuit::Field;
+  using EltW = typename LogicCircuit::EltW;
+  using BitW = typename LogicCircuit::BitW;
+  using v8 = typename LogicCircuit::v8;
+  using v6 = typename LogicCircuit::template bitvec<6>;
+  using v5 = typename LogicCircuit::template bitvec<5>;
+  using v3 = typename LogicCircuit::template bitvec<3>;
+  using CounterL = Counter<LogicCircuit>;
+  using CEltW = typename CounterL::CEltW;
+
+ public:
+  // Per-character witness.
+  struct Hint {
+    v6 s;
+    v3 cls;
+    v5 r, r2;
+
+    void input(const LogicCircuit& lc) {
+      s = lc.template vinput<6>();
+      cls = lc.template vinput<3>();
+      r = lc.template vinput<5>();
+      r2 = lc.template vinput<5>();
+    }
+  };
+
+  explicit Base64HintedDecoder(const LogicCircuit& lc) : lc_(lc) {}
+
+  void base64_rawurl_decode(const v8 inputs[/*n*/], const Hint hints[/*n*/],
+                            v8 output[/* ceil(n*6/8) */], size_t n) const {
+    check(n < (1 << 28), "input too large");  // avoid overflows
+    const BitW one = lc_.bit(1);
+    size_t max = ceildiv<size_t>(n * 6, 8);
+    size_t oc = 0;
+
+    for (size_t i = 0; i < n; i += 4, oc += 3) {
+      v6 quad[4] = {};
+      for (size_t j = 0; j < 4; ++j) {
+        if (i + j < n) {
+          decode(inputs[i + j], hints[i + j], quad[j], one);
+        } else {
+          quad[j] = lc_.template vbit<6>(0);
+        }
+      }
+      repack(quad, output, oc, max);
+    }
+  }
+
+  // As base64_rawurl_decode(), but characters at positions >= LEN are
+  // unconstrained and decode to zero.
+  template <size_t N>
+  void base64_rawurl_decode_len(
+      const v8 inputs[/*n*/], const Hint hints[/*n*/],
+      v8 output[/* ceil(n*6/8) */], size_t n,
+      typename LogicCircuit::template bitvec<N>& len) const {
+    check(n < (1 << 28), "input too large");  // avoid overflows
+    size_t max = ceildiv<size_t>(n * 6, 8);
+    size_t oc = 0;
+
+    for (size_t i = 0; i < n; i += 4, oc += 3) {
+      v6 quad[4] = {};
+      for (size_t j = 0; j < 4; ++j) {
+        if (i + j < n) {
+          auto range = lc_.vlt(i + j, len);
+          decode(inputs[i + j], hints[i + j], quad[j], range);
+        } else {
+          quad[j] = lc_.template vbit<6>(0);
+        }
+      }
+      repack(quad, output, oc, max);
+    }
+  }
+
+  // Assert that OUT = H.s is the sextet of IN if VALID, and zero otherwise.
+  void decode(const v8& in, const Hint& h, v6& out, const BitW& valid) const {
+    const LogicCircuit& L = lc_;  // shorthand
+    const CounterL C(L);
+    L.vassert_is_bit(h.s);
+    L.vassert_is_bit(h.cls);
+    L.vassert_is_bit(h.r);
+    L.vassert_is_bit(h.r2);
+
+    // The indicators of a binary value are mutually exclusive, so
+    // their sum is 1 iff cls < kBase64NumClasses.
+    BitW ind[8];
+    onehot3(&h.cls[0], ind);
+    EltW nind = L.konst(0);
+    for (size_t t = 0; t < kBase64NumClasses; ++t) {
+      nind = L.add(&nind, L.eval(ind[t]));
+    }
+    L.assert_eq(&nind, L.eval(valid));
+
+    // Characters that are not decoded select the zero counter, and
+    // compare against the zero counter.
+    const BitW nv = L.lnot(valid);
+    const CEltW zero = C.as_counter(0);
+    auto select = [&](const uint8_t k[/*kBase64NumClasses*/]) {
+      EltW e = L.lmul(&nv, zero.e);
+      for (size_t t = 0; t < kBase64NumClasses; ++t) {
+        e = L.add(&e, L.lmul(&ind[t], C.as_counter(k[t]).e));
+      }
+      return CEltW{e};
+    };
+    uint8_t gap[kBase64NumClasses];
+    for (size_t t = 0; t < kBase64NumClasses; ++t) {
+      gap[t] = 32 - kBase64ClassSize[t];
+    }
+
+    const CEltW c = C.as_counter(in);
+    const CEltW vc = C.mux(&valid, &c, zero);
+    const CEltW r = C.as_counter(h.r);
+    const CEltW want_c = C.add(&r, select(kBase64ClassBase));
+    const CEltW want_s = C.add(&r, select(kBase64ClassSextet));
+    const CEltW want_r2 = C.add(&r, select(gap));
+    C.assert_eq(&want_c, vc);
+    C.assert_eq(&want_s, C.as_counter(h.s));
+    C.assert_eq(&want_r2, C.as_counter(h.r2));
+    out = h.s;
+  }
+
+ private:
+  const LogicCircuit& lc_;
+
+  void repack(const v6 quad[4], v8 output[], size_t oc, size_t max) const {
+    for (size_t j = 0; j < 24 && (oc + j / 8) < max; ++j) {
+      output[oc + j / 8][7 - (j % 8)] = quad[j / 6][5 - (j % 6)];
+    }
+  }
+
+  // OUT[i] = (b[0..2] == i)
+  void onehot3(const BitW b[3], BitW out[8]) const {
+    const LogicCircuit& L = lc_;  // shorthand
+    BitW nb[3];
+    for (size_t i = 0; i < 3; ++i) {
+      nb[i] = L.lnot(b[i]);
+    }
+    BitW p[4];
+    for (size_t i = 0; i < 4; ++i) {
+      p[i] = L.land((i & 1) ? &b[0] : &nb[0], (i & 2) ? b[1] : nb[1]);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      out[i] = L.land(&p[i & 3], (i & 4) ? b[2] : nb[2]);
+    }
+  }
+};
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_H_
@@ -0,0 +1,38 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_CONSTANTS_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_CONSTANTS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace proofs {
+
+static constexpr char kBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// The base64url alphabet as five classes of consecutive characters that
+// map to consecutive sextets.
+static constexpr size_t kBase64NumClasses = 5;
+static constexpr uint8_t kBase64ClassBase[kBase64NumClasses] = {'A', 'a', '0',
+                                                                '-', '_'};
+static constexpr uint8_t kBase64ClassSextet[kBase64NumClasses] = {0, 26, 52,
+                                                                  62, 63};
+static constexpr uint8_t kBase64ClassSize[kBase64NumClasses] = {26, 26, 10, 1,
+                                                                1};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_CONSTANTS_H_
@@ -0,0 +1,171 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "circuits/base64/hinted_decode.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "circuits/base64/decode.h"
+#include "circuits/base64/hinted_decode_constants.h"
+#include "circuits/base64/hinted_decode_witness.h"
+#include "circuits/compiler/circuit_dump.h"
+#include "circuits/compiler/compiler.h"
+#include "circuits/logic/compiler_backend.h"
+#include "circuits/logic/evaluation_backend.h"
+#include "circuits/logic/logic.h"
+#include "ec/p256.h"
+#include "gf2k/gf2_128.h"
+#include "util/log.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+template <class Logic>
+typename Base64HintedDecoder<Logic>::Hint mkhint(const Logic& L,
+                                                 const Base64Hint& h) {
+  typename Base64HintedDecoder<Logic>::Hint r;
+  r.s = L.template vbit<6>(h.s);
+  r.cls = L.template vbit<3>(h.cls);
+  r.r = L.template vbit<5>(h.r);
+  r.r2 = L.template vbit<5>(h.r2);
+  return r;
+}
+
+template <class Field>
+void test_each_symbol(const Field& F) {
+  using EvaluationBackend = EvaluationBackend<Field>;
+  using Logic = Logic<Field, EvaluationBackend>;
+  using v6 = typename Logic::template bitvec<6>;
+  const EvaluationBackend ebk(F, false);
+  const Logic L(&ebk, F);
+  const Base64HintedDecoder<Logic> bd(L);
+  const auto valid = L.bit(1);
+
+  for (size_t c = 0; c < 256; ++c) {
+    auto in = L.template vbit<8>(c);
+    const char* p = strchr(kBase64Alphabet, static_cast<int>(c));
+    Base64Hint h;
+    bool ok = base64_hint(c, true, h);
+    EXPECT_EQ(ok, c != 0 && p != nullptr);
+    v6 out;
+    if (ok) {
+      bd.decode(in, mkhint(L, h), out, valid);
+      EXPECT_FALSE(ebk.assertion_failed());
+      EXPECT_TRUE(L.vequal(&out, L.template vbit<6>(p - kBase64Alphabet)));
+    }
+
+    // The honest hint of any other symbol must be rejected.
+    for (size_t x = 0; x < 64; ++x) {
+      uint8_t other = kBase64Alphabet[x];
+      if (other != c) {
+        EXPECT_TRUE(base64_hint(other, true, h));
+        bd.decode(in, mkhint(L, h), out, valid);
+        EXPECT_TRUE(ebk.assertion_failed());
+      }
+    }
+
+    // Characters that are not decoded must decode to zero.
+    EXPECT_TRUE(base64_hint(c, false, h));
+    bd.decode(in, mkhint(L, h), out, L.bit(0));
+    EXPECT_FALSE(ebk.assertion_failed());
+    EXPECT_TRUE(L.vequal(&out, L.template vbit<6>(0)));
+    EXPECT_TRUE(base64_hint('B', true, h));
+    bd.decode(in, mkhint(L, h), out, L.bit(0));
+    EXPECT_TRUE(ebk.assertion_failed());
+  }
+}
+
+TEST(Base64Hinted, DecodeSymbolPrimeField) { test_each_symbol(p256_base); }
+TEST(Base64Hinted, DecodeSymbolBinaryField) { test_each_symbol(GF2_128<>()); }
+
+TEST(Base64Hinted, DecodeLen) {
+  using EvaluationBackend = EvaluationBackend<Fp256Base>;
+  using Logic = Logic<Fp256Base, EvaluationBackend>;
+  using v8 = Logic::v8;
+  const EvaluationBackend ebk(p256_base, false);
+  const Logic L(&ebk, p256_base);
+  const Base64HintedDecoder<Logic> bd(L);
+
+  // "{\"g\":1}" followed by junk that is not decoded
+  const char b64[] = "eyJnIjoxfQ!!*!";
+  const char want[] = "{\"g\":1}";
+  constexpr size_t n = sizeof(b64) - 1, len = 10;
+  std::vector<v8> in(n), got(n);
+  std::vector<Base64HintedDecoder<Logic>::Hint> hints(n);
+  for (size_t i = 0; i < n; ++i) {
+    in[i] = L.vbit<8>(b64[i]);
+    Base64Hint h;
+    EXPECT_TRUE(base64_hint(b64[i], i < len, h));
+    hints[i] = mkhint(L, h);
+  }
+  auto vlen = L.vbit<8>(len);
+  bd.base64_rawurl_decode_len(in.data(), hints.data(), got.data(), n, vlen);
+  EXPECT_FALSE(ebk.assertion_failed());
+  for (size_t i = 0; i < 7; ++i) {
+    EXPECT_TRUE(L.vequal(&got[i], L.vbit<8>(want[i])));
+  }
+}
+
+// Compare the two decoders at the sizes of the JWT payloads, i.e.,
+// 64 * (kMaxSHABlocks - 2) characters.
+template <class Field>
+void decoder_size(const Field& F, const char* name, size_t n, bool hinted) {
+  using CompilerBackend = CompilerBackend<Field>;
+  using LogicCircuit = Logic<Field, CompilerBackend>;
+  using v8 = typename LogicCircuit::v8;
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+
+  std::vector<v8> in(n), out(n);
+  for (size_t i = 0; i < n; ++i) {
+    in[i] = LC.template vinput<8>();
+  }
+  auto len = LC.template vinput<12>();
+  if (hinted) {
+    const Base64HintedDecoder<LogicCircuit> bd(LC);
+    std::vector<typename Base64HintedDecoder<LogicCircuit>::Hint> hints(n);
+    for (auto& h : hints) {
+      h.input(LC);
+    }
+    bd.base64_rawurl_decode_len(in.data(), hints.data(), out.data(), n, len);
+  } else {
+    const Base64Decoder<LogicCircuit> bd(LC);
+    bd.base64_rawurl_decode_len(in.data(), out.data(), n, len);
+  }
+  for (size_t i = 0; i < n * 6 / 8; ++i) {
+    LC.voutput(out[i], 8 * i);
+  }
+  auto CIRCUIT = Q.mkcircuit(/*nc=*/1);
+  dump_info(name, n, Q);
+}
+
+TEST(Base64Hinted, CircuitSize) {
+  set_log_level(INFO);
+  for (size_t blocks : {7, 11, 15, 34}) {
+    size_t n = 64 * (blocks - 2);
+    decoder_size(p256_base, "espresso_p256", n, false);
+    decoder_size(p256_base, "hinted_p256", n, true);
+  }
+  const GF2_128<> F2;
+  decoder_size(F2, "espresso_gf2_128", 64 * 13, false);
+  decoder_size(F2, "hinted_gf2_128", 64 * 13, true);
+}
+
+}  // namespace
+}  // namespace proofs
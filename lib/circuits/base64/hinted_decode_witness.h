@@ -0,0 +1,70 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_WITNESS_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_WITNESS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arrays/dense.h"
+#include "circuits/base64/hinted_decode_constants.h"
+
+namespace proofs {
+
+// The witness of Base64HintedDecoder for one character.  CLS is the
+// class index, or kBase64NumClasses for characters that are not decoded.
+struct Base64Hint {
+  uint8_t s, cls, r, r2;
+};
+
+// Compute the hint for character C.  Characters with VALID = false
+// decode to zero.  Returns false if VALID and C is not a base64url
+// character.
+inline bool base64_hint(uint8_t c, bool valid, Base64Hint& h) {
+  h = Base64Hint{0, kBase64NumClasses, 0, 0};
+  if (!valid) {
+    return true;
+  }
+  for (size_t t = 0; t < kBase64NumClasses; ++t) {
+    if (c >= kBase64ClassBase[t] &&
+        c < kBase64ClassBase[t] + kBase64ClassSize[t]) {
+      h.cls = t;
+      h.r = c - kBase64ClassBase[t];
+      h.r2 = h.r + 32 - kBase64ClassSize[t];
+      h.s = kBase64ClassSextet[t] + h.r;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Fill H in the order of Base64HintedDecoder::Hint::input().
+template <class Field>
+void fill_base64_hint(DenseFiller<Field>& filler, const Base64Hint& h,
+                      const Field& F) {
+  auto push_bits = [&](size_t n, uint64_t x) {
+    for (size_t i = 0; i < n; ++i) {
+      filler.push_back(((x >> i) & 1) ? F.one() : F.zero());
+    }
+  };
+  push_bits(6, h.s);
+  push_bits(3, h.cls);
+  push_bits(5, h.r);
+  push_bits(5, h.r2);
+}
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_BASE64_HINTED_DECODE_WITNESS_H_
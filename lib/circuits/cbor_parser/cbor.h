@@ -19,6 +19,8 @@
 #include <stdint.h>
 
 #include <array>
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include "circuits/cbor_parser/cbor_byte_decoder.h"
@@ -61,6 +63,13 @@ class Cbor {
     EltW encoded_sel_header;
   };
 
+  // An index J into the input, together with its one-hot decoding
+  // SEL[i] = (J == i) for 0 <= i < N.  See decode_index().
+  struct decoded_index {
+    vindex j;
+    std::vector<BitW> sel;
+  };
+
   //------------------------------------------------------------
   // Decoder (lexer)
   //------------------------------------------------------------
@@ -309,10 +318,36 @@ class Cbor {
     L.assert_eq(&want_one, one);
   }
 
+  //------------------------------------------------------------
+  // Index decoder
+  //------------------------------------------------------------
+  // The assertions below look up the input at a witnessed index J.
+  // Testing veq(J, i) independently at every position i costs
+  // O(N log N) per lookup before CSE.  Instead, decode_index()
+  // computes all the SEL[i] at once, by decoding the low and high
+  // halves of J recursively and taking the outer product of the two
+  // decodings, restricted to positions < N.  This costs about N
+  // multiplications at depth log(kIndexBits).  The lookups take a
+  // decoded_index, so that callers decode each index once and share
+  // the decoding among all the lookups at that index.
+  decoded_index decode_index(size_t n, const vindex& j) const {
+    proofs::check(n > 0 && n <= (size_t(1) << kIndexBits),
+                  "n out of range for kIndexBits");
+    l_.vassert_is_bit(j);
+    return decoded_index{j, decode_bits(j, 0, kIndexBits, n)};
+  }
+
+  // Return A(J), or 0 if J >= N.
+  EltW select(size_t n, const decoded_index& J,
+              const std::function<EltW(size_t)>& A) const {
+    const Logic& L = l_;  // shorthand
+    return L.add(0, n, [&](size_t i) { return L.lmul(&J.sel[i], A(i)); });
+  }
+
   //------------------------------------------------------------
   // "J is the header of a string of length LEN containing BYTES"
   //------------------------------------------------------------
-  void assert_text_at(size_t n, const vindex& j, size_t len,
+  void assert_text_at(size_t n, const decoded_index& J, size_t len,
                       const uint8_t bytes[/*len*/],
                       const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
@@ -321,7 +356,7 @@ class Cbor {
     // we don't handle long strings
     proofs::check(len < 24, "len < 24");
 
-    assert_header(n, j, ds);
+    assert_header(n, J, ds);
 
     std::vector<EltW> A(n);
     for (size_t i = 0; i < n; ++i) {
@@ -331,7 +366,7 @@ class Cbor {
     // shift len+1 bytes, including the header.
     std::vector<EltW> B(len + 1);
     const EltW defaultA = L.konst(256);  // a constant that cannot appear in A[]
-    R.shift(j, len + 1, B.data(), n, A.data(), defaultA, /*unroll=*/3);
+    R.shift(J.j, len + 1, B.data(), n, A.data(), defaultA, /*unroll=*/3);
 
     size_t expected_header = (3 << 5) + len;
     L.assert_eq(&B[0], L.konst(expected_header));
@@ -344,44 +379,44 @@ class Cbor {
   //------------------------------------------------------------
   // "J is a header containing unsigned U."
   //------------------------------------------------------------
-  void assert_unsigned_at(size_t n, const vindex& j, uint64_t u,
+  void assert_unsigned_at(size_t n, const decoded_index& J, uint64_t u,
                           const decode ds[/*n*/]) const {
     // only small u for now
     proofs::check(u < 24, "u < 24");
 
     size_t expected = (0 << 5) + u;
-    assert_atom_at(n, j, l_.konst(expected), ds);
+    assert_atom_at(n, J, l_.konst(expected), ds);
   }
 
   //------------------------------------------------------------
   // "J is a header containing negative U."  (U >= 0, and
   // CBOR distinguishes 0 from -0 apparently)
   //------------------------------------------------------------
-  void assert_negative_at(size_t n, const vindex& j, uint64_t u,
+  void assert_negative_at(size_t n, const decoded_index& J, uint64_t u,
                           const decode ds[/*n*/]) const {
     // only small u for now
     proofs::check(u < 24, "u < 24");
 
     size_t expected = (1 << 5) + u;
-    assert_atom_at(n, j, l_.konst(expected), ds);
+    assert_atom_at(n, J, l_.konst(expected), ds);
   }
 
   //------------------------------------------------------------
   // "J is a header containing a boolean primitive (0xF4 or 0xF5)."
   //
   //------------------------------------------------------------
-  void assert_bool_at(size_t n, const vindex& j, bool val,
+  void assert_bool_at(size_t n, const decoded_index& J, bool val,
                       const decode ds[/*n*/]) const {
     size_t expected = (7 << 5) + (val ? 21 : 20);
-    assert_atom_at(n, j, l_.konst(expected), ds);
+    assert_atom_at(n, J, l_.konst(expected), ds);
   }
 
   // Helps assemble the checks for date assertions.
-  void date_helper(size_t n, const vindex& j, const decode ds[/*n*/],
+  void date_helper(size_t n, const decoded_index& J, const decode ds[/*n*/],
                    std::vector<v8>& B /* size 22 */) const {
     const Logic& L = l_;  // shorthand
     const Routing<Logic> R(L);
-    assert_header(n, j, ds);
+    assert_header(n, J, ds);
 
     std::vector<v8> A(n);
     for (size_t i = 0; i < n; ++i) {
@@ -390,7 +425,7 @@ class Cbor {
 
     const v8 defaultA =
         L.template vbit<8>(0);  // a constant that cannot appear in A[]
-    R.shift(j, 20 + 2, B.data(), n, A.data(), defaultA, /*unroll=*/3);
+    R.shift(J.j, 20 + 2, B.data(), n, A.data(), defaultA, /*unroll=*/3);
 
     // Check for tag: date/time string.
     L.vassert_eq(&B[0], L.template vbit<8>(0xc0));
@@ -403,12 +438,13 @@ class Cbor {
   // "J is a header containing date d < now."  now is 20 bytes
   // in the format 2023-11-01T09:00:00Z
   //------------------------------------------------------------
-  void assert_date_before_at(size_t n, const vindex& j, const v8 now[/* 20 */],
+  void assert_date_before_at(size_t n, const decoded_index& J,
+                             const v8 now[/* 20 */],
                              const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
     const Memcmp<Logic> CMP(L);
     std::vector<v8> B(20 + 2);
-    date_helper(n, j, ds, B);
+    date_helper(n, J, ds, B);
     auto lt = CMP.lt(20, &B[2], now);
     L.assert1(lt);
   }
@@ -417,12 +453,13 @@ class Cbor {
   // "J is a header containing date d > now."  now is 20 bytes in the
   // format 2023-11-01T09:00:00Z
   // ------------------------------------------------------------
-  void assert_date_after_at(size_t n, const vindex& j, const v8 now[/* 20 */],
+  void assert_date_after_at(size_t n, const decoded_index& J,
+                            const v8 now[/* 20 */],
                             const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
     const Memcmp<Logic> CMP(L);
     std::vector<v8> B(20 + 2);
-    date_helper(n, j, ds, B);
+    date_helper(n, J, ds, B);
     auto lt = CMP.lt(20, now, &B[2]);
     L.assert1(lt);
   }
@@ -431,51 +468,39 @@ class Cbor {
   // "J is a header containing represented by the byte EXPECTED in the
   // input."
   //------------------------------------------------------------
-  void assert_atom_at(size_t n, const vindex& j, const EltW& expected,
+  void assert_atom_at(size_t n, const decoded_index& J, const EltW& expected,
                       const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
-    const Routing<Logic> R(L);
 
-    assert_header(n, j, ds);
+    assert_header(n, J, ds);
 
-    std::vector<EltW> A(n);
-    for (size_t i = 0; i < n; ++i) {
-      A[i] = ds[i].bd.as_scalar;
-    }
-
-    EltW B[1];
-    size_t unroll = 3;
-    R.shift(j, 1, B, n, A.data(), L.konst(256), unroll);
-    L.assert_eq(&B[0], expected);
+    EltW B = select(n, J, [&](size_t i) { return ds[i].bd.as_scalar; });
+    L.assert_eq(&B, expected);
   }
 
   //------------------------------------------------------------
   // "Position j contains a header"
   //------------------------------------------------------------
-  void assert_header(size_t n, const vindex& j, const decode ds[/*n*/]) const {
+  void assert_header(size_t n, const decoded_index& J,
+                     const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
 
-    L.vassert_is_bit(j);
-
-    // giant dot product since the veq(j, .) terms are mutually exclusive.
-    auto f = [&](size_t i) { return L.land(&ds[i].header, L.veq(j, i)); };
+    // giant dot product since the J.sel[] are mutually exclusive.
+    auto f = [&](size_t i) { return L.land(&ds[i].header, J.sel[i]); };
     L.assert1(L.lor_exclusive(0, n, f));
   }
 
   //------------------------------------------------------------
   // "A map starts at position j"
   //------------------------------------------------------------
-  void assert_map_header(size_t n, const vindex& j,
+  void assert_map_header(size_t n, const decoded_index& J,
                          const decode ds[/*n*/]) const {
     const Logic& L = l_;  // shorthand
 
-    L.vassert_is_bit(j);
-
-    // giant dot product since the veq(j, .) terms are mutually exclusive.
+    // giant dot product since the J.sel[] are mutually exclusive.
     auto f = [&](size_t i) {
-      auto eq_ji = L.veq(j, i);
       auto dsi = L.land(&ds[i].bd.mapp, ds[i].header);
-      return L.land(&eq_ji, dsi);
+      return L.land(&J.sel[i], dsi);
     };
     L.assert1(L.lor_exclusive(0, n, f));
   }
@@ -484,16 +509,16 @@ class Cbor {
   // "Position M starts a map of level LEVEL.  (K, V) are headers
   // representing the J-th pair in that map"
   //------------------------------------------------------------
-  void assert_map_entry(size_t n, const vindex& m, size_t level,
-                        const vindex& k, const vindex& v, const vindex& j,
-                        const decode ds[/*n*/],
+  void assert_map_entry(size_t n, const decoded_index& M, size_t level,
+                        const decoded_index& K, const decoded_index& V,
+                        const vindex& j, const decode ds[/*n*/],
                         const parse_output ps[/*n*/]) const {
     const Logic& L = l_;  // shorthand
     const Routing<Logic> R(L);
 
-    assert_map_header(n, m, ds);
-    assert_header(n, k, ds);
-    assert_header(n, v, ds);
+    assert_map_header(n, M, ds);
+    assert_header(n, K, ds);
+    assert_header(n, V, ds);
 
     for (size_t l = 0; l < kNCounters; ++l) {
       // Hack: temporarily treat CEltW as EltW so as to reuse
@@ -503,13 +528,16 @@ class Cbor {
         A[i] = ps[i].c[l].e;
       }
 
-      // Select counters[m], counters[k], and counters[v].
+      // Select counters[m], counters[k], and counters[v].  The
+      // counters are only available deep in the circuit, and a dot
+      // product with the SEL[] bits would keep all N of them alive
+      // until then, which costs more wires than the shifter.
       CEltW cm, ck, cv;
 
       const size_t unroll = 3;
-      R.shift(m, 1, &cm.e, n, A.data(), L.konst(0), unroll);
-      R.shift(k, 1, &ck.e, n, A.data(), L.konst(0), unroll);
-      R.shift(v, 1, &cv.e, n, A.data(), L.konst(0), unroll);
+      R.shift(M.j, 1, &cm.e, n, A.data(), L.konst(0), unroll);
+      R.shift(K.j, 1, &ck.e, n, A.data(), L.konst(0), unroll);
+      R.shift(V.j, 1, &cv.e, n, A.data(), L.konst(0), unroll);
 
       if (l <= level) {
         // Counters[L] must agree at the key, value, and root
@@ -584,6 +612,32 @@ class Cbor {
   }
 
  private:
+  // Return the first M entries of the one-hot decoding of bits
+  // [B0, B1) of J.
+  std::vector<BitW> decode_bits(const vindex& j, size_t b0, size_t b1,
+                                size_t m) const {
+    const Logic& L = l_;  // shorthand
+    std::vector<BitW> sel(m);
+    if (b1 == b0 + 1) {
+      sel[0] = L.lnot(j[b0]);
+      if (m > 1) {
+        sel[1] = j[b0];
+      }
+    } else {
+      size_t bm = b0 + (b1 - b0) / 2;
+      size_t lo_bits = bm - b0;
+      size_t lo_size = size_t(1) << lo_bits;
+      std::vector<BitW> lo =
+          decode_bits(j, b0, bm, (m < lo_size) ? m : lo_size);
+      std::vector<BitW> hi =
+          decode_bits(j, bm, b1, ((m - 1) >> lo_bits) + 1);
+      for (size_t i = 0; i < m; ++i) {
+        sel[i] = L.land(&hi[i >> lo_bits], lo[i & (lo_size - 1)]);
+      }
+    }
+    return sel;
+  }
+
   const Logic& l_;
   const CounterL ctr_;
   const CborBD bd_;
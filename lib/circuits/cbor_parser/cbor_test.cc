@@ -126,6 +126,25 @@ TEST(CBOR, VerifyDecode) {
   CBOR.decode_and_assert_decode(n, ds.data(), in.data(), pw.data(), gw);
 }
 
+TEST(CBOR, DecodeIndex) {
+  const EvalBackend ebk(F);
+  const Logic L(&ebk, F);
+  using Cbor = Cbor<Logic, 6>;
+  const Cbor CBOR(L);
+
+  for (size_t n : {1, 2, 5, 32, 33, 47, 64}) {
+    for (size_t j = 0; j < 64; ++j) {
+      auto J = CBOR.decode_index(n, L.vbit<6>(j));
+      ASSERT_EQ(J.sel.size(), n);
+      for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(L.eval(J.sel[i]).elt(), (i == j) ? F.one() : F.zero());
+      }
+      auto aj = CBOR.select(n, J, [&](size_t i) { return L.konst(i + 7); });
+      EXPECT_EQ(aj.elt(), (j < n) ? F.of_scalar(j + 7) : F.zero());
+    }
+  }
+}
+
 TEST(CBOR, VerifyParseSize) {
   set_log_level(INFO);
 
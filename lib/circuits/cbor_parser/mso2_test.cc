@@ -345,9 +345,10 @@ TEST(MSO, Various) {
       'd', 'i', 'g', 'e', 's', 't', 'A', 'l', 'g', 'o', 'r', 'i', 't', 'h', 'm',
   };
 
-  CBOR.assert_header(n, CT.index(13), ds.data());
-  CBOR.assert_text_at(n, CT.index(13), 15, bytes, ds.data());
-  CBOR.assert_map_header(n, CT.index(80), ds.data());
+  auto j13 = CBOR.decode_index(n, CT.index(13));
+  CBOR.assert_header(n, j13, ds.data());
+  CBOR.assert_text_at(n, j13, 15, bytes, ds.data());
+  CBOR.assert_map_header(n, CBOR.decode_index(n, CT.index(80)), ds.data());
 }
 
 static const uint8_t svalueDigests[12] = {
@@ -435,17 +436,17 @@ TEST(MSO, MapLookup) {
   // "Position JROOT starts a map of level 0.  (JVDK, JVDV) are headers
   // representing the VDNDX-th pair in that map.  The key at JVDK is
   // correct."
-  auto jvdk = CT.index(vd[0].header_pos_);
-  auto jvdv = CT.index(vd[1].header_pos_);
-  CBOR.assert_map_entry(n, jroot, 0, jvdk, jvdv, CT.index(vdndx), ds.data(),
-                        ps.data());
+  auto jvdk = CBOR.decode_index(n, CT.index(vd[0].header_pos_));
+  auto jvdv = CBOR.decode_index(n, CT.index(vd[1].header_pos_));
+  CBOR.assert_map_entry(n, CBOR.decode_index(n, jroot), 0, jvdk, jvdv,
+                        CT.index(vdndx), ds.data(), ps.data());
   CBOR.assert_text_at(n, jvdk, sizeof(svalueDigests), svalueDigests, ds.data());
 
   // "Position JVDV starts a map of level 1.
   // (JORGK, JORGV) are headers representing the ORGNDX-th pair in
   // that map. The key at JORGK is correct."
-  auto jorgk = CT.index(org[0].header_pos_);
-  auto jorgv = CT.index(org[1].header_pos_);
+  auto jorgk = CBOR.decode_index(n, CT.index(org[0].header_pos_));
+  auto jorgv = CBOR.decode_index(n, CT.index(org[1].header_pos_));
   CBOR.assert_map_entry(n, jvdv, 1, jorgk, jorgv, CT.index(orgndx), ds.data(),
                         ps.data());
   CBOR.assert_text_at(n, jorgk, sizeof(sorgBlahBlahBlah), sorgBlahBlahBlah,
@@ -454,8 +455,8 @@ TEST(MSO, MapLookup) {
   // Position JORGV starts a map of level 2.
   // (JHASHK, JHASHV) are headers representing the HASHNDX-th pair in
   // that map. The key at JHASHK is correct."
-  auto jhashk = CT.index(hash[0].header_pos_);
-  auto jhashv = CT.index(hash[1].header_pos_);
+  auto jhashk = CBOR.decode_index(n, CT.index(hash[0].header_pos_));
+  auto jhashv = CBOR.decode_index(n, CT.index(hash[1].header_pos_));
   CBOR.assert_map_entry(n, jorgv, 2, jhashk, jhashv, CT.index(hashndx),
                         ds.data(), ps.data());
   CBOR.assert_unsigned_at(n, jhashk, org_lookup_tag, ds.data());
@@ -533,12 +534,12 @@ TEST(MSO, Example2Real) {
     // "Position JROOT starts a map of level 0.  (JVDK, JVDV) are headers
     // representing the VDNDX-th pair in that map.  The key at JVDK is
     // correct."
-    auto jvdkC = LC.vinput<CborC::kIndexBits>();
-    auto jvdvC = LC.vinput<CborC::kIndexBits>();
+    auto jvdkC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
+    auto jvdvC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
     auto vdndxC = LC.vinput<CborC::kIndexBits>();
 
-    CBORC.assert_map_entry(n, jrootC, 0, jvdkC, jvdvC, vdndxC, dsC.data(),
-                           psC.data());
+    CBORC.assert_map_entry(n, CBORC.decode_index(n, jrootC), 0, jvdkC, jvdvC,
+                           vdndxC, dsC.data(), psC.data());
 
     CBORC.assert_text_at(n, jvdkC, sizeof(svalueDigests), svalueDigests,
                          dsC.data());
@@ -546,8 +547,8 @@ TEST(MSO, Example2Real) {
     // "Position JVDV starts a map of level 1.
     // (JORGK, JORGV) are headers representing the ORGNDX-th pair in
     // that map. The key at JORGK is correct."
-    auto jorgkC = LC.vinput<CborC::kIndexBits>();
-    auto jorgvC = LC.vinput<CborC::kIndexBits>();
+    auto jorgkC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
+    auto jorgvC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
     auto orgndxC = LC.vinput<CborC::kIndexBits>();
 
     CBORC.assert_map_entry(n, jvdvC, 1, jorgkC, jorgvC, orgndxC, dsC.data(),
@@ -559,8 +560,8 @@ TEST(MSO, Example2Real) {
     // Position JORGV starts a map of level 2.
     // (JHASHK, JHASHV) are headers representing the HASHNDX-th pair in
     // that map. The key at JHASHK is correct."
-    auto jhashkC = LC.vinput<CborC::kIndexBits>();
-    auto jhashvC = LC.vinput<CborC::kIndexBits>();
+    auto jhashkC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
+    auto jhashvC = CBORC.decode_index(n, LC.vinput<CborC::kIndexBits>());
     auto hashndxC = LC.vinput<CborC::kIndexBits>();
 
     CBORC.assert_map_entry(n, jorgvC, 2, jhashkC, jhashvC, hashndxC, dsC.data(),
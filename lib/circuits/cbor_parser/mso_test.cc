@@ -466,19 +466,19 @@ TEST(MSO, Example) {
 
   // assert a map entry with a 1 byte index
   CBOR.assert_map_entry(n,
-                        CT.index(1886),  // devKey.v,
+                        CBOR.decode_index(n, CT.index(1886)),  // devKey.v,
                         2,
-                        CT.index(1926),  // devKeyPky.k,
-                        CT.index(1927),  // devKeyPky.v,
-                        CT.index(3),     // devKeyPky.ndx,
+                        CBOR.decode_index(n, CT.index(1926)),  // devKeyPky.k,
+                        CBOR.decode_index(n, CT.index(1927)),  // devKeyPky.v,
+                        CT.index(3),  // devKeyPky.ndx,
                         ds.data(), ps.data());
 
   // assert a map entry with a 2-byte index
-  CBOR.assert_map_entry(n, CT.index(69),  // org.v,
+  CBOR.assert_map_entry(n, CBOR.decode_index(n, CT.index(69)),  // org.v,
                         2,
-                        CT.index(246),  // k pos for entry 5
-                        CT.index(247),  // v pos for entry 5
-                        CT.index(5),    // index = 5
+                        CBOR.decode_index(n, CT.index(246)),  // k pos, entry 5
+                        CBOR.decode_index(n, CT.index(247)),  // v pos, entry 5
+                        CT.index(5),  // index = 5
                         ds.data(), ps.data());
 }
 }  // namespace
@@ -0,0 +1,337 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_CIRCUIT_OPTIMIZER_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_CIRCUIT_OPTIMIZER_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "sumcheck/circuit.h"
+#include "sumcheck/circuit_id.h"
+#include "sumcheck/quad.h"
+#include "util/ceildiv.h"
+#include "util/panic.h"
+
+namespace proofs {
+/*
+Post-scheduling optimizer that operates on a finished Circuit.
+
+QuadCircuit already performs constant propagation on the dag, but it
+cannot know the value of input wires.  Given a set of input wires whose
+values are known at compile time (wire 0 is always the constant one),
+this optimizer
+
+  1. propagates known values from the inputs towards the outputs,
+     one layer at a time;
+  2. folds corners with known hands into their coefficient, rewriting
+     each known hand as a nonzero known "anchor" wire of the same layer
+     (usually the copy of the constant one), and drops corners
+     multiplied by a known zero;
+  3. removes gates whose outputs are not consumed by the next layer
+     and that carry no assertions, renumbering the surviving wires and
+     shrinking NW and LOGW accordingly.
+
+Input wires and output gates are never renumbered, so the optimized
+circuit accepts the same witness and produces the same outputs as the
+original one.  The circuit id is recomputed.
+*/
+template <class Field>
+class CircuitOptimizer {
+  using Elt = typename Field::Elt;
+  using QuadF = Quad<Field>;
+  using corner = typename QuadF::corner;
+  using quad_corner_t = typename QuadF::quad_corner_t;
+  using Known = std::vector<std::optional<Elt>>;
+
+ public:
+  // telemetry
+  size_t ncorners_removed_;
+  size_t ncorners_folded_;
+  size_t nwires_removed_;
+
+  explicit CircuitOptimizer(const Field& f)
+      : ncorners_removed_(0), ncorners_folded_(0), nwires_removed_(0), f_(f) {}
+
+  // KNOWN[i], if defined, is the compile-time value of input wire I.
+  // Input wire 0 is assumed to be the constant one regardless of KNOWN.
+  void optimize(Circuit<Field>* c, const Known& known = {}) {
+    size_t nl = c->nl;
+    check(nl == c->l.size(), "nl == c->l.size()");
+    check(nl >= 1, "nl >= 1");
+
+    size_t nterms0 = c->nterms();
+    size_t nwires0 = nwires(*c);
+
+    // Forward pass: layer nl-1 reads the inputs, layer 0 produces
+    // the outputs.
+    Known kin(c->l[nl - 1].nw);
+    for (size_t i = 0; i < kin.size() && i < known.size(); ++i) {
+      kin[i] = known[i];
+    }
+    if (!kin.empty()) {
+      kin[0] = f_.one();
+    }
+    for (size_t ly = nl; ly-- > 0;) {
+      size_t nout = (ly == 0) ? size_t(c->nv) : size_t(c->l[ly - 1].nw);
+      kin = fold_layer(&c->l[ly], nout, kin);
+    }
+
+    eliminate_dead_wires(c);
+
+    for (auto& layer : c->l) {
+      layer.logw = lg(layer.nw);
+    }
+    ncorners_removed_ += nterms0 - c->nterms();
+    nwires_removed_ += nwires0 - nwires(*c);
+
+    circuit_id(c->id, *c, f_);
+  }
+
+ private:
+  const Field& f_;
+
+  static size_t nwires(const Circuit<Field>& c) {
+    size_t n = c.nv;
+    for (const auto& layer : c.l) {
+      n += layer.nw;
+    }
+    return n;
+  }
+
+  static bool is_assert(const corner& cc, const Field& F) {
+    return cc.v == F.zero();
+  }
+
+  void replace_quad(Layer<Field>* layer, std::vector<corner>& corners) {
+    auto q = std::make_unique<QuadF>(corners.size());
+    for (size_t i = 0; i < corners.size(); ++i) {
+      q->c_[i] = corners[i];
+    }
+    // Corners are unique by construction, so the coalescing pass in
+    // canonicalize() cannot merge an assertion into a product.
+    q->canonicalize(f_);
+    layer->quad = std::move(q);
+  }
+
+  // Fold the known values KIN of the inputs of LAYER, and return the
+  // known values of its NOUT outputs.
+  Known fold_layer(Layer<Field>* layer, size_t nout, const Known& kin) {
+    // Pick the anchor, preferring a wire known to be one.
+    std::optional<size_t> anchor;
+    for (size_t i = 0; i < kin.size(); ++i) {
+      if (kin[i] && kin[i].value() != f_.zero()) {
+        if (!anchor || kin[i].value() == f_.one()) {
+          anchor = i;
+        }
+        if (kin[i].value() == f_.one()) break;
+      }
+    }
+    Elt ainv = anchor ? f_.invertf(kin[*anchor].value()) : f_.one();
+    Elt ainv2 = f_.mulf(ainv, ainv);
+
+    const QuadF& q = *layer->quad;
+    std::vector<corner> products, asserts;
+    for (size_t i = 0; i < q.n_; ++i) {
+      corner cc = q.c_[i];
+      const auto& k0 = kin.at(static_cast<size_t>(cc.h[0]));
+      const auto& k1 = kin.at(static_cast<size_t>(cc.h[1]));
+      bool z0 = k0 && k0.value() == f_.zero();
+      bool z1 = k1 && k1.value() == f_.zero();
+
+      if (is_assert(cc, f_)) {
+        // assert W[h0] * W[h1] == 0
+        if (z0 || z1) {
+          continue;  // vacuous
+        }
+        if (anchor && (k0 || k1)) {
+          if (k0 && k1) {
+            // Both known and nonzero.  The circuit cannot be
+            // satisfied, but preserve the assertion as is.
+          } else {
+            // Known nonzero factors do not affect the assertion.
+            quad_corner_t x = k0 ? cc.h[1] : cc.h[0];
+            cc.h[0] = quad_corner_t(*anchor);
+            cc.h[1] = x;
+            ++ncorners_folded_;
+          }
+        }
+        asserts.push_back(cc);
+      } else {
+        if (z0 || z1) {
+          continue;  // multiplied by zero
+        }
+        if (anchor && (k0 || k1)) {
+          if (k0 && k1) {
+            // v * k0 * k1 = (v * k0 * k1 / a^2) * anchor * anchor
+            Elt v = f_.mulf(cc.v, f_.mulf(k0.value(), k1.value()));
+            cc.v = f_.mulf(v, ainv2);
+            cc.h[0] = quad_corner_t(*anchor);
+            cc.h[1] = quad_corner_t(*anchor);
+          } else {
+            // v * k * x = (v * k / a) * anchor * x
+            Elt v = f_.mulf(cc.v, k0 ? k0.value() : k1.value());
+            cc.v = f_.mulf(v, ainv);
+            quad_corner_t x = k0 ? cc.h[1] : cc.h[0];
+            cc.h[0] = quad_corner_t(*anchor);
+            cc.h[1] = x;
+          }
+          ++ncorners_folded_;
+        }
+        products.push_back(cc);
+      }
+    }
+
+    // Coalesce products at the same (g, h), dropping zero sums which
+    // would otherwise be interpreted as assertions.
+    for (auto& cc : products) {
+      cc.canonicalize();
+    }
+    std::sort(products.begin(), products.end(),
+              [&](const corner& x, const corner& y) {
+                return corner::compare(x, y, f_);
+              });
+    std::vector<corner> corners;
+    for (const auto& cc : products) {
+      if (!corners.empty() && corners.back().eqndx(cc)) {
+        f_.add(corners.back().v, cc.v);
+      } else {
+        if (!corners.empty() && corners.back().v == f_.zero()) {
+          corners.pop_back();
+        }
+        corners.push_back(cc);
+      }
+    }
+    if (!corners.empty() && corners.back().v == f_.zero()) {
+      corners.pop_back();
+    }
+
+    // Duplicate assertions are redundant.
+    for (auto& cc : asserts) {
+      cc.canonicalize();
+    }
+    std::sort(asserts.begin(), asserts.end(),
+              [&](const corner& x, const corner& y) {
+                return corner::compare(x, y, f_);
+              });
+    asserts.erase(std::unique(asserts.begin(), asserts.end(),
+                              [](const corner& x, const corner& y) {
+                                return x.eqndx(y);
+                              }),
+                  asserts.end());
+    corners.insert(corners.end(), asserts.begin(), asserts.end());
+
+    // Known outputs: gates whose products all have known hands.
+    Known kout(nout, f_.zero());
+    for (const auto& cc : corners) {
+      if (is_assert(cc, f_)) continue;
+      size_t g = static_cast<size_t>(cc.g);
+      if (!kout[g]) continue;
+      const auto& k0 = kin.at(static_cast<size_t>(cc.h[0]));
+      const auto& k1 = kin.at(static_cast<size_t>(cc.h[1]));
+      if (k0 && k1) {
+        Elt v = f_.mulf(cc.v, f_.mulf(k0.value(), k1.value()));
+        f_.add(*kout[g], v);
+      } else {
+        kout[g] = std::nullopt;
+      }
+    }
+
+    replace_quad(layer, corners);
+    return kout;
+  }
+
+  // Remove gates that are neither consumed nor asserted, and renumber
+  // the remaining wires.
+  void eliminate_dead_wires(Circuit<Field>* c) {
+    size_t nl = c->nl;
+
+    // KEEP[ly][g]: output G of layer LY survives.  REFD[ly][g]: output
+    // G of layer LY is consumed by layer LY-1 (or is a circuit output).
+    std::vector<std::vector<bool>> keep(nl), refd(nl);
+    refd[0].assign(c->nv, true);
+    for (size_t ly = 0; ly < nl; ++ly) {
+      const QuadF& q = *c->l[ly].quad;
+      keep[ly] = refd[ly];
+      // Keep wire 0 so that no layer becomes empty.
+      keep[ly][0] = true;
+      for (size_t i = 0; i < q.n_; ++i) {
+        if (is_assert(q.c_[i], f_)) {
+          keep[ly][static_cast<size_t>(q.c_[i].g)] = true;
+        }
+      }
+      if (ly + 1 < nl) {
+        refd[ly + 1].assign(c->l[ly].nw, false);
+        for (size_t i = 0; i < q.n_; ++i) {
+          const corner& cc = q.c_[i];
+          size_t g = static_cast<size_t>(cc.g);
+          if (refd[ly][g] || is_assert(cc, f_)) {
+            refd[ly + 1][static_cast<size_t>(cc.h[0])] = true;
+            refd[ly + 1][static_cast<size_t>(cc.h[1])] = true;
+          }
+        }
+      }
+    }
+
+    // RENAME[ly][g]: new index of output G of layer LY.
+    std::vector<std::vector<size_t>> rename(nl);
+    for (size_t ly = 0; ly < nl; ++ly) {
+      size_t n = 0;
+      rename[ly].resize(keep[ly].size());
+      for (size_t g = 0; g < keep[ly].size(); ++g) {
+        rename[ly][g] = keep[ly][g] ? n++ : ~size_t(0);
+      }
+    }
+
+    for (size_t ly = 0; ly < nl; ++ly) {
+      Layer<Field>& layer = c->l[ly];
+      const QuadF& q = *layer.quad;
+      std::vector<corner> corners;
+      corners.reserve(q.n_);
+      for (size_t i = 0; i < q.n_; ++i) {
+        corner cc = q.c_[i];
+        size_t g = static_cast<size_t>(cc.g);
+        if (!refd[ly][g] && !is_assert(cc, f_)) {
+          continue;  // dead product
+        }
+        // Output gates of layer 0 are never renamed.
+        if (ly > 0) {
+          cc.g = quad_corner_t(rename[ly][g]);
+        }
+        // Input wires of layer NL-1 are never renamed.
+        if (ly + 1 < nl) {
+          cc.h[0] = quad_corner_t(rename[ly + 1][static_cast<size_t>(cc.h[0])]);
+          cc.h[1] = quad_corner_t(rename[ly + 1][static_cast<size_t>(cc.h[1])]);
+        }
+        corners.push_back(cc);
+      }
+      if (ly + 1 < nl) {
+        size_t nw = 0;
+        for (bool k : keep[ly + 1]) {
+          nw += k;
+        }
+        layer.nw = corner_t(nw);
+      }
+      replace_quad(&layer, corners);
+    }
+  }
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_CIRCUIT_OPTIMIZER_H_
@@ -0,0 +1,271 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "circuits/compiler/circuit_optimizer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "algebra/fp.h"
+#include "arrays/dense.h"
+#include "circuits/compiler/compiler.h"
+#include "circuits/logic/compiler_backend.h"
+#include "circuits/logic/logic.h"
+#include "sumcheck/circuit.h"
+#include "sumcheck/prover.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+typedef Fp<1> Field;
+using Elt = Field::Elt;
+const Field F("18446744073709551557");
+
+// Evaluate C on NC copies of the inputs IN[c], returning nullptr if an
+// assertion fails in an inner layer.
+std::unique_ptr<Dense<Field>> eval(const Circuit<Field>& C,
+                                   const std::vector<std::vector<Elt>>& in) {
+  size_t nc = in.size();
+  auto W = std::make_unique<Dense<Field>>(nc, C.ninputs);
+  for (size_t c = 0; c < nc; ++c) {
+    W->v_[c] = F.one();
+    for (size_t i = 0; i < in[c].size(); ++i) {
+      W->v_[(1 + i) * nc + c] = in[c][i];
+    }
+  }
+  Prover<Field>::inputs pin;
+  Prover<Field> P(F);
+  return P.eval_circuit(&pin, &C, std::move(W), F);
+}
+
+std::unique_ptr<Circuit<Field>> clone(const Circuit<Field>& C) {
+  auto c = std::make_unique<Circuit<Field>>();
+  c->nv = C.nv;
+  c->logv = C.logv;
+  c->nc = C.nc;
+  c->logc = C.logc;
+  c->nl = C.nl;
+  c->ninputs = C.ninputs;
+  c->npub_in = C.npub_in;
+  c->subfield_boundary = C.subfield_boundary;
+  for (const auto& layer : C.l) {
+    c->l.push_back(
+        Layer<Field>{.nw = layer.nw, .logw = layer.logw,
+                     .quad = layer.quad->clone()});
+  }
+  return c;
+}
+
+void expect_equivalent(const Circuit<Field>& C0, const Circuit<Field>& C1,
+                       const std::vector<std::vector<Elt>>& in) {
+  auto v0 = eval(C0, in);
+  auto v1 = eval(C1, in);
+  ASSERT_EQ(v0 == nullptr, v1 == nullptr);
+  if (v0 != nullptr) {
+    ASSERT_EQ(v0->n0_, v1->n0_);
+    ASSERT_EQ(v0->n1_, v1->n1_);
+    for (size_t i = 0; i < v0->v_.size(); ++i) {
+      EXPECT_EQ(v0->v_[i], v1->v_[i]);
+    }
+  }
+}
+
+// x is a public parameter of the circuit, y and z are private.
+std::unique_ptr<Circuit<Field>> mk_poly_circuit(size_t nc) {
+  QuadCircuit<Field> Q(F);
+  size_t x = Q.input();
+  Q.private_input();
+  size_t y = Q.input();
+  size_t z = Q.input();
+
+  size_t xy = Q.mul(x, y);
+  size_t xxz = Q.mul(Q.mul(x, x), z);
+  size_t xm5 = Q.apy(x, F.negf(F.of_scalar(5)));
+  size_t t = Q.mul(Q.mul(xm5, z), y);
+  size_t out0 = Q.add(Q.add(xy, xxz), t);
+  size_t out1 = Q.mul(Q.mul(out0, xm5), Q.add(y, z));
+  size_t out2 = Q.mul(Q.mul(x, x), Q.mul(x, x));
+
+  // Assert 5 * y * z == xy * z when x == 5.
+  Q.assert0(Q.sub(Q.mul(F.of_scalar(5), Q.mul(y, z)), Q.mul(xy, z)));
+
+  Q.output(out0, 0);
+  Q.output(out1, 1);
+  Q.output(out2, 2);
+  Q.output(Q.mul(out1, out0), 3);
+  return Q.mkcircuit(nc);
+}
+
+TEST(CircuitOptimizer, KnownPublicInput) {
+  constexpr size_t nc = 2;
+  auto C0 = mk_poly_circuit(nc);
+  auto C1 = clone(*C0);
+
+  CircuitOptimizer<Field> opt(F);
+  std::vector<std::optional<Elt>> known(2);
+  known[1] = F.of_scalar(5);
+  opt.optimize(C1.get(), known);
+
+  EXPECT_LT(C1->nterms(), C0->nterms());
+  EXPECT_GT(opt.ncorners_folded_, 0u);
+  EXPECT_GT(opt.nwires_removed_, 0u);
+  EXPECT_EQ(C1->nv, C0->nv);
+  EXPECT_EQ(C1->nl, C0->nl);
+  for (const auto& layer : C1->l) {
+    EXPECT_EQ(layer.logw, lg(layer.nw));
+  }
+
+  for (uint64_t y = 0; y < 5; ++y) {
+    for (uint64_t z = 0; z < 5; ++z) {
+      std::vector<std::vector<Elt>> in = {
+          {F.of_scalar(5), F.of_scalar(y + 1), F.of_scalar(z * z + 7)},
+          {F.of_scalar(5), F.of_scalar(3 * z), F.of_scalar(y)}};
+      expect_equivalent(*C0, *C1, in);
+    }
+  }
+}
+
+TEST(CircuitOptimizer, AssertionsArePreserved) {
+  QuadCircuit<Field> Q(F);
+  size_t x = Q.input();
+  size_t y = Q.input();
+  size_t z = Q.input();
+  size_t w = Q.input();
+  // x * y == z, and w * y must be zero
+  Q.assert0(Q.sub(Q.mul(x, y), z));
+  Q.assert0(Q.mul(Q.mul(w, y), Q.mul(y, z)));
+  Q.output(Q.mul(Q.mul(z, z), Q.mul(y, y)), 0);
+  auto C0 = Q.mkcircuit(1);
+  auto C1 = clone(*C0);
+
+  CircuitOptimizer<Field> opt(F);
+  std::vector<std::optional<Elt>> known(5);
+  known[1] = F.of_scalar(3);
+  known[4] = F.zero();
+  opt.optimize(C1.get(), known);
+
+  // valid
+  expect_equivalent(*C0, *C1,
+                    {{F.of_scalar(3), F.of_scalar(7), F.of_scalar(21), F.zero()}});
+  // violates the first assertion
+  expect_equivalent(*C0, *C1,
+                    {{F.of_scalar(3), F.of_scalar(7), F.of_scalar(22), F.zero()}});
+}
+
+// QuadCircuit only emits assertions ONE * W == 0, so build by hand a
+// circuit that asserts X * K == 0 with K, the later input, known.
+// Canonical corners have h[0] <= h[1], so K is the second factor.
+TEST(CircuitOptimizer, AssertionWithKnownSecondFactor) {
+  using QuadF = Quad<Field>;
+  using quad_corner_t = QuadF::quad_corner_t;
+  auto corner = [](size_t g, size_t h0, size_t h1, const Elt& v) {
+    return QuadF::corner{.g = quad_corner_t(g),
+                         .h = {quad_corner_t(h0), quad_corner_t(h1)},
+                         .v = v};
+  };
+
+  // Input wires: one, x, k.  Layer 1 outputs (one, x^2) and asserts
+  // x * k == 0; layer 0 outputs x^4.
+  auto q1 = std::make_unique<QuadF>(3);
+  q1->c_[0] = corner(0, 0, 0, F.one());
+  q1->c_[1] = corner(1, 1, 1, F.one());
+  q1->c_[2] = corner(0, 1, 2, F.zero());
+  auto q0 = std::make_unique<QuadF>(1);
+  q0->c_[0] = corner(0, 1, 1, F.one());
+
+  auto C0 = std::make_unique<Circuit<Field>>();
+  C0->nv = 1;
+  C0->logv = 0;
+  C0->nc = 1;
+  C0->logc = 0;
+  C0->nl = 2;
+  C0->ninputs = 3;
+  C0->npub_in = 3;
+  C0->subfield_boundary = 0;
+  C0->l.push_back(Layer<Field>{.nw = 2, .logw = 1, .quad = std::move(q0)});
+  C0->l.push_back(Layer<Field>{.nw = 3, .logw = 2, .quad = std::move(q1)});
+  auto C1 = clone(*C0);
+
+  CircuitOptimizer<Field> opt(F);
+  std::vector<std::optional<Elt>> known(3);
+  known[2] = F.of_scalar(3);
+  opt.optimize(C1.get(), known);
+  EXPECT_GT(opt.ncorners_folded_, 0u);
+
+  // valid
+  EXPECT_NE(eval(*C1, {{F.zero(), F.of_scalar(3)}}), nullptr);
+  expect_equivalent(*C0, *C1, {{F.zero(), F.of_scalar(3)}});
+  // x * k != 0
+  EXPECT_EQ(eval(*C1, {{F.of_scalar(2), F.of_scalar(3)}}), nullptr);
+  expect_equivalent(*C0, *C1, {{F.of_scalar(2), F.of_scalar(3)}});
+}
+
+// Without known inputs, the optimizer must not break compiler output.
+TEST(CircuitOptimizer, LogicCircuit) {
+  using CompilerBackend = CompilerBackend<Field>;
+  using LogicCircuit = Logic<Field, CompilerBackend>;
+  using BitWC = LogicCircuit::BitW;
+  constexpr size_t w = 6;
+
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+  std::vector<BitWC> a(w), b(w), c(w);
+  for (size_t i = 0; i < w; ++i) {
+    a[i] = BitWC(Q.input(), F);
+  }
+  for (size_t i = 0; i < w; ++i) {
+    b[i] = BitWC(Q.input(), F);
+  }
+  BitWC carry = LC.parallel_prefix_add(w, c.data(), a.data(), b.data());
+  for (size_t i = 0; i < w; ++i) {
+    Q.output(LC.eval(c[i]), i);
+  }
+  Q.output(LC.eval(carry), w);
+  auto C0 = Q.mkcircuit(1);
+
+  // No known inputs: the circuit only loses dead wires, if any.
+  auto C1 = clone(*C0);
+  CircuitOptimizer<Field> opt(F);
+  opt.optimize(C1.get());
+  EXPECT_LE(C1->nterms(), C0->nterms());
+
+  // Known first operand.
+  constexpr uint64_t ka = 45;
+  auto C2 = clone(*C0);
+  std::vector<std::optional<Elt>> known(1 + w);
+  for (size_t i = 0; i < w; ++i) {
+    known[1 + i] = F.of_scalar((ka >> i) & 1);
+  }
+  CircuitOptimizer<Field> opt2(F);
+  opt2.optimize(C2.get(), known);
+  EXPECT_LT(C2->nterms(), C0->nterms());
+
+  for (uint64_t bv = 0; bv < (1u << w); ++bv) {
+    std::vector<Elt> in(2 * w);
+    for (size_t i = 0; i < w; ++i) {
+      in[i] = F.of_scalar((ka >> i) & 1);
+      in[w + i] = F.of_scalar((bv >> i) & 1);
+    }
+    expect_equivalent(*C0, *C1, {in});
+    expect_equivalent(*C0, *C2, {in});
+  }
+}
+
+}  // namespace
+}  // namespace proofs
@@ -20,11 +20,13 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "algebra/hash.h"
 #include "circuits/compiler/node.h"
 #include "circuits/compiler/pdqhash.h"
+#include "circuits/compiler/quad_template.h"
 #include "circuits/compiler/schedule.h"
 #include "sumcheck/circuit.h"
 #include "sumcheck/circuit_id.h"
@@ -242,29 +244,186 @@ class QuadCircuit {
     output_internal(n, quad_corner_t(wire_id));
   }
 
+  // Snapshot this circuit as a reusable gadget.  The wires created
+  // by input() become the parameters of the template, in order of
+  // creation, and OUTPUTS lists the wires that splice() returns.
+  // Assertions made by the gadget are part of the template.  This
+  // QuadCircuit must be used only to define the gadget, i.e., it
+  // cannot have outputs or public/private demarcations of its own.
+  QuadTemplate<Field> mktemplate(const std::vector<size_t>& outputs) const {
+    proofs::check(noutput_ == 0, "mktemplate() on a circuit with outputs");
+    proofs::check(npub_input_ == 0 && subfield_boundary_ == 0,
+                  "mktemplate() on a circuit with input demarcations");
+
+    // keep only inputs and the nodes that contribute to outputs
+    // or assertions
+    std::vector<bool> needed(nodes_.size(), false);
+    for (size_t op : outputs) {
+      needed.at(op) = true;
+    }
+    for (size_t op = nodes_.size(); op-- > 0;) {
+      const node& n = nodes_[op];
+      if (n.info.is_input || n.info.is_assert0) {
+        needed[op] = true;
+      }
+      if (needed[op]) {
+        for (const auto& t : n.terms) {
+          needed[t.op0] = true;
+          needed[t.op1] = true;
+        }
+      }
+    }
+
+    QuadTemplate<Field> T;
+    T.ninput_ = ninput_;
+
+    // Renumber constants and nodes.  Both maps are monotone, and
+    // thus they preserve the canonical order of terms.  Constants
+    // 0 and 1 keep their special indices.
+    std::vector<size_t> kmap(constants_.size(), PdqHash::kNil);
+    for (size_t ki = 0; ki < 2; ++ki) {
+      kmap[ki] = T.constants_.size();
+      T.constants_.push_back(constants_[ki]);
+    }
+    std::vector<size_t> opmap(nodes_.size(), PdqHash::kNil);
+    for (size_t op = 0; op < nodes_.size(); ++op) {
+      if (needed[op]) {
+        node n = nodes_[op];
+        for (auto& t : n.terms) {
+          if (kmap[t.ki] == PdqHash::kNil) {
+            kmap[t.ki] = T.constants_.size();
+            T.constants_.push_back(constants_[t.ki]);
+          }
+          t.ki = kmap[t.ki];
+          t.op0 = opmap[t.op0];
+          t.op1 = opmap[t.op1];
+        }
+        // the terms were renumbered above
+        n.rehash_terms();
+
+        // only the structural bits of the info survive
+        nodeinfo nfo;
+        nfo.is_input = n.info.is_input;
+        nfo.desired_wire_id_for_input = n.info.desired_wire_id_for_input;
+        nfo.is_assert0 = n.info.is_assert0;
+        n.info = nfo;
+
+        opmap[op] = T.nodes_.size();
+        T.nodes_.push_back(n);
+      }
+    }
+
+    for (size_t op : outputs) {
+      T.outputs_.push_back(opmap[op]);
+    }
+    return T;
+  }
+
+  // Instantiate template T with parameters ARGS, which must be wires
+  // of this circuit.  Return the wires corresponding to the template
+  // outputs.
+  //
+  // Splicing bypasses the algebraic simplifier, so a spliced gadget
+  // may be one layer deeper than the same gadget written inline
+  // when a parameter is bound to a non-input wire.  CSE is still
+  // performed on every spliced node, since the scheduler requires
+  // all nodes to be distinct.
+  std::vector<size_t> splice(const QuadTemplate<Field>& T,
+                             const std::vector<size_t>& args) {
+    proofs::check(args.size() == T.nparams(),
+                  "splice(): wrong number of arguments");
+
+    std::vector<size_t> kmap(T.constants_.size());
+    for (size_t ki = 0; ki < T.constants_.size(); ++ki) {
+      kmap[ki] = kstore(T.constants_[ki]);
+    }
+
+    std::vector<size_t> opmap(T.nodes_.size());
+    std::vector<term> terms;
+    for (size_t op = 0; op < T.nodes_.size(); ++op) {
+      const node& tn = T.nodes_[op];
+      if (tn.info.is_input) {
+        size_t id = static_cast<size_t>(tn.info.desired_wire_id_for_input);
+        opmap[op] = (id == 0) ? 0 : args.at(id - 1);
+      } else if (tn.info.is_assert0) {
+        opmap[op] = assert0(opmap[tn.terms[0].op1]);
+      } else {
+        terms.clear();
+        for (const auto& t : tn.terms) {
+          size_t op0 = opmap[t.op0], op1 = opmap[t.op1];
+          // terms with a zero operand do not exist in the
+          // simplified dag
+          if (!nodes_[op0].zero() && !nodes_[op1].zero()) {
+            terms.push_back(term(kmap[t.ki], op0, op1));
+          }
+        }
+        opmap[op] = push_node(canonical_node(terms));
+      }
+    }
+
+    std::vector<size_t> outputs;
+    outputs.reserve(T.outputs_.size());
+    for (size_t op : T.outputs_) {
+      outputs.push_back(opmap[op]);
+    }
+    return outputs;
+  }
+
   std::unique_ptr<Circuit<Field>> mkcircuit(size_t nc) {
+    std::unique_ptr<Circuit<Field>> c = std::make_unique<Circuit<Field>>();
+    CircuitAppender sink{c.get()};
+    emit(nc, c.get(), sink);
+    proofs::check(c->l.size() == c->nl, "mkcircuit: missing layers");
+    circuit_id(c->id, *c, f_);
+    return c;
+  }
+
+  // Streaming variant of mkcircuit(nc).  Instead of materializing a
+  // Circuit, call SINK.begin(header) and then SINK.layer(L) for each
+  // layer L in the order of Circuit::l, as soon as L is scheduled.
+  // The header is a Circuit with no layers and an undefined id.
+  // See CircuitRep::LayerWriter for a sink that serializes the
+  // circuit.
+  template <class Sink>
+  void mkcircuit(size_t nc, Sink& sink) {
+    Circuit<Field> hdr;
+    emit(nc, &hdr, sink);
+  }
+
+ private:
+  // Sink that appends the layers to C, which is also the header
+  // passed to begin().
+  struct CircuitAppender {
+    Circuit<Field>* c;
+    void begin(const Circuit<Field>& hdr) {
+      proofs::check(&hdr == c, "CircuitAppender: foreign header");
+      c->l.reserve(hdr.nl);
+    }
+    void layer(Layer<Field> layer) {
+      proofs::check(c->l.size() < c->nl, "CircuitAppender: too many layers");
+      c->l.push_back(std::move(layer));
+    }
+  };
+
+  template <class Sink>
+  void emit(size_t nc, Circuit<Field>* hdr, Sink& sink) {
     size_t depth_ub = compute_depth_ub();
     fixup_last_layer_assertions(depth_ub);
     compute_needed(depth_ub);
 
+    hdr->ninputs = ninput();
+    hdr->npub_in = npub_input_;
+    hdr->subfield_boundary = subfield_boundary_;
+
     Scheduler<Field> sched(nodes_, f_);
-    std::unique_ptr<Circuit<Field>> c =
-        sched.mkcircuit(constants_, depth_ub, nc);
+    sched.emit(constants_, depth_ub, nc, hdr, sink);
 
     // re-export the scheduler telemetry
     nwires_ = sched.nwires_;
     nquad_terms_ = sched.nquad_terms_;
     nwires_overhead_ = sched.nwires_overhead_;
-
-    c->ninputs = ninput();
-    c->npub_in = npub_input_;
-    c->subfield_boundary = subfield_boundary_;
-
-    circuit_id(c->id, *c, f_);
-    return c;
   }
 
- private:
   void output_internal(size_t n, quad_corner_t wire_id) {
     nodes_[n].info.is_output = true;
     nodes_[n].info.desired_wire_id_for_output = wire_id;
@@ -313,15 +472,19 @@ class QuadCircuit {
 
   node scale(const Elt& k, size_t op) {
     node n = materialize_input(op);
+    n.thash = 0;
     for (auto& t : n.terms) {
       t.ki = kstore(f_.mulf(kload(t.ki), k));
+      n.thash += t.hash();
     }
     return n;
   }
 
-  void push_back_unless_zero(std::vector<term>& terms, const term& t) const {
+  void push_back_unless_zero(std::vector<term>& terms, uint64_t& thash,
+                             const term& t) const {
     if (t.ki != 0) {
       terms.push_back(t);
+      thash += t.hash();
     }
   }
 
@@ -331,6 +494,8 @@ class QuadCircuit {
     const std::vector<term>& t0 = n0.terms;
     const std::vector<term>& t1 = n1.terms;
     std::vector<term> terms;
+    terms.reserve(t0.size() + t1.size());
+    uint64_t thash = 0;
     size_t i0 = 0, i1 = 0;
     while (i0 < t0.size() && i1 < t1.size()) {
       term t;
@@ -344,18 +509,39 @@ class QuadCircuit {
       } else {
         t = t1[i1++];
       }
-      push_back_unless_zero(terms, t);
+      push_back_unless_zero(terms, thash, t);
     }
 
     while (i0 < t0.size()) {
-      push_back_unless_zero(terms, t0[i0++]);
+      push_back_unless_zero(terms, thash, t0[i0++]);
     }
 
     while (i1 < t1.size()) {
-      push_back_unless_zero(terms, t1[i1++]);
+      push_back_unless_zero(terms, thash, t1[i1++]);
     }
 
-    return node(terms);
+    return node(std::move(terms), thash);
+  }
+
+  // Sort TERMS into the canonical order expected by merge() and
+  // coalesce terms with the same operands, which may appear after
+  // renaming.
+  node canonical_node(std::vector<term>& terms) {
+    std::sort(terms.begin(), terms.end(),
+              [](const term& a, const term& b) { return a.ltndx(b); });
+    std::vector<term> r;
+    for (const auto& t : terms) {
+      if (!r.empty() && r.back().eqndx(t)) {
+        Elt k = f_.addf(kload(r.back().ki), kload(t.ki));
+        r.back().ki = kstore(k);
+        if (r.back().ki == 0) {
+          r.pop_back();
+        }
+      } else {
+        r.push_back(t);
+      }
+    }
+    return node(r);
   }
 
   // constants_[n] stores the n-th constant, once.
@@ -15,14 +15,19 @@
 #include "circuits/compiler/compiler.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "algebra/fp.h"
 #include "arrays/dense.h"
 #include "circuits/compiler/circuit_dump.h"
+#include "circuits/compiler/pdqhash.h"
 #include "sumcheck/circuit.h"
+#include "sumcheck/prover.h"
 #include "sumcheck/testing.h"
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -106,5 +111,196 @@ TEST(Compiler, Output0) {
   EXPECT_EQ(Q.nquad_terms_, 0u);
 }
 
+// Gadget (a, b, c) -> { a*b + 3*c, (a*b) * (c + 2) }
+std::vector<size_t> gadget(QuadCircuit<Field>& Q, size_t a, size_t b,
+                           size_t c) {
+  size_t ab = Q.mul(a, b);
+  size_t o0 = Q.axpy(ab, F.of_scalar(3), c);
+  size_t o1 = Q.mul(ab, Q.apy(c, F.two()));
+  return {o0, o1};
+}
+
+QuadTemplate<Field> gadget_template() {
+  QuadCircuit<Field> G(F);
+  size_t a = G.input();
+  size_t b = G.input();
+  size_t c = G.input();
+  size_t unused = G.mul(a, c);  // not part of the template
+  (void)unused;
+  return G.mktemplate(gadget(G, a, b, c));
+}
+
+// Gadget (a, b, c) that asserts c == a * b
+QuadTemplate<Field> assert_template() {
+  QuadCircuit<Field> G(F);
+  size_t a = G.input();
+  size_t b = G.input();
+  size_t c = G.input();
+  G.assert0(G.sub(c, G.mul(a, b)));
+  return G.mktemplate({});
+}
+
+std::unique_ptr<Dense<Field>> eval(const Circuit<Field>& C,
+                                   const std::vector<Field::Elt>& in) {
+  auto W = std::make_unique<Dense<Field>>(1, C.ninputs);
+  W->v_[0] = F.one();
+  for (size_t i = 0; i < in.size(); ++i) {
+    W->v_[1 + i] = in[i];
+  }
+  Prover<Field>::inputs pin;
+  Prover<Field> P(F);
+  return P.eval_circuit(&pin, &C, std::move(W), F);
+}
+
+// Assertions in the last layer are compiled into outputs that must be
+// zero, so check both.
+bool satisfied(const Circuit<Field>& C, const std::vector<Field::Elt>& in) {
+  auto V = eval(C, in);
+  if (V == nullptr) return false;
+  for (size_t i = 0; i < V->n1_; ++i) {
+    if (V->v_[i] != F.zero()) return false;
+  }
+  return true;
+}
+
+// Instantiate the gadget with a mix of input wires, computed wires,
+// aliased parameters and constants.
+std::unique_ptr<Circuit<Field>> mk_gadget_circuit(
+    const QuadTemplate<Field>* T) {
+  QuadCircuit<Field> Q(F);
+  size_t x = Q.input();
+  size_t y = Q.input();
+  size_t z = Q.input();
+  size_t xy = Q.mul(x, y);
+  size_t k = Q.konst(F.of_scalar(7));
+
+  std::vector<std::vector<size_t>> args = {
+      {x, y, z}, {xy, z, x}, {x, x, y}, {z, k, xy}, {x, y, Q.konst(F.zero())}};
+
+  size_t nout = 0;
+  for (const auto& a : args) {
+    std::vector<size_t> o;
+    if (T != nullptr) {
+      o = Q.splice(*T, a);
+    } else {
+      o = gadget(Q, a[0], a[1], a[2]);
+    }
+    for (size_t op : o) {
+      Q.output(op, nout++);
+    }
+  }
+  return Q.mkcircuit(1);
+}
+
+TEST(Compiler, SpliceMatchesInline) {
+  auto T = gadget_template();
+  EXPECT_EQ(T.nparams(), 3u);
+  EXPECT_EQ(T.noutputs(), 2u);
+
+  auto inline_circuit = mk_gadget_circuit(nullptr);
+  auto spliced_circuit = mk_gadget_circuit(&T);
+
+  for (uint64_t x = 0; x < 4; ++x) {
+    for (uint64_t y = 0; y < 4; ++y) {
+      std::vector<Field::Elt> in = {F.of_scalar(x + 2), F.of_scalar(3 * y + 1),
+                                    F.of_scalar(x * y + 5)};
+      auto v0 = eval(*inline_circuit, in);
+      auto v1 = eval(*spliced_circuit, in);
+      ASSERT_NE(v0, nullptr);
+      ASSERT_NE(v1, nullptr);
+      EXPECT_EQ(v0->n1_, v1->n1_);
+      for (size_t i = 0; i < v0->n1_; ++i) {
+        EXPECT_EQ(v0->v_[i], v1->v_[i]);
+      }
+    }
+  }
+}
+
+TEST(Compiler, SpliceTwiceIsCse) {
+  auto T = gadget_template();
+  QuadCircuit<Field> Q(F);
+  size_t x = Q.input();
+  size_t y = Q.input();
+  size_t z = Q.input();
+  auto o0 = Q.splice(T, {x, y, z});
+  auto o1 = Q.splice(T, {x, y, z});
+  EXPECT_EQ(o0, o1);
+}
+
+TEST(Compiler, SpliceAssert0) {
+  auto T = assert_template();
+  EXPECT_EQ(T.noutputs(), 0u);
+
+  QuadCircuit<Field> Q(F);
+  size_t x = Q.input();
+  size_t y = Q.input();
+  size_t z = Q.input();
+  Q.splice(T, {x, y, z});
+  // a vacuous instance, which must not generate anything
+  Q.splice(T, {x, Q.konst(F.zero()), Q.konst(F.zero())});
+  auto C = Q.mkcircuit(1);
+
+  EXPECT_TRUE(satisfied(*C, {F.of_scalar(3), F.of_scalar(5), F.of_scalar(15)}));
+  EXPECT_FALSE(
+      satisfied(*C, {F.of_scalar(3), F.of_scalar(5), F.of_scalar(16)}));
+}
+
+TEST(PdqHash, InsertBatchAndFind) {
+  // Force narrow() collisions: keys that differ only in ways that
+  // narrow() folds together must be told apart by the predicate.
+  constexpr size_t n = 5000;
+  std::vector<uint64_t> keys(n);
+  std::vector<PdqHash::value_t> vals(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (i / 3) * 0x100000001ull;
+    vals[i] = static_cast<PdqHash::value_t>(i);
+  }
+
+  PdqHash h0, h1;
+  for (size_t i = 0; i < n / 2; ++i) {
+    h0.insert(keys[i], vals[i]);
+  }
+  h0.insert_batch(n - n / 2, &keys[n / 2], &vals[n / 2]);
+  h1.insert_batch(n, keys.data(), vals.data());
+
+  for (size_t i = 0; i < n; ++i) {
+    auto pred = [&](PdqHash::value_t v) { return v == vals[i]; };
+    EXPECT_EQ(h0.find(keys[i], pred), i);
+    EXPECT_EQ(h1.find(keys[i], pred), i);
+  }
+  auto none = [](PdqHash::value_t) { return true; };
+  EXPECT_EQ(h0.find(0xdeadbeefull, none), PdqHash::kNil);
+}
+
+// ============================= Benchmarks ===================================
+
+// Compile a dense N x N matrix product, which stresses the CSE table
+// and merge() with many wide nodes.
+void BM_CompileThroughput(benchmark::State& state) {
+  const size_t n = state.range(0);
+  size_t nquad = 0;
+  for (auto s : state) {
+    QuadCircuit<Field> Q(F);
+    std::vector<size_t> a(n * n), b(n * n);
+    for (auto& x : a) x = Q.input();
+    for (auto& x : b) x = Q.input();
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        size_t acc = Q.mul(a[i * n], b[j]);
+        for (size_t k = 1; k < n; ++k) {
+          acc = Q.add(acc, Q.mul(a[i * n + k], b[k * n + j]));
+        }
+        Q.output(acc, i * n + j);
+      }
+    }
+    auto C = Q.mkcircuit(1);
+    nquad += Q.nquad_terms_;
+    benchmark::DoNotOptimize(C);
+  }
+  state.counters["gates/s"] = benchmark::Counter(
+      static_cast<double>(nquad), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CompileThroughput)->RangeMultiplier(2)->Range(8, 32);
+
 }  // namespace
 }  // namespace proofs
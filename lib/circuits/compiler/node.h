@@ -19,6 +19,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "sumcheck/quad.h"
@@ -70,6 +71,25 @@ struct term {
   bool operator==(const term& y) const {
     return ki == y.ki && op0 == y.op0 && op1 == y.op1;
   }
+
+  // Hash of the term.  Node hashes are the sum of the term hashes,
+  // so that they can be maintained incrementally while terms are
+  // produced.
+  uint64_t hash() const {
+    uint64_t x = (static_cast<uint64_t>(op1) << 32) | op0;
+    x ^= mix(static_cast<uint64_t>(ki) + 0x9E3779B97F4A7C15ull);
+    return mix(x);
+  }
+
+ private:
+  static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+  }
 };
 
 template <class Field>
@@ -119,25 +139,44 @@ struct NodeF {
   std::vector<term> terms;
   nodeinfo info;
 
+  // sum of terms[i].hash(), maintained by whoever builds TERMS
+  uint64_t thash;
+
   NodeF() = delete;
-  explicit NodeF(quad_corner_t id) : terms() {
+  explicit NodeF(quad_corner_t id) : terms(), thash(0) {
     info.is_input = true;
     info.desired_wire_id_for_input = id;
   }
 
-  explicit NodeF(size_t ki, size_t op0, size_t op1) : terms() {
+  explicit NodeF(size_t ki, size_t op0, size_t op1) : terms(), thash(0) {
     if (ki != 0) {
       terms.push_back(term(ki, op0, op1));
+      thash = terms[0].hash();
     }
   }
 
-  explicit NodeF(const std::vector<term>& terms) : terms(terms) {}
+  explicit NodeF(const std::vector<term>& terms) : terms(terms) {
+    rehash_terms();
+  }
+
+  // The caller guarantees that THASH is the sum of the term hashes.
+  explicit NodeF(std::vector<term>&& terms, uint64_t thash)
+      : terms(std::move(terms)), thash(thash) {}
+
+  // Recompute THASH after modifying TERMS in place.
+  void rehash_terms() {
+    thash = 0;
+    for (const auto& t : terms) {
+      thash += t.hash();
+    }
+  }
 
   bool zero() const { return !info.is_input && terms.empty(); }
   bool constant() const { return terms.size() == 1 && terms[0].constant(); }
   bool linearp() const { return terms.size() == 1 && terms[0].linearp(); }
 
   bool operator==(const NodeF& y) const {
+    if (thash != y.thash) return false;
     if (info.is_input != y.info.is_input) return false;
     if (info.desired_wire_id_for_input != y.info.desired_wire_id_for_input)
       return false;
@@ -152,6 +191,9 @@ struct NodeF {
     }
     return true;
   }
+
+  // O(1), since the term hashes have already been accumulated into
+  // THASH.
   uint64_t hash() const {
     uint64_t crc = 0x1;
     crc = crc64::update(crc,
@@ -160,13 +202,8 @@ struct NodeF {
                         static_cast<uint64_t>(info.desired_wire_id_for_output));
     crc = crc64::update(crc, info.is_input);
     crc = crc64::update(crc, info.is_output);
-    size_t l = terms.size();
-    crc = crc64::update(crc, l);
-    for (size_t i = 0; i < l; ++i) {
-      crc = crc64::update(crc, terms[i].ki);
-      crc = crc64::update(crc, terms[i].op0);
-      crc = crc64::update(crc, terms[i].op1);
-    }
+    crc = crc64::update(crc, terms.size());
+    crc = crc64::update(crc, thash);
     return crc;
   }
 };
@@ -18,9 +18,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <functional>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define DEFINE_STRONG_INT_TYPE(a, b) using a = b
 
 namespace proofs {
@@ -34,6 +37,14 @@ namespace proofs {
 // stores key/value as a linked list and leaves the malloc()
 // arena so fragmented that malloc_coalesce() takes several
 // hundred ms to reconstruct the heap.
+//
+// The table is open-addressed in groups of kGroup slots.  Each slot
+// has a control byte that is either kEmpty or a 7-bit tag derived
+// from the key, and find() compares the tag against a whole group
+// at once (with SSE2 where available), so that the predicate is
+// invoked almost only on true matches.  Groups are probed
+// triangularly, which visits all groups because the number of
+// groups is a power of two.  The table supports no deletions.
 class PdqHash {
  public:
   // value of NIL denotes empty slot
@@ -54,72 +65,134 @@ class PdqHash {
     kv() : k(stored_key_t(0)), v(kNil) {}
   };
 
-  PdqHash() : bits_(10), sz_(0), table_(capacity()) {}
+  PdqHash()
+      : bits_(kMinBits), sz_(0), ctrl_(capacity(), kEmpty), table_(capacity()) {}
 
   void insert(uint64_t k64, value_t v) {
-    if (2 * sz_ > capacity()) {
+    if (full(1)) {
       rehash();
     }
     insert0(narrow(k64), v);
   }
 
-  size_t find(uint64_t k64, const std::function<bool(value_t)> &pred) {
+  // Insert N pairs (K64[i], V[i]).  The table is grown once up front,
+  // and the probe location of each key is prefetched a few insertions
+  // ahead, which hides the cache misses when N is large.
+  void insert_batch(size_t n, const uint64_t k64[/*n*/],
+                    const value_t v[/*n*/]) {
+    while (full(n)) {
+      rehash();
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (i + kPrefetchDistance < n) {
+        prefetch(mix(narrow(k64[i + kPrefetchDistance])));
+      }
+      insert0(narrow(k64[i]), v[i]);
+    }
+  }
+
+  template <class Pred>
+  size_t find(uint64_t k64, const Pred &pred) const {
     stored_key_t k = narrow(k64);
-    size_t mask = (size_t(1) << bits_) - 1;
-    size_t dh = dhash(k);
-    for (size_t h = hash(k);; h += dh) {
-      const kv *p = &table_[h & mask];
-      if (p->v == kNil) {
+    uint64_t h = mix(k);
+    uint8_t tag = tag_of(h);
+    size_t g = h & group_mask();
+    for (size_t step = 1;; ++step) {
+      const uint8_t *c = &ctrl_[g * kGroup];
+      for (uint32_t m = match(c, tag); m != 0; m &= m - 1) {
+        const kv *p = &table_[g * kGroup + __builtin_ctz(m)];
+        if (p->k == k && pred(p->v)) {
+          // found
+          return p->v;
+        }
+      }
+      if (match(c, kEmpty) != 0) {
         // not found
         return kNil;
       }
-      if (p->k == k && pred(p->v)) {
-        // found
-        return p->v;
-      }
+      g = (g + step) & group_mask();
     }
   }
 
  private:
+  static constexpr size_t kGroup = 16;
+  static constexpr size_t kMinBits = 10;
+  static constexpr size_t kPrefetchDistance = 8;
+  static constexpr uint8_t kEmpty = 0x80;
+
+  // bitmask of the bytes in group C that are equal to B
+  static uint32_t match(const uint8_t *c, uint8_t b) {
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c));
+    __m128i e = _mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(b)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(e));
+#else
+    uint32_t m = 0;
+    for (size_t i = 0; i < kGroup; ++i) {
+      m |= static_cast<uint32_t>(c[i] == b) << i;
+    }
+    return m;
+#endif
+  }
+
+  // Keys are already hashes, but NARROW() and the ad-hoc
+  // hashes of the callers do not guarantee random high bits.
+  static uint64_t mix(stored_key_t nk) {
+    uint64_t h = static_cast<uint64_t>(nk) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 32);
+  }
+  static uint8_t tag_of(uint64_t h) { return static_cast<uint8_t>(h >> 57); }
+
   void insert0(stored_key_t k, value_t v) {
-    size_t mask = (size_t(1) << bits_) - 1;
-    size_t dh = dhash(k);
-    for (size_t h = hash(k);; h += dh) {
-      kv *p = &table_[h & mask];
-      if (p->v == kNil) {
-        p->k = k;
-        p->v = v;
+    uint64_t h = mix(k);
+    size_t g = h & group_mask();
+    for (size_t step = 1;; ++step) {
+      uint8_t *c = &ctrl_[g * kGroup];
+      if (uint32_t m = match(c, kEmpty); m != 0) {
+        size_t i = g * kGroup + __builtin_ctz(m);
+        ctrl_[i] = tag_of(h);
+        table_[i].k = k;
+        table_[i].v = v;
         ++sz_;
         return;
       }
+      g = (g + step) & group_mask();
     }
   }
 
-  // Adhoc hash function suffices for this application.
-  uint64_t hash(uint64_t k) {
-    return k + 3 * (k >> bits_) + 7 * (k >> (2 * bits_));
-  }
-  uint64_t hash(stored_key_t nk) { return hash(static_cast<uint64_t>(nk)); }
-  uint64_t dhash(stored_key_t nk) {
-    // If gcd(dhash, capacity()) == 1, the insert loop does not have a short
-    // cycle.
-    return 2 * hash(hash(nk)) + 1;
+  void prefetch(uint64_t h) const {
+    size_t g = h & group_mask();
+    __builtin_prefetch(&ctrl_[g * kGroup]);
+    __builtin_prefetch(&table_[g * kGroup]);
   }
+
+  // Keep the load factor below 7/8.
+  bool full(size_t n) const { return 8 * (sz_ + n) > 7 * capacity(); }
+
   void rehash() {
     ++bits_;
+    sz_ = 0;
     std::vector<kv> table1(capacity());
+    std::vector<uint8_t> ctrl1(capacity(), kEmpty);
     table_.swap(table1);
-    for (const auto &p : table1) {
-      if (p.v != kNil) {
-        insert0(p.k, p.v);
+    ctrl_.swap(ctrl1);
+    for (size_t i = 0; i < table1.size(); ++i) {
+      if (i + kPrefetchDistance < table1.size() &&
+          ctrl1[i + kPrefetchDistance] != kEmpty) {
+        prefetch(mix(table1[i + kPrefetchDistance].k));
+      }
+      if (ctrl1[i] != kEmpty) {
+        insert0(table1[i].k, table1[i].v);
       }
     }
   }
 
-  size_t capacity() { return size_t(1) << bits_; }
+  size_t capacity() const { return size_t(1) << bits_; }
+  size_t group_mask() const { return (capacity() / kGroup) - 1; }
 
   size_t bits_;
   size_t sz_;
+  std::vector<uint8_t> ctrl_;
   std::vector<kv> table_;
 };
 }  // namespace proofs
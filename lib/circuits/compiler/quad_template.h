@@ -0,0 +1,60 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_QUAD_TEMPLATE_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_QUAD_TEMPLATE_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "circuits/compiler/node.h"
+
+namespace proofs {
+/*
+A QuadTemplate is a gadget that has been compiled once by a QuadCircuit
+and that can be instantiated many times into a parent QuadCircuit via
+QuadCircuit::splice().
+
+The template is a snapshot of the simplified DAG of the gadget,
+restricted to the nodes that are reachable from its outputs or
+assertions.  Node indices and constant indices are local to the
+template and are renumbered into the parent at splice time, so that
+the expensive algebraic simplification of the gadget (and of the
+Logic<> layer that usually sits on top of it) is paid once per
+distinct gadget instead of once per instance.
+
+Conventions follow QuadCircuit: nodes_[0] is the constant-one input,
+nodes_[1..ninput_) are the parameter inputs in the order in which
+they were created, constants_[0] == 0 and constants_[1] == 1.
+*/
+template <class Field>
+struct QuadTemplate {
+  using Elt = typename Field::Elt;
+  using node = NodeF<Field>;
+
+  size_t ninput_;  // including the constant-one input at index 0
+  std::vector<Elt> constants_;
+  std::vector<node> nodes_;
+  std::vector<size_t> outputs_;  // indices into nodes_[]
+
+  // number of parameter inputs, excluding the constant one
+  size_t nparams() const { return ninput_ - 1; }
+  size_t noutputs() const { return outputs_.size(); }
+  size_t nnodes() const { return nodes_.size(); }
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_COMPILER_QUAD_TEMPLATE_H_
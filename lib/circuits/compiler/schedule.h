@@ -54,14 +54,19 @@ class Scheduler {
         nquad_terms_(0),
         nwires_overhead_(0) {}
 
-  std::unique_ptr<Circuit<Field>> mkcircuit(const std::vector<Elt>& constants,
-                                            size_t depth_ub, size_t nc) {
-    std::unique_ptr<Circuit<Field>> c = std::make_unique<Circuit<Field>>();
-
+  // Schedule the dag into layers.  HDR must contain the input
+  // information of the circuit (ninputs, npub_in, subfield_boundary).
+  // This function sets the remaining header fields of HDR, then calls
+  // SINK.begin(*HDR) followed by SINK.layer(L) for each layer L, in
+  // the order of Circuit::l.  Per-layer structures are freed as soon
+  // as the corresponding layer is emitted.
+  template <class Sink>
+  void emit(const std::vector<Elt>& constants, size_t depth_ub, size_t nc,
+            Circuit<Field>* hdr, Sink& sink) {
     // number of layers and copies
-    c->nl = depth_ub - 1;  // depth 0 = input nodes, not a "layer"
-    c->nc = nc;
-    c->logc = lg(nc);
+    hdr->nl = depth_ub - 1;  // depth 0 = input nodes, not a "layer"
+    hdr->nc = nc;
+    hdr->logc = lg(nc);
 
     auto lnodes = order_by_layer(constants, depth_ub);
 
@@ -74,9 +79,7 @@ class Scheduler {
     // compiler anyway.
     //
     assign_wire_ids(lnodes);
-    fill_layers(c.get(), depth_ub, lnodes);
-
-    return c;
+    fill_layers(hdr, depth_ub, lnodes, sink);
   }
 
  private:
@@ -378,8 +381,9 @@ class Scheduler {
     }
   }
 
+  template <class Sink>
   void fill_layers(Circuit<Field>* c, size_t depth_ub,
-                   const std::vector<std::vector<lnode>>& lnodes) {
+                   std::vector<std::vector<lnode>>& lnodes, Sink& sink) {
     check(depth_ub == lnodes.size(), "depth_ub == lnodes.size()");
 
     corner_t nv = corner_t(lnodes.at(depth_ub - 1).size());
@@ -387,6 +391,7 @@ class Scheduler {
     nwires_ = nv;
     c->nv = nv;
     c->logv = lg(nv);
+    sink.begin(*c);
 
     // d-- > 1 (not 0) because depth 0 denotes input nodes, not a layer.
     // Sumcheck counts layers starting from the output, hence the loop
@@ -395,10 +400,12 @@ class Scheduler {
       corner_t nw =
           corner_t(lnodes.at(d - 1).size());  // inputs[d] == outputs[d-1]
       nwires_ += nw;
-      c->l.push_back(
-          Layer<Field>{.nw = nw,
-                       .logw = lg(nw),
-                       .quad = mkquad(lnodes.at(d), lnodes.at(d - 1))});
+      sink.layer(Layer<Field>{.nw = nw,
+                              .logw = lg(nw),
+                              .quad = mkquad(lnodes.at(d), lnodes.at(d - 1))});
+
+      // LNODES[D] is not needed any longer
+      std::vector<lnode>().swap(lnodes.at(d));
     }
   }
 
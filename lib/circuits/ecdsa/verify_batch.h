@@ -0,0 +1,127 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_ECDSA_VERIFY_BATCH_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_ECDSA_VERIFY_BATCH_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "arrays/dense.h"
+#include "circuits/compiler/compiler.h"
+#include "circuits/ecdsa/verify_circuit.h"
+#include "circuits/ecdsa/verify_witness.h"
+#include "circuits/logic/compiler_backend.h"
+#include "circuits/logic/logic.h"
+#include "sumcheck/circuit.h"
+#include "util/panic.h"
+
+/*
+Data-parallel verification of several ECDSA signatures.
+
+Instead of instantiating verify_signature3() once per signature in a
+flat circuit, the single-signature verifier is compiled once and the
+resulting layers are shared by NSIGS sumcheck copies.  Copy c checks
+signature c against its own public key and message hash, so the
+quad, the circuit depth, and the number of inputs per copy are those
+of the single-signature circuit, independent of NSIGS.
+
+Per copy, the input layout is that of the single-signature circuit:
+
+   1, pkx, pky, e | rx, ry, rx_inv, s_inv, pk_inv, pre[], (bi, int)...
+
+where everything after the bar is private.  Inputs are stored in a
+Dense<Field>(nc, ninputs) with copy c of input i at v_[i * nc + c].
+*/
+namespace proofs {
+
+template <class Field, class EC, size_t kWindow = 1>
+std::unique_ptr<Circuit<Field>> make_verify_batch_circuit(
+    size_t nsigs, const EC& ec, const typename Field::N& order,
+    const Field& F) {
+  using CompilerBackend = CompilerBackend<Field>;
+  using LogicCircuit = Logic<Field, CompilerBackend>;
+  using EltW = typename LogicCircuit::EltW;
+  using Verc = VerifyCircuit<LogicCircuit, Field, EC, kWindow>;
+
+  check(nsigs > 0, "nsigs > 0");
+
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit lc(&cbk, F);
+  Verc verc(lc, ec, order);
+
+  EltW pkx = Q.input(), pky = Q.input(), e = Q.input();
+  Q.private_input();
+  typename Verc::Witness vwc;
+  vwc.input(Q);
+
+  verc.verify_signature3(pkx, pky, e, vwc);
+  return Q.mkcircuit(nsigs);
+}
+
+template <class EC, class ScalarField, size_t kWindow = 1>
+class VerifyBatchWitness {
+  using Field = typename EC::Field;
+  using Elt = typename Field::Elt;
+  using Nat = typename Field::N;
+  using Verw = VerifyWitness3<EC, ScalarField, kWindow>;
+
+ public:
+  VerifyBatchWitness(size_t nsigs, const ScalarField& Fn, const EC& ec)
+      : ec_(ec), pkx_(nsigs), pky_(nsigs), e_(nsigs) {
+    w_.reserve(nsigs);
+    for (size_t c = 0; c < nsigs; ++c) {
+      w_.emplace_back(Fn, ec);
+    }
+  }
+
+  size_t nsigs() const { return w_.size(); }
+
+  // Compute the witness for the signature (r, s) on E in copy C.
+  bool compute_witness(size_t c, const Elt pkX, const Elt pkY, const Nat e,
+                       const Nat r, const Nat s) {
+    check(c < w_.size(), "c < nsigs");
+    pkx_[c] = pkX;
+    pky_[c] = pkY;
+    e_[c] = ec_.f_.to_montgomery(e);
+    return w_[c].compute_witness(pkX, pkY, e, r, s);
+  }
+
+  // Fill the public inputs of all copies, and the private inputs as
+  // well if PROVER is true.  W must have nsigs() copies.
+  void fill(Dense<Field>& W, bool prover = true) const {
+    check(W.n0_ == w_.size(), "W.n0_ == nsigs");
+    for (size_t c = 0; c < w_.size(); ++c) {
+      DenseFiller<Field> filler(W, c);
+      filler.push_back(ec_.f_.one());
+      filler.push_back(pkx_[c]);
+      filler.push_back(pky_[c]);
+      filler.push_back(e_[c]);
+      if (prover) {
+        w_[c].fill_witness(filler);
+      }
+    }
+  }
+
+ private:
+  const EC& ec_;
+  std::vector<Verw> w_;
+  std::vector<Elt> pkx_, pky_, e_;
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_ECDSA_VERIFY_BATCH_H_
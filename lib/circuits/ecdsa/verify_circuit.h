@@ -17,6 +17,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "circuits/compiler/compiler.h"
 #include "circuits/logic/bit_plucker.h"
 
@@ -28,7 +30,14 @@ namespace proofs {
 //  d: 7 wires: 21099 in: 1038 out:764 use:13911 ovh:7188 t:42963 cse:11351
 //  notn:34724
 //
-template <class LogicCircuit, class Field, class EC>
+// KWINDOW is the number of bits of each of the three scalars that are
+// consumed by one step of the scalar multiplication.  KWINDOW = 1 is
+// the original circuit.  Larger windows use a joint table of
+// 2^(3*KWINDOW) points and KBITS/KWINDOW steps, trading wider muxes
+// for fewer double/add blocks and fewer intermediate witness points.
+// The witness layout is the same for all windows, and it reduces to
+// the original one for KWINDOW = 1.
+template <class LogicCircuit, class Field, class EC, size_t kWindow = 1>
 class VerifyCircuit {
   using EltW = typename LogicCircuit::EltW;
   using BitW = typename LogicCircuit::BitW;
@@ -37,15 +46,25 @@ class VerifyCircuit {
   static constexpr size_t kBits = EC::kBits;
   using Bitvec = typename LogicCircuit::v256;
 
+  static_assert(kWindow >= 1 && kBits % kWindow == 0,
+                "window must divide the number of bits");
+
  public:
+  static constexpr size_t kSteps = kBits / kWindow;
+  static constexpr size_t kDigits = size_t(1) << kWindow;
+  // Joint table: entry a + b*kDigits + c*kDigits^2 holds g*a + pk*b + r*c.
+  static constexpr size_t kTable = kDigits * kDigits * kDigits;
+  // All entries except the identity, g, pk, and r are witnessed.
+  static constexpr size_t kPre = kTable - 4;
+
   struct Witness {
     EltW rx, ry;
-    EltW pre[8];
+    EltW pre[2 * kPre];
     EltW rx_inv, s_inv, pk_inv;
-    EltW bi[kBits];
-    EltW int_x[kBits - 1];
-    EltW int_y[kBits - 1];
-    EltW int_z[kBits - 1];
+    EltW bi[kSteps];
+    EltW int_x[kSteps - 1];
+    EltW int_y[kSteps - 1];
+    EltW int_z[kSteps - 1];
 
     void input(QuadCircuit<Field>& Q) {
       rx = Q.input();
@@ -53,12 +72,12 @@ class VerifyCircuit {
       rx_inv = Q.input();
       s_inv = Q.input();
       pk_inv = Q.input();
-      for (size_t i = 0; i < 8; ++i) {
+      for (size_t i = 0; i < 2 * kPre; ++i) {
         pre[i] = Q.input();
       }
-      for (size_t i = 0; i < kBits; ++i) {
+      for (size_t i = 0; i < kSteps; ++i) {
         bi[i] = Q.input();
-        if (i < kBits - 1) {
+        if (i < kSteps - 1) {
           int_x[i] = Q.input();
           int_y[i] = Q.input();
           int_z[i] = Q.input();
@@ -101,6 +120,16 @@ class VerifyCircuit {
   //    pkx != 0, and we ensure that (pkx,pky) is on the curve.
   //
   void verify_signature3(EltW pk_x, EltW pk_y, EltW e, const Witness& w) const {
+    if constexpr (kWindow == 1) {
+      verify_signature3_bit(pk_x, pk_y, e, w);
+    } else {
+      verify_signature3_window(pk_x, pk_y, e, w);
+    }
+  }
+
+ private:
+  void verify_signature3_bit(EltW pk_x, EltW pk_y, EltW e,
+                             const Witness& w) const {
     EltW zero = lc_.konst(lc_.zero());
     EltW one = lc_.konst(lc_.one());
     EltW gx = lc_.konst(ec_.gx_), gy = lc_.konst(ec_.gy_);
@@ -214,6 +243,125 @@ class VerifyCircuit {
       }
     }
 
+    assert_final(pk_x, pk_y, e, ax, az, est, rst, sst, r_bits, s_bits, w);
+  }
+
+  // Same checks as verify_signature3_bit(), but each step consumes
+  // kWindow bits of each scalar.  The advice bi[i] is the index into
+  // the joint table of the i-th digits (e, r, -s), encoded as
+  // bit_plucker_point<Field, kTable>.
+  void verify_signature3_window(EltW pk_x, EltW pk_y, EltW e,
+                                const Witness& w) const {
+    EltW zero = lc_.konst(lc_.zero());
+    EltW one = lc_.konst(lc_.one());
+    EltW gx = lc_.konst(ec_.gx_), gy = lc_.konst(ec_.gy_);
+    constexpr size_t D = kDigits;
+
+    // The table is in affine form, except for the identity (0,1,0).
+    std::vector<EltW> arr_x(kTable), arr_y(kTable), arr_z(kTable, one);
+    arr_x[0] = zero;
+    arr_y[0] = one;
+    arr_z[0] = zero;
+    arr_x[1] = gx;
+    arr_y[1] = gy;
+    arr_x[D] = pk_x;
+    arr_y[D] = pk_y;
+    arr_x[D * D] = w.rx;
+    arr_y[D * D] = w.ry;
+    for (size_t j = 0, slot = 0; j < kTable; ++j) {
+      if (witnessed(j)) {
+        arr_x[j] = w.pre[2 * slot];
+        arr_y[j] = w.pre[2 * slot + 1];
+        ++slot;
+      }
+    }
+
+    // Verify the witnessed entries in parallel with their use.  Entry J
+    // is the sum of a smaller entry and one of g, pk, r.
+    for (size_t j = 0; j < kTable; ++j) {
+      if (witnessed(j)) {
+        size_t base = (j % D != 0) ? 1 : ((j / D) % D != 0) ? D : D * D;
+        EltW cx, cy, cz;
+        addE(cx, cy, cz, arr_x[j - base], arr_y[j - base], one, arr_x[base],
+             arr_y[base], one);
+        point_equality(cx, cy, cz, arr_x[j], arr_y[j]);
+      }
+    }
+
+    // Muxers for the table point.  The bits of the three digits are
+    // plucked from the index instead, which also range-checks it.
+    EltMuxer<LogicCircuit, kTable> xx(lc_, arr_x.data());
+    EltMuxer<LogicCircuit, kTable> yy(lc_, arr_y.data());
+    EltMuxer<LogicCircuit, kTable> zz(lc_, arr_z.data());
+    BitPlucker<LogicCircuit, 3 * kWindow> plucker(lc_);
+
+    EltW est = zero, rst = zero, sst = zero;
+    EltW ax = zero, ay = one, az = zero;
+    Bitvec r_bits, s_bits;
+    EltW kd = lc_.konst(lc_.elt(D));
+
+    // Traverses the digits of the scalars from high-order to low-order.
+    for (size_t i = 0; i < kSteps; ++i) {
+      EltW tx = xx.mux(w.bi[i]);
+      EltW ty = yy.mux(w.bi[i]);
+      EltW tz = zz.mux(w.bi[i]);
+
+      // Bit M of the table index is bit M % kWindow of digit M / kWindow.
+      auto b = plucker.pluck(w.bi[i]);
+
+      // The plucked bits are asserted to be bits, and they must
+      // re-encode the advice, so that the advice is in the table.
+      EltW ind = lc_.konst(lc_.f_.negf(lc_.elt(kTable - 1)));
+      EltW dig[3] = {zero, zero, zero};
+      for (size_t m = 0; m < 3 * kWindow; ++m) {
+        size_t which = m / kWindow, k = m % kWindow;
+        EltW bm = lc_.eval(b[m]);
+        EltW bi2 = lc_.mul(lc_.elt(uint64_t(2) << m), bm);
+        ind = lc_.add(&ind, bi2);
+        EltW bk = lc_.mul(lc_.elt(uint64_t(1) << k), bm);
+        dig[which] = lc_.add(&dig[which], bk);
+        size_t pos = kBits - kWindow * (i + 1) + k;
+        if (which == 1) {
+          r_bits[pos] = b[m];
+        } else if (which == 2) {
+          s_bits[pos] = b[m];
+        }
+      }
+      lc_.assert_eq(&ind, w.bi[i]);
+      est = lc_.add(&dig[0], lc_.mul(&kd, est));
+      rst = lc_.add(&dig[1], lc_.mul(&kd, rst));
+      sst = lc_.add(&dig[2], lc_.mul(&kd, sst));
+
+      if (i > 0) {
+        for (size_t k = 0; k < kWindow; ++k) {
+          doubleE(ax, ay, az, ax, ay, az);
+        }
+      }
+      addE(ax, ay, az, ax, ay, az, tx, ty, tz);
+
+      if (i < kSteps - 1) {
+        // See verify_signature3_bit() for why this check also
+        // establishes that the witness is on the curve.
+        lc_.assert_eq(&ax, w.int_x[i]);
+        lc_.assert_eq(&ay, w.int_y[i]);
+        lc_.assert_eq(&az, w.int_z[i]);
+        ax = w.int_x[i];
+        ay = w.int_y[i];
+        az = w.int_z[i];
+      }
+    }
+
+    assert_final(pk_x, pk_y, e, ax, az, est, rst, sst, r_bits, s_bits, w);
+  }
+
+  // Whether table entry J is provided in Witness::pre[].
+  static constexpr bool witnessed(size_t j) {
+    return j != 0 && j != 1 && j != kDigits && j != kDigits * kDigits;
+  }
+
+  void assert_final(EltW pk_x, EltW pk_y, EltW e, EltW ax, EltW az, EltW est,
+                    EltW rst, EltW sst, const Bitvec& r_bits,
+                    const Bitvec& s_bits, const Witness& w) const {
     // Check that the aX,aZ points are 0.
     lc_.assert0(ax);
     lc_.assert0(az);
@@ -238,7 +386,6 @@ class VerifyCircuit {
     lc_.assert1(s_range);
   }
 
- private:
   void assert_nonzero(EltW x, EltW witness) const {
     auto maybe_one = lc_.mul(&x, witness);
     auto one = lc_.konst(lc_.one());
@@ -25,6 +25,7 @@
 #include "arrays/dense.h"
 #include "circuits/compiler/circuit_dump.h"
 #include "circuits/compiler/compiler.h"
+#include "circuits/ecdsa/verify_batch.h"
 #include "circuits/ecdsa/verify_circuit.h"
 #include "circuits/ecdsa/verify_witness.h"
 #include "circuits/logic/compiler_backend.h"
@@ -34,6 +35,7 @@
 #include "random/secure_random_engine.h"
 #include "random/transcript.h"
 #include "sumcheck/circuit.h"
+#include "sumcheck/prover.h"
 #include "sumcheck/testing.h"
 #include "util/log.h"
 #include "zk/zk_proof.h"
@@ -236,7 +238,29 @@ static const struct ecdsa_testvec P256_FAILS[] = {
 // The test_signature3 method below is expressed as a
 // template so that we can extend this test for different elliptic
 // curves such as secp256k1.
-template <class EC, class ScalarField>
+// Copy the witness VW into the circuit witness VWC.
+template <class Logic, class Verc, class Verw>
+void konst_witness(const Logic& l, typename Verc::Witness& vwc,
+                   const Verw& vw) {
+  vwc.rx = l.konst(vw.rx_);
+  vwc.ry = l.konst(vw.ry_);
+  vwc.rx_inv = l.konst(vw.rx_inv_);
+  vwc.s_inv = l.konst(vw.s_inv_);
+  vwc.pk_inv = l.konst(vw.pk_inv_);
+  for (size_t j = 0; j < 2 * Verc::kPre; ++j) {
+    vwc.pre[j] = l.konst(vw.pre_[j]);
+  }
+  for (size_t j = 0; j < Verc::kSteps; j++) {
+    vwc.bi[j] = l.konst(vw.bi_[j]);
+    if (j < Verc::kSteps - 1) {
+      vwc.int_x[j] = l.konst(vw.int_x_[j]);
+      vwc.int_y[j] = l.konst(vw.int_y_[j]);
+      vwc.int_z[j] = l.konst(vw.int_z_[j]);
+    }
+  }
+}
+
+template <class EC, class ScalarField, size_t kWindow = 1>
 void test_signature3(const struct ecdsa_testvec tests[], size_t num,
                      const EC& ec, const ScalarField& Fn,
                      const typename EC::Field::N& order) {
@@ -250,8 +274,8 @@ void test_signature3(const struct ecdsa_testvec tests[], size_t num,
 
   using Nat = typename Field::N;
   using Elt = typename Field::Elt;
-  using Verc = VerifyCircuit<Logic, Field, EC>;
-  using Verw = VerifyWitness3<EC, ScalarField>;
+  using Verc = VerifyCircuit<Logic, Field, EC, kWindow>;
+  using Verw = VerifyWitness3<EC, ScalarField, kWindow>;
 
   Verc verc(l, ec, order);
 
@@ -263,25 +287,10 @@ void test_signature3(const struct ecdsa_testvec tests[], size_t num,
     Nat s = Nat(tests[i].s);
 
     Verw vw(Fn, ec);
-    vw.compute_witness(pk_x, pk_y, e, r, s);
+    EXPECT_TRUE(vw.compute_witness(pk_x, pk_y, e, r, s));
 
     typename Verc::Witness vwc;
-    vwc.rx = l.konst(vw.rx_);
-    vwc.ry = l.konst(vw.ry_);
-    vwc.rx_inv = l.konst(vw.rx_inv_);
-    vwc.s_inv = l.konst(vw.s_inv_);
-    vwc.pk_inv = l.konst(vw.pk_inv_);
-    for (size_t j = 0; j < 8; ++j) {
-      vwc.pre[j] = l.konst(vw.pre_[j]);
-    }
-    for (size_t j = 0; j < ec.kBits; j++) {
-      vwc.bi[j] = l.konst(vw.bi_[j]);
-      if (j < ec.kBits - 1) {
-        vwc.int_x[j] = l.konst(vw.int_x_[j]);
-        vwc.int_y[j] = l.konst(vw.int_y_[j]);
-        vwc.int_z[j] = l.konst(vw.int_z_[j]);
-      }
-    }
+    konst_witness<Logic, Verc>(l, vwc, vw);
 
     verc.verify_signature3(l.konst(pk_x), l.konst(pk_y),
                            l.konst(F.to_montgomery(e)), vwc);
@@ -294,7 +303,14 @@ TEST(ecdsa, verify3_p256) {
                                      p256, p256_scalar, n256_order);
 }
 
-TEST(ecdsa, p256_failure) {
+TEST(ecdsa, verify3_p256_window2) {
+  test_signature3<P256, Fp256Scalar, 2>(
+      P256_TEST, sizeof(P256_TEST) / sizeof(P256_TEST[0]), p256, p256_scalar,
+      n256_order);
+}
+
+template <size_t kWindow>
+void test_p256_failure() {
   using Field = Fp256Base;
   using Nat = Field::N;
   using Elt = Field::Elt;
@@ -306,8 +322,8 @@ TEST(ecdsa, p256_failure) {
   const EvalBackend ebk(F, false);
   const Logic l(&ebk, F);
 
-  using Verc = VerifyCircuit<Logic, Field, P256>;
-  using Verw = VerifyWitness3<P256, ScalarField>;
+  using Verc = VerifyCircuit<Logic, Field, P256, kWindow>;
+  using Verw = VerifyWitness3<P256, ScalarField, kWindow>;
 
   Verc verc(l, p256, n256_order);
 
@@ -322,22 +338,7 @@ TEST(ecdsa, p256_failure) {
     vw.compute_witness(pk_x, pk_y, e, r, s);
 
     typename Verc::Witness vwc;
-    vwc.rx = l.konst(vw.rx_);
-    vwc.ry = l.konst(vw.ry_);
-    vwc.rx_inv = l.konst(vw.rx_inv_);
-    vwc.s_inv = l.konst(vw.s_inv_);
-    vwc.pk_inv = l.konst(vw.pk_inv_);
-    for (size_t j = 0; j < 8; ++j) {
-      vwc.pre[j] = l.konst(vw.pre_[j]);
-    }
-    for (size_t j = 0; j < p256.kBits; j++) {
-      vwc.bi[j] = l.konst(vw.bi_[j]);
-      if (j < p256.kBits - 1) {
-        vwc.int_x[j] = l.konst(vw.int_x_[j]);
-        vwc.int_y[j] = l.konst(vw.int_y_[j]);
-        vwc.int_z[j] = l.konst(vw.int_z_[j]);
-      }
-    }
+    konst_witness<Logic, Verc>(l, vwc, vw);
 
     verc.verify_signature3(l.konst(pk_x), l.konst(pk_y),
                            l.konst(F.to_montgomery(e)), vwc);
@@ -346,18 +347,23 @@ TEST(ecdsa, p256_failure) {
   }
 }
 
+TEST(ecdsa, p256_failure) { test_p256_failure<1>(); }
+
+TEST(ecdsa, p256_failure_window2) { test_p256_failure<2>(); }
+
+template <size_t kWindow = 1>
 std::unique_ptr<Circuit<Fp256Base>> make_circuit(size_t numSigs,
                                                  const Fp256Base& f) {
   using CompilerBackend = CompilerBackend<Fp256Base>;
   using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
-  using Verc = VerifyCircuit<LogicCircuit, Fp256Base, P256>;
+  using Verc = VerifyCircuit<LogicCircuit, Fp256Base, P256, kWindow>;
   using EltW = LogicCircuit::EltW;
 
   QuadCircuit<Fp256Base> Q(p256_base);
   const CompilerBackend cbk(&Q);
   const LogicCircuit lc(&cbk, p256_base);
   Verc verc(lc, p256, n256_order);
-  std::vector<Verc::Witness> vwc(numSigs);
+  std::vector<typename Verc::Witness> vwc(numSigs);
   std::vector<EltW> pkx, pky, e;
   for (size_t i = 0; i < numSigs; ++i) {
     pkx.push_back(Q.input());
@@ -378,11 +384,12 @@ std::unique_ptr<Circuit<Fp256Base>> make_circuit(size_t numSigs,
   return CIRCUIT;
 }
 
+template <size_t kWindow = 1>
 void fill_input(Dense<Fp256Base>& W, size_t numSigs, const Fp256Base& f,
                 bool prover = true) {
   using Nat = Fp256Base::N;
   using Elt = Fp256Base::Elt;
-  using Verw = VerifyWitness3<P256, Fp256Scalar>;
+  using Verw = VerifyWitness3<P256, Fp256Scalar, kWindow>;
 
   Elt pk_x = p256_base.of_string(P256_TEST[0].pk_x);
   Elt pk_y = p256_base.of_string(P256_TEST[0].pk_y);
@@ -407,15 +414,17 @@ void fill_input(Dense<Fp256Base>& W, size_t numSigs, const Fp256Base& f,
   }
 }
 
-TEST(ECDSA, prover_verifier3_p256) {
+template <size_t kWindow>
+void test_prover_verifier3_p256() {
   set_log_level(INFO);
   const size_t nc = 1;
 
-  std::unique_ptr<Circuit<Fp256Base>> CIRCUIT = make_circuit(1, p256_base);
+  std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
+      make_circuit<kWindow>(1, p256_base);
 
   auto W = std::make_unique<Dense<Fp256Base>>(nc, CIRCUIT->ninputs);
 
-  fill_input(*W, 1, p256_base);
+  fill_input<kWindow>(*W, 1, p256_base);
 
   Proof<Fp256Base> pr(CIRCUIT->nl);
   run_prover<Fp256Base>(CIRCUIT.get(), W->clone(), &pr, p256_base);
@@ -424,44 +433,186 @@ TEST(ECDSA, prover_verifier3_p256) {
   log(INFO, "Verify done");
 }
 
+TEST(ECDSA, prover_verifier3_p256) { test_prover_verifier3_p256<1>(); }
+
+TEST(ECDSA, prover_verifier3_p256_window2) {
+  test_prover_verifier3_p256<2>();
+}
+
+// Fill a batch witness with NSIGS signatures taken from P256_TEST, and
+// replace the signature in copy BAD with P256_FAILS[0] unless BAD >= NSIGS.
+template <size_t kWindow>
+void fill_batch_input(Dense<Fp256Base>& W, size_t nsigs, size_t bad = ~0u) {
+  using Nat = Fp256Base::N;
+  constexpr size_t ntests = sizeof(P256_TEST) / sizeof(P256_TEST[0]);
+  VerifyBatchWitness<P256, Fp256Scalar, kWindow> bw(nsigs, p256_scalar, p256);
+  for (size_t c = 0; c < nsigs; ++c) {
+    const ecdsa_testvec& t = (c == bad) ? P256_FAILS[0] : P256_TEST[c % ntests];
+    bool ok = bw.compute_witness(c, p256_base.of_string(t.pk_x),
+                                 p256_base.of_string(t.pk_y), Nat(t.e),
+                                 Nat(t.r), Nat(t.s));
+    EXPECT_EQ(ok, c != bad);
+  }
+  bw.fill(W);
+}
+
+template <size_t kWindow>
+void test_batch_prover_verifier_p256(size_t nsigs) {
+  std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
+      make_verify_batch_circuit<Fp256Base, P256, kWindow>(nsigs, p256,
+                                                          n256_order, p256_base);
+  EXPECT_EQ(CIRCUIT->nc, nsigs);
+
+  auto W = std::make_unique<Dense<Fp256Base>>(nsigs, CIRCUIT->ninputs);
+  fill_batch_input<kWindow>(*W, nsigs);
+
+  Proof<Fp256Base> pr(CIRCUIT->nl);
+  run_prover<Fp256Base>(CIRCUIT.get(), W->clone(), &pr, p256_base);
+  run_verifier<Fp256Base>(CIRCUIT.get(), std::move(W), pr, p256_base);
+}
+
+TEST(ECDSA, batch_prover_verifier_p256) {
+  test_batch_prover_verifier_p256<1>(5);
+}
+
+TEST(ECDSA, batch_prover_verifier_p256_window2) {
+  test_batch_prover_verifier_p256<2>(3);
+}
+
+// The copies share the quad of the single-signature circuit, and a bad
+// signature in any one copy makes the circuit output nonzero.
+TEST(ECDSA, batch_p256_shares_circuit) {
+  constexpr size_t nsigs = 4;
+  std::unique_ptr<Circuit<Fp256Base>> C1 = make_circuit(1, p256_base);
+  std::unique_ptr<Circuit<Fp256Base>> CN =
+      make_verify_batch_circuit<Fp256Base, P256>(nsigs, p256, n256_order,
+                                                 p256_base);
+  EXPECT_EQ(CN->nl, C1->nl);
+  EXPECT_EQ(CN->ninputs, C1->ninputs);
+  EXPECT_EQ(CN->npub_in, C1->npub_in);
+  EXPECT_EQ(CN->nterms(), C1->nterms());
+
+  for (size_t bad = 0; bad < nsigs; ++bad) {
+    auto W = std::make_unique<Dense<Fp256Base>>(nsigs, CN->ninputs);
+    fill_batch_input<1>(*W, nsigs, bad);
+
+    Prover<Fp256Base>::inputs pin;
+    Prover<Fp256Base> prover(p256_base);
+    auto V = prover.eval_circuit(&pin, CN.get(), std::move(W), p256_base);
+    bool nonzero = (V == nullptr);
+    if (V != nullptr) {
+      for (size_t i = 0; i < V->n1_; ++i) {
+        nonzero |= (V->at_corners(bad, i, p256_base) != p256_base.zero());
+      }
+    }
+    EXPECT_TRUE(nonzero);
+  }
+}
+
 // ================ Benchmarks =================================================
+template <size_t kWindow>
 void BM_ECDSASize(benchmark::State& state) {
   using CompilerBackend = CompilerBackend<Fp256Base>;
   using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
   using EltW = LogicCircuit::EltW;
-  using Verc = VerifyCircuit<LogicCircuit, Fp256Base, P256>;
+  using Verc = VerifyCircuit<LogicCircuit, Fp256Base, P256, kWindow>;
 
-  QuadCircuit<Fp256Base> Q(p256_base);
-  const CompilerBackend cbk(&Q);
-  const LogicCircuit lc(&cbk, p256_base);
-  Verc verc(lc, p256, n256_order);
+  for (auto s : state) {
+    QuadCircuit<Fp256Base> Q(p256_base);
+    const CompilerBackend cbk(&Q);
+    const LogicCircuit lc(&cbk, p256_base);
+    Verc verc(lc, p256, n256_order);
 
-  Verc::Witness vwc;
-  EltW pkx = Q.input(), pky = Q.input(), e = Q.input();
-  vwc.input(Q);
+    typename Verc::Witness vwc;
+    EltW pkx = Q.input(), pky = Q.input(), e = Q.input();
+    vwc.input(Q);
 
-  verc.verify_signature3(pkx, pky, e, vwc);
+    verc.verify_signature3(pkx, pky, e, vwc);
 
-  auto CIRCUIT = Q.mkcircuit(/*nc=*/1);
-  dump_info("ecdsa verify3", Q);
+    auto CIRCUIT = Q.mkcircuit(/*nc=*/1);
+    dump_info("ecdsa verify3", Q);
+    state.counters["terms"] = Q.nquad_terms_;
+    state.counters["inputs"] = Q.ninput_;
+    state.counters["depth"] = CIRCUIT->nl;
+  }
 }
-BENCHMARK(BM_ECDSASize);
+BENCHMARK_TEMPLATE(BM_ECDSASize, 1);
+BENCHMARK_TEMPLATE(BM_ECDSASize, 2);
 
+template <size_t kWindow>
+void BM_ECDSAWitness(benchmark::State& state) {
+  using Nat = Fp256Base::N;
+  using Elt = Fp256Base::Elt;
+  using Verw = VerifyWitness3<P256, Fp256Scalar, kWindow>;
+
+  Elt pk_x = p256_base.of_string(P256_TEST[0].pk_x);
+  Elt pk_y = p256_base.of_string(P256_TEST[0].pk_y);
+  Nat e = Nat(P256_TEST[0].e);
+  Nat r = Nat(P256_TEST[0].r);
+  Nat s = Nat(P256_TEST[0].s);
+  auto vw = std::make_unique<Verw>(p256_scalar, p256);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vw->compute_witness(pk_x, pk_y, e, r, s));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ECDSAWitness, 1);
+BENCHMARK_TEMPLATE(BM_ECDSAWitness, 2);
+
+template <size_t kWindow>
 void BM_ECDSASumcheckProver(benchmark::State& state) {
   size_t numSigs = state.range(0);
   std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
-      make_circuit(numSigs, p256_base);
+      make_circuit<kWindow>(numSigs, p256_base);
 
   auto W = Dense<Fp256Base>(1, CIRCUIT->ninputs);
 
-  fill_input(W, numSigs, p256_base);
+  fill_input<kWindow>(W, numSigs, p256_base);
 
   Proof<Fp256Base> proof(CIRCUIT->nl);
   for (auto s : state) {
     run_prover(CIRCUIT.get(), W.clone(), &proof, p256_base);
   }
 }
-BENCHMARK(BM_ECDSASumcheckProver)->DenseRange(1, 3);
+BENCHMARK_TEMPLATE(BM_ECDSASumcheckProver, 1)->DenseRange(1, 3);
+BENCHMARK_TEMPLATE(BM_ECDSASumcheckProver, 2)->DenseRange(1, 3);
+
+// One signature per sumcheck copy; compare with BM_ECDSASumcheckProver,
+// which instantiates NUMSIGS verifiers in a single copy.
+template <size_t kWindow>
+void BM_ECDSABatchSumcheckProver(benchmark::State& state) {
+  size_t numSigs = state.range(0);
+  std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
+      make_verify_batch_circuit<Fp256Base, P256, kWindow>(numSigs, p256,
+                                                          n256_order, p256_base);
+
+  auto W = Dense<Fp256Base>(numSigs, CIRCUIT->ninputs);
+  fill_batch_input<kWindow>(W, numSigs);
+
+  Proof<Fp256Base> proof(CIRCUIT->nl);
+  for (auto s : state) {
+    run_prover(CIRCUIT.get(), W.clone(), &proof, p256_base);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ECDSABatchSumcheckProver, 1)->DenseRange(1, 3)->Arg(8);
+BENCHMARK_TEMPLATE(BM_ECDSABatchSumcheckProver, 2)->DenseRange(1, 3)->Arg(8);
+
+template <size_t kWindow>
+void BM_ECDSABatchSumcheckVerifier(benchmark::State& state) {
+  size_t numSigs = state.range(0);
+  std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
+      make_verify_batch_circuit<Fp256Base, P256, kWindow>(numSigs, p256,
+                                                          n256_order, p256_base);
+
+  auto W = Dense<Fp256Base>(numSigs, CIRCUIT->ninputs);
+  fill_batch_input<kWindow>(W, numSigs);
+
+  Proof<Fp256Base> proof(CIRCUIT->nl);
+  run_prover(CIRCUIT.get(), W.clone(), &proof, p256_base);
+  for (auto s : state) {
+    run_verifier(CIRCUIT.get(), W.clone(), proof, p256_base);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ECDSABatchSumcheckVerifier, 1)->DenseRange(1, 3)->Arg(8);
 
 void BM_ECDSACommit(benchmark::State& state) {
   size_t numSigs = state.range(0);
@@ -500,10 +651,11 @@ void BM_ECDSACommit(benchmark::State& state) {
 }
 BENCHMARK(BM_ECDSACommit)->DenseRange(1, 3);
 
+template <size_t kWindow>
 void BM_ECDSAZKProver(benchmark::State& state) {
   size_t numSigs = state.range(0);
   std::unique_ptr<Circuit<Fp256Base>> CIRCUIT =
-      make_circuit(numSigs, p256_base);
+      make_circuit<kWindow>(numSigs, p256_base);
 
   auto W = Dense<Fp256Base>(1, CIRCUIT->ninputs);
 
@@ -521,7 +673,7 @@ void BM_ECDSAZKProver(benchmark::State& state) {
       "317040948518153410669569855215889129699039744181079354462206130544166376"
       "41043";
 
-  fill_input(W, numSigs, p256_base);
+  fill_input<kWindow>(W, numSigs, p256_base);
   const Elt2 omega = p256_2.of_string(kRootX, kRootY);
   const FftExtConvolutionFactory fft_b(p256_base, p256_2, omega, 1ull << 31);
   const RSFactory rsf(fft_b, p256_base);
@@ -536,7 +688,8 @@ void BM_ECDSAZKProver(benchmark::State& state) {
     prover.prove(zkpr, W, tp);
   }
 }
-BENCHMARK(BM_ECDSAZKProver)->DenseRange(1, 3);
+BENCHMARK_TEMPLATE(BM_ECDSAZKProver, 1)->DenseRange(1, 3);
+BENCHMARK_TEMPLATE(BM_ECDSAZKProver, 2)->DenseRange(1, 3);
 
 void BM_ECDSAZKVerifier(benchmark::State& state) {
   size_t numSigs = state.range(0);
@@ -16,9 +16,11 @@
 #define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_ECDSA_VERIFY_WITNESS_H_
 
 #include <cstddef>
+#include <vector>
 
 #include "algebra/utility.h"
 #include "arrays/dense.h"
+#include "circuits/logic/bit_plucker_constants.h"
 #include "util/panic.h"
 
 /*
@@ -26,7 +28,8 @@ Methods to help prepare witnesses for use in assertions about ecdsa.
 */
 namespace proofs {
 
-template <class EC, class ScalarField>
+// KWINDOW must match the VerifyCircuit that consumes the witness.
+template <class EC, class ScalarField, size_t kWindow = 1>
 class VerifyWitness3 {
   using Field = typename EC::Field;
   using Elt = typename Field::Elt;
@@ -36,17 +39,21 @@ class VerifyWitness3 {
 
  public:
   constexpr static size_t kBits = EC::kBits;
+  constexpr static size_t kSteps = kBits / kWindow;
+  constexpr static size_t kDigits = size_t(1) << kWindow;
+  constexpr static size_t kTable = kDigits * kDigits * kDigits;
+  constexpr static size_t kPre = kTable - 4;
   const ScalarField& fn_;
   const EC& ec_;
   Elt rx_, ry_;
   Elt rx_inv_;
   Elt s_inv_;
   Elt pk_inv_;
-  Elt pre_[8];
-  Elt bi_[kBits];
-  Elt int_x_[kBits];   /* Intermediate x,y elliptic curve points */
-  Elt int_y_[kBits];   /* encountered during the scalar mult loop. */
-  Elt int_z_[kBits];   /* z-coordinate of the intermediate points */
+  Elt pre_[2 * kPre];
+  Elt bi_[kSteps];
+  Elt int_x_[kSteps];   /* Intermediate x,y elliptic curve points */
+  Elt int_y_[kSteps];   /* encountered during the scalar mult loop. */
+  Elt int_z_[kSteps];   /* z-coordinate of the intermediate points */
 
   VerifyWitness3(const ScalarField& Fn, const EC& ec) : fn_(Fn), ec_(ec) {}
 
@@ -56,12 +63,12 @@ class VerifyWitness3 {
     filler.push_back(rx_inv_);
     filler.push_back(s_inv_);
     filler.push_back(pk_inv_);
-    for (size_t i = 0; i < 8; ++i) {
+    for (size_t i = 0; i < 2 * kPre; ++i) {
       filler.push_back(pre_[i]);
     }
-    for (size_t i = 0; i < kBits; ++i) {
+    for (size_t i = 0; i < kSteps; ++i) {
       filler.push_back(bi_[i]);
-      if (i < kBits - 1) {
+      if (i < kSteps - 1) {
         filler.push_back(int_x_[i]);
         filler.push_back(int_y_[i]);
         filler.push_back(int_z_[i]);
@@ -84,58 +91,63 @@ class VerifyWitness3 {
     auto tr_s = fn_.mulf(fn_.to_montgomery(r), _s);
     const Nat nes = fn_.from_montgomery(te_s);
     const Nat nrs = fn_.from_montgomery(tr_s);
-    Point bases[] = {ec_.generator(), Point(pkX, pkY, F.one())};
-    Nat scalars[] = {nes, nrs};
-    auto pr = ec_.scalar_multf(2, bases, scalars);
-    ec_.normalize(pr);
+    auto pr = ec_.double_scalar_multf(ec_.generator(), nes,
+                                      Point(pkX, pkY, F.one()), nrs);
 
+    const Nat nms = fn_.from_montgomery(tms);   /* -s */
     rx_ = F.to_montgomery(r);
-    ry_ = pr.y;
 
-    // In the case of a malicious input with rx=0 or s=0, the proof will fail.
+    // Normalize pr and invert rx, -s, and pk with a single inversion.
+    // In the case of a malicious input with rx=0 or s=0, the inverse
+    // is zero and the proof will fail.
+    const Elt den[4] = {pr.z, rx_, F.to_montgomery(nms), pkX};
+    Elt inv[4];
+    AlgebraUtil<Field>::batch_invert_or_zero(4, inv, den, F);
+    ry_ = pr.z == F.zero() ? pr.y : F.mulf(pr.y, inv[0]);
+    rx_inv_ = inv[1];
+    s_inv_ = inv[2];
+    pk_inv_ = inv[3];
     if (rx_ != F.zero()) {
-      rx_inv_ = F.invertf(rx_);
       check(F.mulf(rx_, rx_inv_) == F.one(), "bad inv");
     }
 
-    s_inv_ = F.to_montgomery(fn_.from_montgomery(tms));
-    if (s_inv_ != F.zero()) {
-      F.invert(s_inv_);
-    }
-
-    if (pkX != F.zero()) {
-      pk_inv_ = F.invertf(pkX);
+    if constexpr (kWindow == 1) {
+      return compute_bit(pkX, pkY, e, r, nms);
+    } else {
+      return compute_window(pkX, pkY, e, r, nms);
     }
+  }
 
-    const Nat nms = fn_.from_montgomery(tms);   /* -s */
+ private:
+  bool compute_bit(const Elt pkX, const Elt pkY, const Nat& e, const Nat& r,
+                   const Nat& nms) {
+    const Field& F = ec_.f_;
 
-    // Produce the table of pre-computed g,r,pk sums.
+    // Produce the table of pre-computed g,r,pk sums.  g+r+pk is
+    // computed from the projective g+r, so that the four entries
+    // are normalized with one batched inversion.
     const Elt one = F.one(), gX = ec_.gx_, gY = ec_.gy_;
-    const Elt lh[] = {gX, gY, gX, gY, pkX, pkY};
-    const Elt rh[] = {pkX, pkY, rx_, ry_, rx_, ry_};
-    Elt zi;
-    for (size_t i = 0; i < 3; ++i) {
-      ec_.addE(pre_[2 * i], pre_[2 * i + 1], zi,
-               lh[2 * i], lh[2 * i + 1], one,
-               rh[2 * i], rh[2 * i + 1], one);
-
-      // This invert cannot fail because both the generator and pk are
-      // trusted inputs, so the above addition is not the identity.
-      // In the case that it is, the proof will fail (and it should, since
-      // the system is unsound with sk=-1).
-      if (zi != F.zero()) {
-        F.invert(zi);
-      }
-      F.mul(pre_[2 * i], zi);
-      F.mul(pre_[2 * i + 1], zi);
-    }
-    // rgpk
-    ec_.addE(pre_[6], pre_[7], zi, pre_[2], pre_[3], one, pkX, pkY, one);
-    if (zi != F.zero()) {
-      F.invert(zi);
+    Elt px[4], py[4], pz[4];
+    ec_.addEAffine(px[0], py[0], pz[0], gX, gY, one, pkX, pkY);
+    ec_.addEAffine(px[1], py[1], pz[1], gX, gY, one, rx_, ry_);
+    ec_.addEAffine(px[2], py[2], pz[2], pkX, pkY, one, rx_, ry_);
+    ec_.addEAffine(px[3], py[3], pz[3], px[1], py[1], pz[1], pkX, pkY);
+
+    // The inverses cannot fail because both the generator and pk are
+    // trusted inputs, so the above additions are not the identity.
+    // In the case that they are, the entry is zero and the proof will
+    // fail (and it should, since the system is unsound with sk=-1).
+    Elt zi[4];
+    AlgebraUtil<Field>::batch_invert_or_zero(4, zi, pz, F);
+    for (size_t i = 0; i < 4; ++i) {
+      pre_[2 * i] = F.mulf(px[i], zi[i]);
+      pre_[2 * i + 1] = F.mulf(py[i], zi[i]);
     }
-    F.mul(pre_[6], zi);
-    F.mul(pre_[7], zi);
+
+    // Table indexed by b below, with the identity at 0.
+    const Elt tx[8] = {F.zero(), gX, pkX, pre_[0], rx_, pre_[2], pre_[4],
+                       pre_[6]};
+    const Elt ty[8] = {one, gY, pkY, pre_[1], ry_, pre_[3], pre_[5], pre_[7]};
 
     Elt aX = F.zero(), aY = one, aZ = F.zero();
 
@@ -154,31 +166,10 @@ class VerifyWitness3 {
       if (i > 0) {
         ec_.doubleE(aX, aY, aZ, aX, aY, aZ);
       }
-      switch (b[i]) {
-        case 0:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, F.zero(), F.one(), F.zero());
-          break;
-        case 1:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, gX, gY, one);
-          break;
-        case 2:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, pkX, pkY, one);
-          break;
-        case 3:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, pre_[0], pre_[1], one);
-          break;
-        case 4:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, rx_, ry_, one);
-          break;
-        case 5:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, pre_[2], pre_[3], one);
-          break;
-        case 6:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, pre_[4], pre_[5], one);
-          break;
-        case 7:
-          ec_.addE(aX, aY, aZ, aX, aY, aZ, pre_[6], pre_[7], one);
-          break;
+      if (b[i] == 0) {
+        ec_.addE(aX, aY, aZ, aX, aY, aZ, F.zero(), F.one(), F.zero());
+      } else {
+        ec_.addEAffine(aX, aY, aZ, aX, aY, aZ, tx[b[i]], ty[b[i]]);
       }
 
       int_x_[i] = aX;
@@ -195,6 +186,72 @@ class VerifyWitness3 {
 
     return true;
   }
+
+  // Table and intermediate points for the windowed circuit; see
+  // VerifyCircuit::verify_signature3_window().
+  bool compute_window(const Elt pkX, const Elt pkY, const Nat& e, const Nat& r,
+                      const Nat& nms) {
+    const Field& F = ec_.f_;
+    constexpr size_t D = kDigits;
+
+    std::vector<Point> tbl(kTable);
+    tbl[0] = ec_.zero();
+    tbl[1] = ec_.generator();
+    tbl[D] = Point(pkX, pkY, F.one());
+    tbl[D * D] = Point(rx_, ry_, F.one());
+    std::vector<size_t> wj;
+    for (size_t j = 0; j < kTable; ++j) {
+      if (j != 0 && j != 1 && j != D && j != D * D) {
+        size_t base = (j % D != 0) ? 1 : ((j / D) % D != 0) ? D : D * D;
+        tbl[j] = ec_.addEf(tbl[j - base], tbl[base]);
+        wj.push_back(j);
+      }
+    }
+
+    // Normalize all witnessed entries with one batched inversion.  As
+    // in compute_bit(), an identity entry makes the proof fail.
+    std::vector<Elt> z(kPre), zi(kPre);
+    for (size_t slot = 0; slot < kPre; ++slot) {
+      z[slot] = tbl[wj[slot]].z;
+    }
+    AlgebraUtil<Field>::batch_invert_or_zero(kPre, zi.data(), z.data(), F);
+    for (size_t slot = 0; slot < kPre; ++slot) {
+      Point& t = tbl[wj[slot]];
+      t = Point(F.mulf(t.x, zi[slot]), F.mulf(t.y, zi[slot]), F.one());
+      pre_[2 * slot] = t.x;
+      pre_[2 * slot + 1] = t.y;
+    }
+
+    Elt aX = F.zero(), aY = F.one(), aZ = F.zero();
+    for (size_t i = 0; i < kSteps; ++i) {
+      size_t idx = 0;
+      for (size_t k = 0; k < kWindow; ++k) {
+        size_t pos = kBits - kWindow * (i + 1) + k;
+        idx |= (e.bit(pos) | (r.bit(pos) << kWindow) |
+                (nms.bit(pos) << (2 * kWindow)))
+               << k;
+      }
+      bi_[i] = bit_plucker_point<Field, kTable>()(idx, F);
+
+      if (i > 0) {
+        for (size_t k = 0; k < kWindow; ++k) {
+          ec_.doubleE(aX, aY, aZ, aX, aY, aZ);
+        }
+      }
+      const Point& t = tbl[idx];
+      if (idx == 0) {
+        ec_.addE(aX, aY, aZ, aX, aY, aZ, t.x, t.y, t.z);
+      } else {
+        ec_.addEAffine(aX, aY, aZ, aX, aY, aZ, t.x, t.y);
+      }
+
+      int_x_[i] = aX;
+      int_y_[i] = aY;
+      int_z_[i] = aZ;
+    }
+
+    return aX == F.zero() && aZ == F.zero();
+  }
 };
 }  // namespace proofs
 
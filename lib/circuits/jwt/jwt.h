@@ -130,8 +130,8 @@ class JWT {
     ecc.verify_signature3(pkX, pkY, vw.e_, vw.jwt_sig_);
     ecc.verify_signature3(vw.dpkx_, vw.dpky_, e2, vw.kb_sig_);
 
-    sha_.assert_message_hash(kMaxSHABlocks, vw.nb_, vw.preimage_, vw.e_bits_,
-                             vw.sha_);
+    sha_.assert_message_hash_enabled(kMaxSHABlocks, vw.nb_, vw.preimage_,
+                                     vw.e_bits_, vw.sha_);
     lc_.vassert_is_bit(vw.e_bits_);
 
     // Check that the e_bits_ match the EltW for e used in the signature.
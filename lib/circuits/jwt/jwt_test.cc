@@ -25,6 +25,7 @@
 #include "algebra/reed_solomon.h"
 #include "algebra/static_string.h"
 #include "arrays/dense.h"
+#include "circuits/base64/decode_util.h"
 #include "circuits/compiler/circuit_dump.h"
 #include "circuits/compiler/compiler.h"
 #include "circuits/jwt/jwt_constants.h"
@@ -554,5 +555,56 @@ BENCHMARK(BM_JwtZKProver7);
 BENCHMARK(BM_JwtZKProver11);
 BENCHMARK(BM_JwtZKProver15);
 
+// Witness filling for a JWT that fills SHABlocks blocks, i.e., of about
+// SHABlocks / 16 KB.  The signatures are not computed, since filling
+// their witnesses does not depend on the JWT.
+template <size_t SHABlocks>
+void BM_JwtFillWitness(benchmark::State& state) {
+  JWTWitness<P256, Fp256Scalar, SHABlocks> rvw(p256, p256_scalar);
+  std::vector<uint8_t> msg(SHABlocks * 64 - 9, 'a');
+  FlatSHA256Witness::transform_and_witness_enabled_message(
+      msg.size(), msg.data(), SHABlocks, rvw.numb_, rvw.preimage_,
+      rvw.sha_bw_);
+  rvw.na_ = 0;
+
+  auto W = Dense<Fp256Base>(1, SHABlocks * (64 * 8 + 184 * 8) + 8192);
+  for (auto s : state) {
+    DenseFiller<Fp256Base> filler(W);
+    rvw.fill_witness(filler);
+  }
+}
+
+void BM_JwtFillWitness1K(benchmark::State& state) {
+  BM_JwtFillWitness<16>(state);
+}
+void BM_JwtFillWitness2K(benchmark::State& state) {
+  BM_JwtFillWitness<32>(state);
+}
+void BM_JwtFillWitness4K(benchmark::State& state) {
+  BM_JwtFillWitness<64>(state);
+}
+void BM_JwtFillWitness8K(benchmark::State& state) {
+  BM_JwtFillWitness<128>(state);
+}
+
+BENCHMARK(BM_JwtFillWitness1K);
+BENCHMARK(BM_JwtFillWitness2K);
+BENCHMARK(BM_JwtFillWitness4K);
+BENCHMARK(BM_JwtFillWitness8K);
+
+void BM_JwtBase64Payload(benchmark::State& state) {
+  static const char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  std::string payload(state.range(0), 'A');
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = kAlphabet[(i * 7) % 64];
+  }
+  for (auto s : state) {
+    std::vector<uint8_t> out;
+    benchmark::DoNotOptimize(base64_decode_url(payload, out));
+  }
+}
+BENCHMARK(BM_JwtBase64Payload)->RangeMultiplier(2)->Range(1 << 10, 1 << 13);
+
 }  // namespace
 }  // namespace proofs
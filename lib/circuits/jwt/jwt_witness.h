@@ -145,9 +145,7 @@ class JWTWitness {
     kb_sig_.fill_witness(filler);
 
     // Write the message.
-    for (size_t i = 0; i < 64 * kMaxSHABlocks; ++i) {
-      filler.push_back(preimage_[i], 8, ec_.f_);
-    }
+    filler.push_back_bytes(preimage_, 64 * kMaxSHABlocks, ec_.f_);
 
     for (size_t i = 0; i < 256; ++i) {
       filler.push_back(e_bits_[i], 1, ec_.f_);
@@ -223,7 +221,7 @@ class JWTWitness {
       return false;
     }
 
-    FlatSHA256Witness::transform_and_witness_message(
+    FlatSHA256Witness::transform_and_witness_enabled_message(
         id_jws.msg.size(), reinterpret_cast<const uint8_t*>(id_jws.msg.data()),
         kMaxSHABlocks, numb_, preimage_, sha_bw_);
 
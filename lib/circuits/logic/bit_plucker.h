@@ -40,7 +40,7 @@ thus makes the proof smaller or more efficient to compute or verify.
 
 The optimal bit-plucker for k bits depends on k.  For small k, the simplest
 bit plucker is sufficient. In some cases, bit pluckers can exploit the field
-structure.
+structure.  See bit_plucker_cost.h for choosing k at a call site.
 
 [ RUN      ] BitPlucker.PluckSize
 pluck[1]: depth:  3 wires: 6 in: 2 out:2 use:4 ovh:2 t:6 cse:0 notn:9
@@ -0,0 +1,137 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BIT_PLUCKER_COST_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BIT_PLUCKER_COST_H_
+
+#include <stddef.h>
+
+#include <cstdint>
+
+namespace proofs {
+/*
+Compile-time cost model for the packing density LOGN of BitPlucker.
+
+A BitPlucker<Logic, LOGN> packs LOGN witness bits into one field element.
+Denser packings commit fewer witness elements, and thus fewer Ligero
+rows, at the price of LOGN polynomials of degree 2^LOGN - 1 per element
+in the circuit, i.e., more quad terms, and of one more layer per bit.
+
+The model charges, in units of one quad term of sumcheck work:
+
+   nterms                  for the pluck() calls,
+   kInputWeight * ninputs  for the packed witness elements,
+   kInputWeight * kBitPluckerLayerPad * depth
+                           for the pad witnesses of the layers of the
+                           plucker (see ZkCommon::PadLayout).
+
+kInputWeight is the number of Reed-Solomon encoded elements of the Ligero
+tableau per committed element, times the cost of one encoded element
+relative to one quad term.  The latter was fitted to
+BM_ShaZKPlucker_{fp2_128,p256} as 154ns vs 79ns in GF(2^128) and
+3.7us vs 0.69us in P-256, where the commitment goes through the Fp2 FFT.
+The model is linear, and thus ignores the rounding of the Ligero layout
+to whole rows; BitPluckerCost.Calculator compares it against the
+compiled circuits.
+*/
+
+// A call site of a BitPlucker: a circuit that unpacks NGROUPS groups of
+// GROUP_BITS bits each, e.g., a packed_v32 has GROUP_BITS = 32.  A
+// group is packed into ceil(GROUP_BITS / LOGN) field elements.
+struct BitPluckerSite {
+  size_t group_bits;
+  size_t ngroups;
+};
+
+struct BitPluckerCost {
+  size_t ninputs;  // committed witness elements
+  size_t nterms;   // quad terms of the pluck() calls
+  size_t depth;    // layers of one pluck()
+};
+
+constexpr size_t kBitPluckerMaxBits = 8;
+
+// Pad witnesses of one layer, 4 * logw + 3 for a layer of 2^20 wires.
+constexpr size_t kBitPluckerLayerPad = 83;
+
+// Quad terms and depth of one BitPlucker::pluck() as compiled by
+// QuadCircuit, indexed by LOGN.  BitPluckerCost.MatchesCompiler checks
+// these tables against the compiler.
+constexpr size_t kBitPluckerTerms[2][kBitPluckerMaxBits + 1] = {
+    /*prime=*/{0, 6, 18, 38, 74, 144, 288, 594, 1254},
+    /*binary=*/{0, 6, 13, 27, 45, 67, 93, 123, 157},
+};
+constexpr size_t kBitPluckerDepth[2][kBitPluckerMaxBits + 1] = {
+    /*prime=*/{0, 3, 4, 5, 6, 7, 8, 9, 10},
+    /*binary=*/{0, 3, 3, 4, 5, 6, 7, 8, 9},
+};
+
+// Encoded elements of the Ligero tableau per committed element, i.e.,
+// about block_enc / w at rate 4.
+constexpr uint64_t kBitPluckerLigeroExpansion = 8;
+
+// Cost of one encoded element of the Ligero tableau, in quad terms.
+template <class Field>
+constexpr uint64_t bit_plucker_encoded_weight() {
+  return Field::kCharacteristicTwo ? 2 : 5;
+}
+
+template <class Field>
+constexpr uint64_t bit_plucker_input_weight() {
+  return kBitPluckerLigeroExpansion * bit_plucker_encoded_weight<Field>();
+}
+
+template <class Field>
+constexpr BitPluckerCost bit_plucker_cost(const BitPluckerSite& s,
+                                          size_t logn) {
+  const size_t ch2 = Field::kCharacteristicTwo ? 1 : 0;
+  const size_t nelts = s.ngroups * ((s.group_bits + logn - 1) / logn);
+  return BitPluckerCost{nelts, nelts * kBitPluckerTerms[ch2][logn],
+                        kBitPluckerDepth[ch2][logn]};
+}
+
+// Modeled prover cost of plucking all the SITES of a circuit with the
+// same LOGN.  The sites are plucked in parallel, so the depth is charged
+// once.
+template <class Field, size_t K>
+constexpr uint64_t bit_plucker_prover_cost(const BitPluckerSite (&sites)[K],
+                                           size_t logn) {
+  uint64_t ninputs = 0, nterms = 0, depth = 0;
+  for (size_t i = 0; i < K; ++i) {
+    BitPluckerCost c = bit_plucker_cost<Field>(sites[i], logn);
+    ninputs += c.ninputs;
+    nterms += c.nterms;
+    depth = c.depth;
+  }
+  return nterms + bit_plucker_input_weight<Field>() *
+                      (ninputs + kBitPluckerLayerPad * depth);
+}
+
+// The LOGN in [1, MAX_BITS] of least modeled prover cost for SITES.
+template <class Field, size_t K>
+constexpr size_t bit_plucker_optimal_bits(
+    const BitPluckerSite (&sites)[K], size_t max_bits = kBitPluckerMaxBits) {
+  size_t best = 1;
+  for (size_t logn = 2; logn <= max_bits; ++logn) {
+    if (bit_plucker_prover_cost<Field>(sites, logn) <
+        bit_plucker_prover_cost<Field>(sites, best)) {
+      best = logn;
+    }
+  }
+  return best;
+}
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BIT_PLUCKER_COST_H_
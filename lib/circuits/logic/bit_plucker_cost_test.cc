@@ -0,0 +1,257 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "circuits/logic/bit_plucker_cost.h"
+
+#include <stddef.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "circuits/compiler/compiler.h"
+#include "circuits/logic/bit_plucker.h"
+#include "circuits/logic/compiler_backend.h"
+#include "circuits/logic/logic.h"
+#include "circuits/mac/mac_circuit.h"
+#include "circuits/sha/flatsha256_circuit.h"
+#include "ec/p256.h"
+#include "gf2k/gf2_128.h"
+#include "ligero/ligero_param.h"
+#include "sumcheck/circuit.h"
+#include "util/log.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+// Witness groups of the BitPlucker call sites, per instance.
+constexpr BitPluckerSite kShaBlockSites[] = {{32, 48 + 64 + 64 + 8}};
+constexpr BitPluckerSite kMacSites[] = {{128, 2}, {256, 1}};
+
+// The model is usable at compile time.
+static_assert(bit_plucker_optimal_bits<GF2_128<>>(kShaBlockSites) == 2);
+static_assert(bit_plucker_optimal_bits<Fp256Base>(kShaBlockSites) == 3);
+static_assert(bit_plucker_optimal_bits<Fp256Base>(kMacSites) == 2);
+
+template <class Field, size_t LOGN>
+void expect_pluck_cost(const Field& F) {
+  using CompilerBackend = CompilerBackend<Field>;
+  using LogicCircuit = Logic<Field, CompilerBackend>;
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+  const BitPlucker<LogicCircuit, LOGN> PC(LC);
+
+  auto r = PC.pluck(Q.input());
+  for (size_t k = 0; k < LOGN; ++k) {
+    Q.output(LC.eval(r[k]), k);
+  }
+  auto circuit = Q.mkcircuit(/*nc=*/1);
+
+  BitPluckerCost c = bit_plucker_cost<Field>(BitPluckerSite{LOGN, 1}, LOGN);
+  EXPECT_EQ(c.ninputs, 1u);
+  EXPECT_EQ(c.nterms, Q.nquad_terms_) << "LOGN " << LOGN;
+  EXPECT_EQ(c.depth, Q.depth_) << "LOGN " << LOGN;
+}
+
+template <class Field>
+void expect_pluck_costs(const Field& F) {
+  expect_pluck_cost<Field, 1>(F);
+  expect_pluck_cost<Field, 2>(F);
+  expect_pluck_cost<Field, 3>(F);
+  expect_pluck_cost<Field, 4>(F);
+  expect_pluck_cost<Field, 5>(F);
+  expect_pluck_cost<Field, 6>(F);
+  expect_pluck_cost<Field, 7>(F);
+  expect_pluck_cost<Field, 8>(F);
+}
+
+TEST(BitPluckerCost, MatchesCompiler) {
+  expect_pluck_costs(p256_base);
+  expect_pluck_costs(GF2_128<>());
+}
+
+TEST(BitPluckerCost, Sites) {
+  // A 32-bit group does not divide evenly for LOGN = 3: 11 elements.
+  BitPluckerCost c = bit_plucker_cost<Fp256Base>(kShaBlockSites[0], 3);
+  EXPECT_EQ(c.ninputs, 184u * 11u);
+  EXPECT_EQ(c.nterms, 184u * 11u * 38u);
+
+  // Only the terms grow with LOGN, and only the inputs shrink.
+  for (size_t logn = 1; logn < kBitPluckerMaxBits; ++logn) {
+    BitPluckerCost a = bit_plucker_cost<GF2_128<>>(kMacSites[1], logn);
+    BitPluckerCost b = bit_plucker_cost<GF2_128<>>(kMacSites[1], logn + 1);
+    EXPECT_GE(a.ninputs, b.ninputs);
+    EXPECT_LE(a.nterms, b.nterms);
+    EXPECT_LE(a.depth, b.depth);
+  }
+}
+
+// Size of one instance of the component that contains a call site.
+struct ComponentSize {
+  size_t ninputs;
+  size_t nterms;
+  size_t depth;
+};
+
+template <class Field, size_t LOGN>
+ComponentSize sha_block_size(const Field& F) {
+  using CompilerBackend = CompilerBackend<Field>;
+  using LogicCircuit = Logic<Field, CompilerBackend>;
+  using v32 = typename LogicCircuit::v32;
+  using FlatSha =
+      FlatSHA256Circuit<LogicCircuit, BitPlucker<LogicCircuit, LOGN>>;
+  using packed_v32 = typename FlatSha::packed_v32;
+
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+  FlatSha sha(LC);
+
+  std::vector<v32> in(16);
+  for (size_t i = 0; i < 16; ++i) {
+    in[i] = LC.template vinput<32>();
+  }
+  std::vector<packed_v32> h0(8), h1(8), outw(48), oute(64), outa(64);
+  for (size_t i = 0; i < 8; ++i) {
+    h0[i] = FlatSha::packed_input(Q);
+    h1[i] = FlatSha::packed_input(Q);
+  }
+  for (size_t i = 0; i < 48; ++i) {
+    outw[i] = FlatSha::packed_input(Q);
+  }
+  for (size_t i = 0; i < 64; ++i) {
+    oute[i] = FlatSha::packed_input(Q);
+    outa[i] = FlatSha::packed_input(Q);
+  }
+  sha.assert_transform_block(in.data(), h0.data(), outw.data(), oute.data(),
+                             outa.data(), h1.data());
+  auto circuit = Q.mkcircuit(/*nc=*/1);
+  return ComponentSize{circuit->ninputs, Q.nquad_terms_, circuit->nl};
+}
+
+template <size_t LOGN>
+ComponentSize mac_size(const Fp256Base& F) {
+  using CompilerBackend = CompilerBackend<Fp256Base>;
+  using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
+  using v128 = LogicCircuit::v128;
+  using MACCircuit = MAC<LogicCircuit, BitPlucker<LogicCircuit, LOGN>>;
+
+  QuadCircuit<Fp256Base> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+  MACCircuit mac(LC);
+
+  auto msg = Q.input();
+  v128 mv[2] = {LC.vinput<128>(), LC.vinput<128>()};
+  v128 a_v = LC.vinput<128>();
+  Q.private_input();
+  typename MACCircuit::Witness vw;
+  vw.input(LC, Q);
+  mac.verify_mac(msg, mv, a_v, vw, n256_order);
+  auto circuit = Q.mkcircuit(/*nc=*/1);
+  return ComponentSize{circuit->ninputs, Q.nquad_terms_, circuit->nl};
+}
+
+constexpr size_t kMaxCalculatorBits = 6;
+
+template <class Field>
+void sha_block_sizes(const Field& F, ComponentSize sz[]) {
+  sz[1] = sha_block_size<Field, 1>(F);
+  sz[2] = sha_block_size<Field, 2>(F);
+  sz[3] = sha_block_size<Field, 3>(F);
+  sz[4] = sha_block_size<Field, 4>(F);
+  sz[5] = sha_block_size<Field, 5>(F);
+  sz[6] = sha_block_size<Field, 6>(F);
+}
+
+void mac_sizes(const Fp256Base& F, ComponentSize sz[]) {
+  sz[1] = mac_size<1>(F);
+  sz[2] = mac_size<2>(F);
+  sz[3] = mac_size<3>(F);
+  sz[4] = mac_size<4>(F);
+  sz[5] = mac_size<5>(F);
+  sz[6] = mac_size<6>(F);
+}
+
+// Prover cost, in the units of the model, of NINST instances of the
+// compiled component, with the actual Ligero layout of the witness.
+template <class Field>
+uint64_t compiled_cost(const ComponentSize& sz, size_t ninst) {
+  LigeroParam<Field> p(ninst * sz.ninputs, sz.depth, /*rateinv=*/4,
+                       /*nreq=*/128);
+  return ninst * sz.nterms + bit_plucker_encoded_weight<Field>() *
+                                 static_cast<uint64_t>(p.nrow) * p.block_enc;
+}
+
+// Evaluates every packing density for NINST instances of a component,
+// and returns the LOGN of least compiled cost.
+template <class Field, size_t K>
+size_t evaluate_site(const char* name, const ComponentSize sz[],
+                     const BitPluckerSite (&sites)[K], size_t ninst,
+                     size_t current) {
+  BitPluckerSite all[K];
+  for (size_t i = 0; i < K; ++i) {
+    all[i] = BitPluckerSite{sites[i].group_bits, ninst * sites[i].ngroups};
+  }
+
+  log(INFO, "%s, %zu instances, current LOGN %zu", name, ninst, current);
+  log(INFO, "  LOGN   inputs      terms  depth   compiled      model");
+  size_t best = 1;
+  for (size_t logn = 1; logn <= kMaxCalculatorBits; ++logn) {
+    uint64_t c = compiled_cost<Field>(sz[logn], ninst);
+    if (c < compiled_cost<Field>(sz[best], ninst)) {
+      best = logn;
+    }
+    log(INFO, "  %4zu %8zu %10zu %6zu %10llu %10llu", logn,
+        ninst * sz[logn].ninputs, ninst * sz[logn].nterms, sz[logn].depth,
+        (unsigned long long)c,
+        (unsigned long long)bit_plucker_prover_cost<Field>(all, logn));
+  }
+  size_t model = bit_plucker_optimal_bits<Field>(all, kMaxCalculatorBits);
+  log(INFO, "  optimal LOGN: compiled %zu, model %zu", best, model);
+
+  // The choice of the model is within 10% of the best choice.
+  EXPECT_LE(10 * compiled_cost<Field>(sz[model], ninst),
+            11 * compiled_cost<Field>(sz[best], ninst))
+      << name;
+  return best;
+}
+
+// Reports the optimal packing density of each circuit family.  The
+// instance counts are those of the largest circuits of each family.
+TEST(BitPluckerCost, Calculator) {
+  set_log_level(INFO);
+  const GF2_128<> gf;
+  ComponentSize sha_gf2[kMaxCalculatorBits + 1];
+  ComponentSize sha_p256[kMaxCalculatorBits + 1];
+  ComponentSize mac[kMaxCalculatorBits + 1];
+  sha_block_sizes(gf, sha_gf2);
+  sha_block_sizes(p256_base, sha_p256);
+  mac_sizes(p256_base, mac);
+
+  evaluate_site<GF2_128<>>("mdoc hash SHA-256, GF(2^128)", sha_gf2,
+                           kShaBlockSites, /*ninst=*/35, /*current=*/4);
+  evaluate_site<Fp256Base>("JWT SHA-256, P-256", sha_p256, kShaBlockSites,
+                           /*ninst=*/8, /*current=*/4);
+  evaluate_site<Fp256Base>("mdoc_1f and anoncred SHA-256, P-256", sha_p256,
+                           kShaBlockSites, /*ninst=*/7, /*current=*/3);
+  evaluate_site<Fp256Base>("mdoc revocation SHA-256, P-256", sha_p256,
+                           kShaBlockSites, /*ninst=*/2, /*current=*/4);
+  evaluate_site<Fp256Base>("mdoc signature MAC, P-256", mac, kMacSites,
+                           /*ninst=*/3, /*current=*/2);
+}
+
+}  // namespace
+}  // namespace proofs
@@ -25,10 +25,11 @@
 namespace proofs {
 template <class Field, size_t LOGN>
 class BitPluckerEncoder {
-  const Field& f_;
-
   using Elt = typename Field::Elt;
   static constexpr size_t kN = size_t(1) << LOGN;
+
+  const Field& f_;
+  std::array<Elt, kN> tbl_;
   static constexpr size_t kNv32Elts = (32u + LOGN - 1u) / LOGN;
   static constexpr size_t kNv128Elts = (128u + LOGN - 1u) / LOGN;
   static constexpr size_t kNv256Elts = (256u + LOGN - 1u) / LOGN;
@@ -38,9 +39,17 @@ class BitPluckerEncoder {
   using packed_v128 = std::array<Elt, kNv128Elts>;
   using packed_v256 = std::array<Elt, kNv256Elts>;
 
-  explicit BitPluckerEncoder(const Field& F) : f_(F) {}
+  // The kN encodings are tabulated once, since each one costs two field
+  // conversions and the packers below encode every LOGN bits.
+  explicit BitPluckerEncoder(const Field& F) : f_(F) {
+    for (size_t i = 0; i < kN; ++i) {
+      tbl_[i] = bit_plucker_point<Field, kN>()(i, f_);
+    }
+  }
 
-  Elt encode(size_t i) const { return bit_plucker_point<Field, kN>()(i, f_); }
+  Elt encode(size_t i) const {
+    return i < kN ? tbl_[i] : bit_plucker_point<Field, kN>()(i, f_);
+  }
 
   // Special case packer for uint32_t used in sha256.
   packed_v32 mkpacked_v32(uint32_t j) {
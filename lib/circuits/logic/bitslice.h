@@ -0,0 +1,166 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BITSLICE_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BITSLICE_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <cstdint>
+
+#include "circuits/logic/evaluation_backend.h"
+#include "gf2k/gf2_128.h"
+#include "util/panic.h"
+
+namespace proofs {
+
+// Bit-sliced evaluation of boolean circuits.
+//
+// BitsliceField<kWords> is the ring GF(2)^kLanes, i.e., kLanes
+// independent copies of GF(2) packed into machine words, where
+// addition is XOR and multiplication is AND.  It exports the subset of
+// the Field interface used by Logic and EvaluationBackend, so that
+//
+//    Logic<BitsliceField<W>, BitsliceBackend<W>>
+//
+// evaluates a boolean gadget on kLanes independent instances at once,
+// with each land/lxor/lor costing a few word operations for all the
+// instances.  Lane i holds instance i, and the constants of Logic
+// (bit(0), bit(1), vbit<N>(x), ...) are broadcast to all lanes.
+//
+// The ring is not a field: only the all-ones element is invertible, and
+// there are no elements beyond 0 and 1 in each lane.  Thus only the
+// boolean part of Logic is supported.  Gadgets that encode several bits
+// in one field element, such as as_scalar(), Counter, BitAdder, or
+// BitPlucker, are not.  An assertion fails if it fails in any lane;
+// evaluate the asserted value to find out which lanes fail.
+template <size_t kWords>
+class BitsliceField {
+ public:
+  using TypeTag = BinaryFieldTypeTag;
+  static constexpr size_t kLanes = 64 * kWords;
+  static constexpr bool kCharacteristicTwo = true;
+
+  struct Elt {
+    std::array<uint64_t, kWords> w;
+
+    Elt() : w{} {}
+
+    bool operator==(const Elt& y) const { return w == y.w; }
+    bool operator!=(const Elt& y) const { return !operator==(y); }
+
+    // Value of lane I.
+    bool lane(size_t i) const { return (w[i / 64] >> (i % 64)) & 1; }
+
+    void set_lane(size_t i, bool b) {
+      uint64_t m = uint64_t(1) << (i % 64);
+      w[i / 64] = b ? (w[i / 64] | m) : (w[i / 64] & ~m);
+    }
+  };
+
+  BitsliceField() {
+    for (size_t i = 0; i < kWords; ++i) {
+      k_[1].w[i] = ~uint64_t(0);
+    }
+  }
+
+  BitsliceField(const BitsliceField&) = delete;
+  BitsliceField& operator=(const BitsliceField&) = delete;
+
+  Elt addf(const Elt& a, const Elt& b) const {
+    Elt r;
+    for (size_t i = 0; i < kWords; ++i) {
+      r.w[i] = a.w[i] ^ b.w[i];
+    }
+    return r;
+  }
+  Elt subf(const Elt& a, const Elt& b) const { return addf(a, b); }
+  Elt mulf(const Elt& a, const Elt& b) const {
+    Elt r;
+    for (size_t i = 0; i < kWords; ++i) {
+      r.w[i] = a.w[i] & b.w[i];
+    }
+    return r;
+  }
+  Elt negf(const Elt& a) const { return a; }
+  Elt invertf(const Elt& a) const {
+    check(a == one(), "invertf of a non-unit in BitsliceField");
+    return a;
+  }
+
+  const Elt& zero() const { return k_[0]; }
+  const Elt& one() const { return k_[1]; }
+  const Elt& mone() const { return k_[1]; }
+  const Elt& two() const { return k_[0]; }
+
+  // The scalar A mod 2, broadcast to all lanes.
+  Elt of_scalar(uint64_t a) const { return k_[a & 1]; }
+
+  // Only beta(0) = 1 exists in GF(2).
+  Elt beta(size_t i) const {
+    check(i == 0, "BitsliceField has no beta(i) for i > 0");
+    return one();
+  }
+
+  // The element whose lane i is bit I of X[i], for 0 <= i < kLanes.
+  Elt of_lanes(const uint64_t x[/*kLanes*/], size_t bit) const {
+    Elt r;
+    for (size_t i = 0; i < kLanes; ++i) {
+      r.w[i / 64] |= ((x[i] >> bit) & 1) << (i % 64);
+    }
+    return r;
+  }
+
+ private:
+  Elt k_[2];  // broadcast 0 and 1
+};
+
+template <size_t kWords>
+using BitsliceBackend = EvaluationBackend<BitsliceField<kWords>>;
+
+// Transpose kLanes N-bit values X[] into one bitvec whose bit j holds
+// bit j of every value, lane i corresponding to X[i].
+template <class Logic, size_t N>
+typename Logic::template bitvec<N> bitslice_vinput(const Logic& L,
+                                                   const uint64_t x[]) {
+  static_assert(N <= 64);
+  typename Logic::template bitvec<N> r;
+  for (size_t j = 0; j < N; ++j) {
+    r[j] = typename Logic::BitW(L.konst(L.f_.of_lanes(x, j)), L.f_);
+  }
+  return r;
+}
+
+// Inverse of bitslice_vinput(): store the value of lane i of A into X[i].
+template <class Logic, size_t N>
+void bitslice_voutput(const Logic& L,
+                      const typename Logic::template bitvec<N>& a,
+                      uint64_t x[]) {
+  static_assert(N <= 64);
+  constexpr size_t kLanes = Logic::Field::kLanes;
+  for (size_t i = 0; i < kLanes; ++i) {
+    x[i] = 0;
+  }
+  for (size_t j = 0; j < N; ++j) {
+    auto e = L.eval(a[j]).elt();
+    for (size_t i = 0; i < kLanes; ++i) {
+      x[i] |= uint64_t(e.lane(i)) << j;
+    }
+  }
+}
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_LOGIC_BITSLICE_H_
@@ -0,0 +1,309 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "circuits/logic/bitslice.h"
+
+#include <stddef.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "circuits/base64/decode.h"
+#include "circuits/logic/evaluation_backend.h"
+#include "circuits/logic/logic.h"
+#include "circuits/sha/sha256_constants.h"
+#include "gf2k/gf2_128.h"
+#include "util/crypto.h"
+#include "gtest/gtest.h"
+
+namespace proofs {
+namespace {
+
+constexpr uint32_t kIV[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+// One SHA-256 compression written with the boolean operations of Logic.
+template <class Logic>
+void sha256_compress(const Logic& L, typename Logic::v32 H[8],
+                     const typename Logic::v32 in[16]) {
+  using v32 = typename Logic::v32;
+  std::vector<v32> w(64);
+  for (size_t i = 0; i < 16; ++i) {
+    w[i] = in[i];
+  }
+  for (size_t i = 16; i < 64; ++i) {
+    auto a0 = L.vrotr(w[i - 15], 7);
+    auto b0 = L.vrotr(w[i - 15], 18);
+    auto s0 = L.vxor3(&a0, &b0, L.vshr(w[i - 15], 3));
+    auto a1 = L.vrotr(w[i - 2], 17);
+    auto b1 = L.vrotr(w[i - 2], 19);
+    auto s1 = L.vxor3(&a1, &b1, L.vshr(w[i - 2], 10));
+    auto t = L.vadd(w[i - 16], s0);
+    t = L.vadd(t, w[i - 7]);
+    w[i] = L.vadd(t, s1);
+  }
+
+  v32 v[8];
+  for (size_t i = 0; i < 8; ++i) {
+    v[i] = H[i];
+  }
+  for (size_t r = 0; r < 64; ++r) {
+    auto e6 = L.vrotr(v[4], 6);
+    auto e11 = L.vrotr(v[4], 11);
+    auto S1 = L.vxor3(&e6, &e11, L.vrotr(v[4], 25));
+    auto ch = L.vCh(&v[4], &v[5], v[6]);
+    auto t1 = L.vadd(v[7], S1);
+    t1 = L.vadd(t1, ch);
+    t1 = L.vadd(t1, kSha256Round[r]);
+    t1 = L.vadd(t1, w[r]);
+    auto a2 = L.vrotr(v[0], 2);
+    auto a13 = L.vrotr(v[0], 13);
+    auto S0 = L.vxor3(&a2, &a13, L.vrotr(v[0], 22));
+    auto t2 = L.vadd(S0, L.vMaj(&v[0], &v[1], v[2]));
+    for (size_t i = 7; i > 0; --i) {
+      v[i] = v[i - 1];
+    }
+    v[4] = L.vadd(v[4], t1);
+    v[0] = L.vadd(t1, t2);
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    H[i] = L.vadd(H[i], v[i]);
+  }
+}
+
+// The padded SHA-256 block of a 55-byte message, as 16 big-endian words.
+void one_block(const uint8_t msg[55], uint64_t w[16]) {
+  uint8_t block[64] = {};
+  memcpy(block, msg, 55);
+  block[55] = 0x80;
+  block[62] = (55 * 8) >> 8;
+  block[63] = (55 * 8) & 0xff;
+  for (size_t i = 0; i < 16; ++i) {
+    w[i] = (uint64_t(block[4 * i]) << 24) | (uint64_t(block[4 * i + 1]) << 16) |
+           (uint64_t(block[4 * i + 2]) << 8) | uint64_t(block[4 * i + 3]);
+  }
+}
+
+template <size_t kWords>
+void test_sha256(uint32_t seed) {
+  using Field = BitsliceField<kWords>;
+  using Logic = Logic<Field, BitsliceBackend<kWords>>;
+  constexpr size_t kLanes = Field::kLanes;
+  const Field F;
+  const BitsliceBackend<kWords> ebk(F);
+  const Logic L(&ebk, F);
+
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> msg(kLanes * 55);
+  for (auto& b : msg) {
+    b = rng();
+  }
+  std::vector<uint64_t> words(16 * kLanes), x(kLanes);
+  for (size_t l = 0; l < kLanes; ++l) {
+    uint64_t w[16];
+    one_block(&msg[55 * l], w);
+    for (size_t i = 0; i < 16; ++i) {
+      words[i * kLanes + l] = w[i];
+    }
+  }
+
+  typename Logic::v32 in[16], H[8];
+  for (size_t i = 0; i < 16; ++i) {
+    in[i] = bitslice_vinput<Logic, 32>(L, &words[i * kLanes]);
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    H[i] = L.template vbit<32>(kIV[i]);
+  }
+  sha256_compress(L, H, in);
+
+  for (size_t i = 0; i < 8; ++i) {
+    bitslice_voutput<Logic, 32>(L, H[i], x.data());
+    for (size_t l = 0; l < kLanes; ++l) {
+      uint8_t digest[kSHA256DigestSize];
+      SHA256 sha;
+      sha.Update(&msg[55 * l], 55);
+      sha.DigestData(digest);
+      uint64_t want = (uint64_t(digest[4 * i]) << 24) |
+                      (uint64_t(digest[4 * i + 1]) << 16) |
+                      (uint64_t(digest[4 * i + 2]) << 8) | digest[4 * i + 3];
+      EXPECT_EQ(x[l], want);
+    }
+  }
+}
+
+TEST(Bitslice, Sha256) {
+  test_sha256<1>(1);
+  test_sha256<4>(2);
+}
+
+template <size_t kWords>
+void test_ops() {
+  using Field = BitsliceField<kWords>;
+  using Logic = Logic<Field, BitsliceBackend<kWords>>;
+  constexpr size_t kLanes = Field::kLanes;
+  const Field F;
+  const BitsliceBackend<kWords> ebk(F);
+  const Logic L(&ebk, F);
+
+  std::mt19937_64 rng(kWords);
+  std::vector<uint64_t> a(kLanes), b(kLanes), x(kLanes);
+  for (size_t l = 0; l < kLanes; ++l) {
+    a[l] = rng() & 0xffff;
+    // make some lanes equal
+    b[l] = (l % 5 == 0) ? a[l] : (rng() & 0xffff);
+  }
+  auto va = bitslice_vinput<Logic, 16>(L, a.data());
+  auto vb = bitslice_vinput<Logic, 16>(L, b.data());
+
+  bitslice_voutput<Logic, 16>(L, L.vadd(va, vb), x.data());
+  for (size_t l = 0; l < kLanes; ++l) {
+    EXPECT_EQ(x[l], (a[l] + b[l]) & 0xffff);
+  }
+  bitslice_voutput<Logic, 16>(L, L.vor(&va, vb), x.data());
+  for (size_t l = 0; l < kLanes; ++l) {
+    EXPECT_EQ(x[l], a[l] | b[l]);
+  }
+  bitslice_voutput<Logic, 16>(L, L.vrotr(va, 3), x.data());
+  for (size_t l = 0; l < kLanes; ++l) {
+    EXPECT_EQ(x[l], ((a[l] >> 3) | (a[l] << 13)) & 0xffff);
+  }
+
+  typename Logic::v1 lt, eq;
+  lt[0] = L.vlt(&va, vb);
+  eq[0] = L.veq(va, vb);
+  std::vector<uint64_t> xlt(kLanes), xeq(kLanes);
+  bitslice_voutput<Logic, 1>(L, lt, xlt.data());
+  bitslice_voutput<Logic, 1>(L, eq, xeq.data());
+  for (size_t l = 0; l < kLanes; ++l) {
+    EXPECT_EQ(xlt[l], a[l] < b[l]);
+    EXPECT_EQ(xeq[l], a[l] == b[l]);
+  }
+}
+
+TEST(Bitslice, Ops) {
+  test_ops<1>();
+  test_ops<2>();
+}
+
+// Decode all 256 byte values at once, one per lane.
+TEST(Bitslice, Base64Symbols) {
+  using Field = BitsliceField<4>;
+  using Logic = Logic<Field, BitsliceBackend<4>>;
+  const Field F;
+  const BitsliceBackend<4> ebk(F, false);
+  const Logic L(&ebk, F);
+  const Base64Decoder<Logic> bd(L);
+  const char alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+  std::vector<uint64_t> c(256), x(256), bad(256);
+  for (size_t l = 0; l < 256; ++l) {
+    c[l] = l;
+  }
+  auto in = bitslice_vinput<Logic, 8>(L, c.data());
+  Logic::template bitvec<6> out;
+  Logic::v1 invalid;
+  bd.decode(in, out, invalid[0]);
+  bitslice_voutput<Logic, 6>(L, out, x.data());
+  bitslice_voutput<Logic, 1>(L, invalid, bad.data());
+  for (size_t l = 0; l < 256; ++l) {
+    const char* p = (l == 0) ? nullptr : strchr(alphabet, static_cast<int>(l));
+    EXPECT_EQ(bad[l], p == nullptr);
+    if (p != nullptr) {
+      EXPECT_EQ(x[l], static_cast<uint64_t>(p - alphabet));
+    }
+  }
+
+  // The assertion fails when any lane is invalid.
+  bd.decode(in, out);
+  EXPECT_TRUE(ebk.assertion_failed());
+  for (size_t l = 0; l < 256; ++l) {
+    c[l] = alphabet[l % 64];
+  }
+  bd.decode(bitslice_vinput<Logic, 8>(L, c.data()), out);
+  EXPECT_FALSE(ebk.assertion_failed());
+}
+
+// SHA-256 compressions of KLANES messages, one at a time in GF(2^128)
+// with non-constant inputs, versus all at once in bit-sliced form.
+void BM_Sha256Compress_GF2_128(benchmark::State& state) {
+  using Field = GF2_128<>;
+  using Logic = Logic<Field, EvaluationBackend<Field>>;
+  const Field F;
+  const EvaluationBackend<Field> ebk(F);
+  const Logic L(&ebk, F);
+  uint64_t w[16];
+  uint8_t msg[55] = {};
+  one_block(msg, w);
+
+  for (auto s : state) {
+    Logic::v32 in[16], H[8];
+    for (size_t i = 0; i < 16; ++i) {
+      for (size_t j = 0; j < 32; ++j) {
+        in[i][j] = Logic::BitW(L.konst(L.elt((w[i] >> j) & 1)), F);
+      }
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      H[i] = L.vbit<32>(kIV[i]);
+    }
+    sha256_compress(L, H, in);
+    benchmark::DoNotOptimize(H);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sha256Compress_GF2_128);
+
+template <size_t kWords>
+void bm_sha256_bitslice(benchmark::State& state) {
+  using Field = BitsliceField<kWords>;
+  using Logic = Logic<Field, BitsliceBackend<kWords>>;
+  constexpr size_t kLanes = Field::kLanes;
+  const Field F;
+  const BitsliceBackend<kWords> ebk(F);
+  const Logic L(&ebk, F);
+  std::vector<uint64_t> words(16 * kLanes);
+  std::mt19937_64 rng(1);
+  for (auto& x : words) {
+    x = rng() & 0xffffffff;
+  }
+
+  for (auto s : state) {
+    typename Logic::v32 in[16], H[8];
+    for (size_t i = 0; i < 16; ++i) {
+      in[i] = bitslice_vinput<Logic, 32>(L, &words[i * kLanes]);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      H[i] = L.template vbit<32>(kIV[i]);
+    }
+    sha256_compress(L, H, in);
+    benchmark::DoNotOptimize(H);
+  }
+  state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+void BM_Sha256Compress_Bitslice64(benchmark::State& state) {
+  bm_sha256_bitslice<1>(state);
+}
+BENCHMARK(BM_Sha256Compress_Bitslice64);
+
+void BM_Sha256Compress_Bitslice256(benchmark::State& state) {
+  bm_sha256_bitslice<4>(state);
+}
+BENCHMARK(BM_Sha256Compress_Bitslice256);
+
+}  // namespace
+}  // namespace proofs
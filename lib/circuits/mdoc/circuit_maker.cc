@@ -71,6 +71,30 @@ size_t optimize(LigeroParam &lp) {
   return best_block_enc;
 }
 
+// Conjectured soundness of kLigeroNreq opened columns.  With
+// proof-of-work grinding, fewer columns give the same soundness.
+constexpr size_t kLigeroSoundnessBits = 86;
+
+// Print the savings of proof-of-work grinding for a circuit with NW
+// committed witnesses and NQ quadratic constraints, at the conjectured
+// soundness of kLigeroNreq columns.
+template <class Field>
+void print_grinding(const char* name, size_t nw, size_t nq) {
+  const proofs::LigeroColumnCost base = proofs::ligero_column_cost<Field>(
+      nw, nq, kLigeroRate, kLigeroNreq, kLigeroSoundnessBits, 0);
+  for (size_t g : {0, 8, 12, 16, 20, 24}) {
+    proofs::LigeroColumnCost c = proofs::ligero_column_cost<Field>(
+        nw, nq, kLigeroRate, kLigeroNreq, kLigeroSoundnessBits, g);
+    std::cout << "  " << name << " grind_bits:" << g << " nreq:" << c.nreq
+              << " sz:" << c.proof_bytes << " ("
+              << 100.0 * (1.0 - double(c.proof_bytes) / base.proof_bytes)
+              << "% smaller) verifier column elts:" << c.column_elts << " ("
+              << 100.0 * (1.0 - double(c.column_elts) / base.column_elts)
+              << "% fewer) merkle hashes:" << c.merkle_hashes
+              << " prover hashes:" << c.grind_hashes << std::endl;
+  }
+}
+
 // Decompress and parse the circuit bytes, optimize the Ligero
 // commitment parameters and print a ZkSpecStruct entry.
 void optimize_params(const uint8_t* circuit_bytes, size_t circuit_len,
@@ -130,6 +154,16 @@ void optimize_params(const uint8_t* circuit_bytes, size_t circuit_len,
   std::cout << "   sig   best parameters: be:" << sig_best_block_enc
             << " sz:" << min_proof_size << std::endl;
 
+  print_grinding<f_128>("hash",
+                        (c_hash->ninputs - c_hash->npub_in) +
+                            proofs::ZkCommon<f_128>::pad_size(*c_hash),
+                        c_hash->nl);
+  print_grinding<proofs::Fp256Base>(
+      " sig",
+      (c_sig->ninputs - c_sig->npub_in) +
+          proofs::ZkCommon<proofs::Fp256Base>::pad_size(*c_sig),
+      c_sig->nl);
+
   std::cout << "{" << zk_spec->system << "\"" << circuit_id_hex << "\", "
             << zk_spec->num_attributes << ", " << zk_spec->version << ", "
             << best_block_enc << ", " << sig_best_block_enc << "},"
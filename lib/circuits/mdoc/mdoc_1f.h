@@ -45,11 +45,12 @@ class mdoc_1f {
   using Flatsha =
       FlatSHA256Circuit<LogicCircuit,
                         BitPlucker<LogicCircuit, kMdoc1SHAPluckerBits>>;
-  using Routing = Routing<LogicCircuit>;
+  using Routing = proofs::Routing<LogicCircuit>;
   using ShaBlockWitness = typename Flatsha::BlockWitness;
   using sha_packed_v32 = typename Flatsha::packed_v32;
-  using Cbor = Cbor<LogicCircuit, kMdoc1CborIndexBits>;
+  using Cbor = proofs::Cbor<LogicCircuit, kMdoc1CborIndexBits>;
   using vind = typename Cbor::vindex;
+  using dind = typename Cbor::decoded_index;
 
   const LogicCircuit& lc_;
   const EC& ec_;
@@ -188,8 +189,16 @@ class mdoc_1f {
     }
   };
 
+  // A CborIndex whose key and value positions have been decoded
+  // once by Cbor::decode_index(), so that all the lookups at these
+  // positions share the decoding.
+  struct DecodedCborIndex {
+    dind k, v;
+    vind ndx;
+  };
+
   struct PathEntry {
-    CborIndex ind;
+    const DecodedCborIndex& ind;
     size_t l;
     const uint8_t* name;
   };
@@ -205,8 +214,9 @@ class mdoc_1f {
     ecc.verify_signature3(pkX, pkY, vw.e_, vw.sig_);
     ecc.verify_signature3(vw.dpkx_, vw.dpky_, hash_tr, vw.dpk_sig_);
 
-    sha_.assert_message_with_prefix(kMdoc1MaxSHABlocks, vw.nb_, vw.in_,
-                                    kCose1Prefix, kCose1PrefixLen, vw.sig_sha_);
+    sha_.assert_message_with_prefix_enabled(kMdoc1MaxSHABlocks, vw.nb_,
+                                            vw.in_, kCose1Prefix,
+                                            kCose1PrefixLen, vw.sig_sha_);
     // Verify that the hash of the mdoc is equal to e.
     assert_hash(vw.e_, vw);
 
@@ -231,41 +241,47 @@ class mdoc_1f {
     cbor_.assert_input_starts_at(kMdoc1MaxMsoLen, vw.prepad_, vw.mso_len_,
                                  dsC.data());
 
+    // Decode every index into the MSO once.
+    const dind root = cbor_.decode_index(kMdoc1MaxMsoLen, vw.prepad_);
+    const DecodedCborIndex valid = decode(vw.valid_),
+                           valid_from = decode(vw.valid_from_),
+                           valid_until = decode(vw.valid_until_),
+                           dev_key_info = decode(vw.dev_key_info_),
+                           dev_key = decode(vw.dev_key_),
+                           dev_key_pkx = decode(vw.dev_key_pkx_),
+                           dev_key_pky = decode(vw.dev_key_pky_),
+                           value_digests = decode(vw.value_digests_),
+                           org = decode(vw.org_);
+
     // Validity
-    PathEntry vk[2] = {{vw.valid_, kValidityInfoLen, kValidityInfoID},
-                       {vw.valid_from_, kValidFromLen, kValidFromID}};
-    assert_path(2, vk, vw, dsC, psC);
-    cbor_.assert_date_before_at(kMdoc1MaxMsoLen, vw.valid_from_.v, now,
+    PathEntry vk[2] = {{valid, kValidityInfoLen, kValidityInfoID},
+                       {valid_from, kValidFromLen, kValidFromID}};
+    assert_path(2, vk, root, dsC, psC);
+    cbor_.assert_date_before_at(kMdoc1MaxMsoLen, valid_from.v, now,
                                 dsC.data());
 
     // validUntil is a key in validityInfo.
-    cbor_.assert_map_entry(kMdoc1MaxMsoLen, vw.valid_.v, 1, vw.valid_until_.k,
-                           vw.valid_until_.v, vw.valid_until_.ndx, dsC.data(),
-                           psC.data());
-    cbor_.assert_text_at(kMdoc1MaxMsoLen, vw.valid_until_.k, kValidUntilLen,
+    assert_map_entry(valid.v, 1, valid_until, dsC, psC);
+    cbor_.assert_text_at(kMdoc1MaxMsoLen, valid_until.k, kValidUntilLen,
                          kValidUntilID, dsC.data());
-    cbor_.assert_date_after_at(kMdoc1MaxMsoLen, vw.valid_until_.v, now,
+    cbor_.assert_date_after_at(kMdoc1MaxMsoLen, valid_until.v, now,
                                dsC.data());
 
-    PathEntry dk[2] = {{vw.dev_key_info_, kDeviceKeyInfoLen, kDeviceKeyInfoID},
-                       {vw.dev_key_, kDeviceKeyLen, kDeviceKeyID}};
-    assert_path(2, dk, vw, dsC, psC);
-    cbor_.assert_map_entry(kMdoc1MaxMsoLen, vw.dev_key_.v, 2, vw.dev_key_pkx_.k,
-                           vw.dev_key_pkx_.v, vw.dev_key_pkx_.ndx, dsC.data(),
-                           psC.data());
-    cbor_.assert_map_entry(kMdoc1MaxMsoLen, vw.dev_key_.v, 2, vw.dev_key_pky_.k,
-                           vw.dev_key_pky_.v, vw.dev_key_pky_.ndx, dsC.data(),
-                           psC.data());
-    cbor_.assert_negative_at(kMdoc1MaxMsoLen, vw.dev_key_pkx_.k, 1, dsC.data());
-    cbor_.assert_negative_at(kMdoc1MaxMsoLen, vw.dev_key_pky_.k, 2, dsC.data());
+    PathEntry dk[2] = {{dev_key_info, kDeviceKeyInfoLen, kDeviceKeyInfoID},
+                       {dev_key, kDeviceKeyLen, kDeviceKeyID}};
+    assert_path(2, dk, root, dsC, psC);
+    assert_map_entry(dev_key.v, 2, dev_key_pkx, dsC, psC);
+    assert_map_entry(dev_key.v, 2, dev_key_pky, dsC, psC);
+    cbor_.assert_negative_at(kMdoc1MaxMsoLen, dev_key_pkx.k, 1, dsC.data());
+    cbor_.assert_negative_at(kMdoc1MaxMsoLen, dev_key_pky.k, 2, dsC.data());
     assert_elt_as_be_bytes_at(kMdoc1MaxMsoLen, vw.dev_key_pkx_.v, 32, vw.dpkx_,
                               dsC.data());
     assert_elt_as_be_bytes_at(kMdoc1MaxMsoLen, vw.dev_key_pky_.v, 32, vw.dpky_,
                               dsC.data());
     // Attributes parsing
-    PathEntry ak[2] = {{vw.value_digests_, kValueDigestsLen, kValueDigestsID},
-                       {vw.org_, kOrgLen, kOrgID}};
-    assert_path(2, ak, vw, dsC, psC);
+    PathEntry ak[2] = {{value_digests, kValueDigestsLen, kValueDigestsID},
+                       {org, kOrgLen, kOrgID}};
+    assert_path(2, ak, root, dsC, psC);
 
     // Attributes: Equality of hash with MSO value
     for (size_t ai = 0; ai < vw.num_attr_; ++ai) {
@@ -275,9 +291,7 @@ class mdoc_1f {
                           vw.attr_sha_[ai].data());
 
       // Check the hash matches the value in the signed MSO.
-      cbor_.assert_map_entry(kMdoc1MaxMsoLen, vw.org_.v, 2, vw.attr_mso_[ai].k,
-                             vw.attr_mso_[ai].v, vw.attr_mso_[ai].ndx,
-                             dsC.data(), psC.data());
+      assert_map_entry(org.v, 2, decode(vw.attr_mso_[ai]), dsC, psC);
       EltW h = repack32(vw.attr_sha_[ai][1].h1);
       assert_elt_as_be_bytes_at(kMdoc1MaxMsoLen, vw.attr_mso_[ai].v, 32, h,
                                 dsC.data());
@@ -343,16 +357,30 @@ class mdoc_1f {
     }
   }
 
-  void assert_path(size_t len, PathEntry p[], const Witness& vw,
-                   std::vector<typename Cbor::decode>& dsC,
-                   std::vector<typename Cbor::parse_output>& psC) const {
-    vind start = vw.prepad_;
+  DecodedCborIndex decode(const CborIndex& ci) const {
+    return DecodedCborIndex{cbor_.decode_index(kMdoc1MaxMsoLen, ci.k),
+                            cbor_.decode_index(kMdoc1MaxMsoLen, ci.v), ci.ndx};
+  }
+
+  // "M is a map at LEVEL, and IND is one of its entries"
+  void assert_map_entry(const dind& m, size_t level,
+                        const DecodedCborIndex& ind,
+                        const std::vector<typename Cbor::decode>& dsC,
+                        const std::vector<typename Cbor::parse_output>& psC)
+      const {
+    cbor_.assert_map_entry(kMdoc1MaxMsoLen, m, level, ind.k, ind.v, ind.ndx,
+                           dsC.data(), psC.data());
+  }
+
+  void assert_path(size_t len, const PathEntry p[], const dind& root,
+                   const std::vector<typename Cbor::decode>& dsC,
+                   const std::vector<typename Cbor::parse_output>& psC) const {
+    const dind* start = &root;
     for (size_t i = 0; i < len; ++i) {
-      cbor_.assert_map_entry(kMdoc1MaxMsoLen, start, i, p[i].ind.k, p[i].ind.v,
-                             p[i].ind.ndx, dsC.data(), psC.data());
+      assert_map_entry(*start, i, p[i].ind, dsC, psC);
       cbor_.assert_text_at(kMdoc1MaxMsoLen, p[i].ind.k, p[i].l, p[i].name,
                            dsC.data());
-      start = p[i].ind.v;
+      start = &p[i].ind.v;
     }
   }
 
@@ -40,7 +40,7 @@ class mdoc_1f_witness {
   using Elt = typename Field::Elt;
   using Nat = typename Field::N;
   using EcdsaWitness = VerifyWitness3<EC, ScalarField>;
-  using CborWitness = CborWitness<Field>;
+  using CborWitness = proofs::CborWitness<Field>;
 
  public:
   const EC ec_;
@@ -212,7 +212,7 @@ class mdoc_1f_witness {
       buf.push_back(mdoc[pm_.t_mso_.pos + i]);
     }
 
-    FlatSHA256Witness::transform_and_witness_message(
+    FlatSHA256Witness::transform_and_witness_enabled_message(
         buf.size(), buf.data(), kMdoc1MaxSHABlocks, numb_, signed_bytes_, bw_);
 
     // Cbor parsing.
@@ -15,10 +15,14 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "circuits/compiler/circuit_dump.h"
@@ -34,7 +38,6 @@
 #include "ec/p256.h"
 #include "gf2k/gf2_128.h"
 #include "proto/circuit.h"
-#include "sumcheck/circuit_id.h"
 #include "util/crypto.h"
 #include "util/log.h"
 #include "zstd.h"
@@ -43,156 +46,308 @@ namespace proofs {
 
 using f_128 = GF2_128<>;
 
-extern "C" {
-/*
-API version that uses 2 circuits over different fields.
-*/
-using MdocSWw = MdocSignatureWitness<P256, Fp256Scalar>;
+namespace {
 
-CircuitGenerationErrorCode generate_circuit(const ZkSpecStruct* zk_spec,
-                                            uint8_t** cb, size_t* clen) {
-  if (zk_spec == nullptr) {
-    return CIRCUIT_GENERATION_NULL_INPUT;
-  }
+// Estimated peak memory of compiling and serializing one hash circuit,
+// which dominates the one of the signature circuit.  Measured as
+// 1.66GB for one attribute and 1.90GB for four, and rounded up.
+constexpr size_t kHashCircuitMemoryBase = size_t(1600) << 20;
+constexpr size_t kHashCircuitMemoryPerAttribute = size_t(100) << 20;
 
-  // Generator only supports the latest version of the ZKSpec for a number of
-  // attributes. Return an error if the requested version is not the latest.
-  int max_circuit_version = 0;
-  for (const ZkSpecStruct& spec : kZkSpecs) {
-    if (spec.num_attributes == zk_spec->num_attributes &&
-        spec.version > max_circuit_version) {
-      max_circuit_version = spec.version;
-    }
-  }
+size_t hash_circuit_memory(size_t number_of_attributes) {
+  return kHashCircuitMemoryBase +
+         number_of_attributes * kHashCircuitMemoryPerAttribute;
+}
 
-  if (zk_spec->version != max_circuit_version) {
-    return CIRCUIT_GENERATION_INVALID_ZK_SPEC_VERSION;
-  }
+// Appends the serialized signature circuit to BYTES.  The signature
+// circuit does not depend on the number of attributes.
+void serialize_signature_circuit(std::vector<uint8_t>& bytes) {
+  using CompilerBackend = CompilerBackend<Fp256Base>;
+  using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
+  using EltW = LogicCircuit::EltW;
+  using MACTag = LogicCircuit::v128;
+  using MdocSignature = MdocSignature<LogicCircuit, Fp256Base, P256>;
+  QuadCircuit<Fp256Base> Q(p256_base);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit lc(&cbk, p256_base);
+  MdocSignature mdoc_s(lc, p256, n256_order);
 
-  if (cb == nullptr || clen == nullptr) {
-    log(INFO, "cb or clen is null");
-    return CIRCUIT_GENERATION_NULL_INPUT;
+  EltW pkX = Q.input(), pkY = Q.input(), htr = Q.input();
+  MACTag mac[7]; /* 3 macs + av */
+  for (size_t i = 0; i < 7; ++i) {
+    mac[i] = lc.vinput<128>();
   }
+  Q.private_input();
 
-  size_t number_of_attributes = zk_spec->num_attributes;
-
-  std::vector<uint8_t> bytes;
+  // Allocate this large object on heap.
+  auto w = std::make_unique<MdocSignature::Witness>();
+  w->input(Q, lc);
+  mdoc_s.assert_signatures(pkX, pkY, htr, &mac[0], &mac[2], &mac[4], mac[6],
+                           *w);
 
-  // ======== serialize signature circuit =========================
-  {
-    using CompilerBackend = CompilerBackend<Fp256Base>;
-    using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
-    using EltW = LogicCircuit::EltW;
-    using MACTag = LogicCircuit::v128;
-    using MdocSignature = MdocSignature<LogicCircuit, Fp256Base, P256>;
-    QuadCircuit<Fp256Base> Q(p256_base);
-    const CompilerBackend cbk(&Q);
-    const LogicCircuit lc(&cbk, p256_base);
-    MdocSignature mdoc_s(lc, p256, n256_order);
+  // Serialize the layers as they are scheduled, without
+  // materializing the circuit.
+  CircuitRep<Fp256Base> cr(p256_base, P256_ID);
+  CircuitRep<Fp256Base>::LayerWriter wr(cr);
+  Q.mkcircuit(/*nc=*/1, wr);
+  dump_info("sig", Q);
+  uint8_t id[kSHA256DigestSize];
+  wr.finish(bytes, id);
+  char buf[100];
+  hex_to_str(buf, id, kSHA256DigestSize);
+  log(INFO, "sig bytes: %zu id:%s", bytes.size(), buf);
+}
 
-    EltW pkX = Q.input(), pkY = Q.input(), htr = Q.input();
-    MACTag mac[7]; /* 3 macs + av */
-    for (size_t i = 0; i < 7; ++i) {
-      mac[i] = lc.vinput<128>();
-    }
-    Q.private_input();
-
-    // Allocate this large object on heap.
-    auto w = std::make_unique<MdocSignature::Witness>();
-    w->input(Q, lc);
-    mdoc_s.assert_signatures(pkX, pkY, htr, &mac[0], &mac[2], &mac[4], mac[6],
-                             *w);
-
-    auto circ = Q.mkcircuit(/*nc=*/1);
-    dump_info("sig", Q);
-    CircuitRep<Fp256Base> cr(p256_base, P256_ID);
-    cr.to_bytes(*circ, bytes);
-    uint8_t id[kSHA256DigestSize];
-    char buf[100];
-    circuit_id<Fp256Base>(id, *circ, p256_base);
-    hex_to_str(buf, id, kSHA256DigestSize);
-    log(INFO, "sig bytes: %zu id:%s", bytes.size(), buf);
-  }
-  {
-    const f_128 Fs;
-
-    using CompilerBackend = CompilerBackend<f_128>;
-    using LogicCircuit = Logic<f_128, CompilerBackend>;
-    using v8 = LogicCircuit::v8;
-    using v256 = LogicCircuit::v256;
-    using MdocHash = MdocHash<LogicCircuit, f_128>;
-    using MacBitPlucker = BitPlucker<LogicCircuit, kMACPluckerBits>;
-    using MAC = MACGF2<CompilerBackend, MacBitPlucker>;
-    using MACWitness = typename MAC::Witness;
-    using MACTag = MAC::v128;
-
-    QuadCircuit<f_128> Q(Fs);
-    const CompilerBackend cbk(&Q);
-    const LogicCircuit lc(&cbk, Fs);
-    MAC mac_check(lc);
-
-    std::vector<MdocHash::OpenedAttribute> oa(number_of_attributes);
-    MdocHash mdoc_h(lc);
-    for (size_t ai = 0; ai < number_of_attributes; ++ai) {
-      oa[ai].input(lc);
-    }
-    v8 now[20];
-    for (size_t i = 0; i < 20; ++i) {
-      now[i] = lc.template vinput<8>();
-    }
+// Appends the serialized hash circuit for NUMBER_OF_ATTRIBUTES to BYTES.
+void serialize_hash_circuit(size_t number_of_attributes,
+                            std::vector<uint8_t>& bytes) {
+  const f_128 Fs;
 
-    MACTag mac[7]; /* 3 macs + av */
-    for (size_t i = 0; i < 7; ++i) {
-      mac[i] = Q.input();
-    }
+  using CompilerBackend = CompilerBackend<f_128>;
+  using LogicCircuit = Logic<f_128, CompilerBackend>;
+  using v8 = LogicCircuit::v8;
+  using v256 = LogicCircuit::v256;
+  using MdocHash = MdocHash<LogicCircuit, f_128>;
+  using MacBitPlucker = BitPlucker<LogicCircuit, kMACPluckerBits>;
+  using MAC = MACGF2<CompilerBackend, MacBitPlucker>;
+  using MACWitness = typename MAC::Witness;
+  using MACTag = MAC::v128;
 
-    Q.private_input();
-    v256 e = lc.template vinput<256>();
-    v256 dpkx = lc.template vinput<256>();
-    v256 dpky = lc.template vinput<256>();
+  QuadCircuit<f_128> Q(Fs);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit lc(&cbk, Fs);
+  MAC mac_check(lc);
 
-    // Allocate this large object on heap.
-    auto w = std::make_unique<MdocHash::Witness>(number_of_attributes);
-    w->input(Q, lc);
+  std::vector<MdocHash::OpenedAttribute> oa(number_of_attributes);
+  MdocHash mdoc_h(lc);
+  for (size_t ai = 0; ai < number_of_attributes; ++ai) {
+    oa[ai].input(lc);
+  }
+  v8 now[20];
+  for (size_t i = 0; i < 20; ++i) {
+    now[i] = lc.template vinput<8>();
+  }
 
-    Q.begin_full_field();
-    MACWitness macw[3]; /* MACs for e, dpkx, dpky */
-    for (size_t i = 0; i < 3; ++i) {
-      macw[i].input(lc, Q);
-    }
+  MACTag mac[7]; /* 3 macs + av */
+  for (size_t i = 0; i < 7; ++i) {
+    mac[i] = Q.input();
+  }
 
-    mdoc_h.assert_valid_hash_mdoc(oa.data(), now, e, dpkx, dpky, *w);
+  Q.private_input();
+  v256 e = lc.template vinput<256>();
+  v256 dpkx = lc.template vinput<256>();
+  v256 dpky = lc.template vinput<256>();
 
-    MACTag a_v = mac[6];
-    mac_check.verify_mac(&mac[0], a_v, e, macw[0]);
-    mac_check.verify_mac(&mac[2], a_v, dpkx, macw[1]);
-    mac_check.verify_mac(&mac[4], a_v, dpky, macw[2]);
+  // Allocate this large object on heap.
+  auto w = std::make_unique<MdocHash::Witness>(number_of_attributes);
+  w->input(Q, lc);
 
-    auto circ = Q.mkcircuit(/*nc=*/1);
-    dump_info("hash", Q);
-    CircuitRep<f_128> cr(Fs, GF2_128_ID);
-    cr.to_bytes(*circ, bytes);
-    uint8_t id[kSHA256DigestSize];
-    char buf[100];
-    circuit_id<f_128>(id, *circ, Fs);
-    hex_to_str(buf, id, kSHA256DigestSize);
-    log(INFO, "hash bytes:%zu id:%s", bytes.size(), buf);
+  Q.begin_full_field();
+  MACWitness macw[3]; /* MACs for e, dpkx, dpky */
+  for (size_t i = 0; i < 3; ++i) {
+    macw[i].input(lc, Q);
   }
 
+  mdoc_h.assert_valid_hash_mdoc(oa.data(), now, e, dpkx, dpky, *w);
+
+  MACTag a_v = mac[6];
+  mac_check.verify_mac(&mac[0], a_v, e, macw[0]);
+  mac_check.verify_mac(&mac[2], a_v, dpkx, macw[1]);
+  mac_check.verify_mac(&mac[4], a_v, dpky, macw[2]);
+
+  // Serialize the layers as they are scheduled, without
+  // materializing the circuit.
+  CircuitRep<f_128> cr(Fs, GF2_128_ID);
+  CircuitRep<f_128>::LayerWriter wr(cr);
+  Q.mkcircuit(/*nc=*/1, wr);
+  dump_info("hash", Q);
+  uint8_t id[kSHA256DigestSize];
+  wr.finish(bytes, id);
+  char buf[100];
+  hex_to_str(buf, id, kSHA256DigestSize);
+  log(INFO, "hash bytes:%zu id:%s", bytes.size(), buf);
+}
+
+// Compresses BYTES into a malloc()ed buffer CB of length CLEN.
+bool compress_circuit(const std::vector<uint8_t>& bytes, uint8_t** cb,
+                      size_t* clen) {
   size_t sz = bytes.size();
   size_t buf_size = sz / 3 + 1;
 
-  uint8_t* src = bytes.data();
   // Use an aggressive, apriori estimate on the compressed size to avoid
   // wasting memory.
   uint8_t* buf = (uint8_t*)malloc(buf_size);
+  if (buf == nullptr) {
+    return false;
+  }
 
-  size_t zl = ZSTD_compress(buf, buf_size, src, sz, 16);
+  size_t zl = ZSTD_compress(buf, buf_size, bytes.data(), sz, 16);
+  if (ZSTD_isError(zl)) {
+    free(buf);
+    return false;
+  }
   log(INFO, "zstd from %zu --> %zu", sz, zl);
   *clen = zl;
   *cb = buf;
+  return true;
+}
 
-  return CIRCUIT_GENERATION_SUCCESS;
+// Generator only supports the latest version of the ZKSpec for a number of
+// attributes. Return an error if the requested version is not the latest.
+bool is_latest_version(const ZkSpecStruct* zk_spec) {
+  int max_circuit_version = 0;
+  for (const ZkSpecStruct& spec : kZkSpecs) {
+    if (spec.num_attributes == zk_spec->num_attributes &&
+        spec.version > max_circuit_version) {
+      max_circuit_version = spec.version;
+    }
+  }
+  return zk_spec->version == max_circuit_version;
+}
+
+// Admits a job only if its memory estimate fits within the budget
+// together with the jobs in progress.  A job is always admitted when
+// no other one is in progress, so that any budget makes progress.
+class MemoryGate {
+ public:
+  explicit MemoryGate(size_t budget) : budget_(budget) {}
+
+  void acquire(size_t need) {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [&] {
+      return budget_ == 0 || in_use_ == 0 || in_use_ + need <= budget_;
+    });
+    in_use_ += need;
+  }
+
+  void release(size_t need) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      in_use_ -= need;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  size_t budget_;
+  size_t in_use_ = 0;
+  std::mutex mu_;
+  std::condition_variable cv_;
+};
+
+}  // namespace
+
+extern "C" {
+/*
+API version that uses 2 circuits over different fields.
+*/
+using MdocSWw = MdocSignatureWitness<P256, Fp256Scalar>;
+
+CircuitGenerationErrorCode generate_circuit(const ZkSpecStruct* zk_spec,
+                                            uint8_t** cb, size_t* clen) {
+  if (zk_spec == nullptr) {
+    return CIRCUIT_GENERATION_NULL_INPUT;
+  }
+  if (!is_latest_version(zk_spec)) {
+    return CIRCUIT_GENERATION_INVALID_ZK_SPEC_VERSION;
+  }
+  if (cb == nullptr || clen == nullptr) {
+    log(INFO, "cb or clen is null");
+    return CIRCUIT_GENERATION_NULL_INPUT;
+  }
+
+  // A single worker, so that the peak memory is the one of one circuit.
+  return generate_circuits(&zk_spec, 1, cb, clen, /*max_threads=*/1,
+                           /*memory_budget=*/0);
+}
+
+CircuitGenerationErrorCode generate_circuits(
+    const ZkSpecStruct* const zk_specs[], size_t nspecs, uint8_t* cb[],
+    size_t clen[], size_t max_threads, size_t memory_budget) {
+  if (zk_specs == nullptr || cb == nullptr || clen == nullptr) {
+    return CIRCUIT_GENERATION_NULL_INPUT;
+  }
+  for (size_t i = 0; i < nspecs; ++i) {
+    if (zk_specs[i] == nullptr) {
+      return CIRCUIT_GENERATION_NULL_INPUT;
+    }
+    if (!is_latest_version(zk_specs[i])) {
+      return CIRCUIT_GENERATION_INVALID_ZK_SPEC_VERSION;
+    }
+  }
+  for (size_t i = 0; i < nspecs; ++i) {
+    cb[i] = nullptr;
+    clen[i] = 0;
+  }
+  if (nspecs == 0) {
+    return CIRCUIT_GENERATION_SUCCESS;
+  }
+
+  // The signature circuit is shared by all the specs.  It is small
+  // compared to the hash circuits, so compile it first.
+  std::vector<uint8_t> sig_bytes;
+  serialize_signature_circuit(sig_bytes);
+
+  if (max_threads == 0) {
+    max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  size_t nthreads = std::min(max_threads, nspecs);
+
+  // Each worker compiles, serializes, and compresses whole circuits, so
+  // that at most one uncompressed circuit per worker is alive.
+  // An exception must not escape a worker thread, where it would call
+  // std::terminate(), so the workers turn it into an error code.
+  MemoryGate gate(memory_budget);
+  std::mutex mu;
+  size_t next = 0;
+  CircuitGenerationErrorCode err = CIRCUIT_GENERATION_SUCCESS;
+  auto worker = [&] {
+    for (;;) {
+      size_t j;
+      {
+        std::lock_guard<std::mutex> lock(mu);
+        if (next == nspecs) return;
+        j = next++;
+      }
+      size_t need = hash_circuit_memory(zk_specs[j]->num_attributes);
+      gate.acquire(need);
+      CircuitGenerationErrorCode err_j = CIRCUIT_GENERATION_SUCCESS;
+      try {
+        std::vector<uint8_t> bytes = sig_bytes;
+        serialize_hash_circuit(zk_specs[j]->num_attributes, bytes);
+        if (!compress_circuit(bytes, &cb[j], &clen[j])) {
+          err_j = CIRCUIT_GENERATION_ZLIB_FAILURE;
+        }
+      } catch (...) {
+        err_j = CIRCUIT_GENERATION_GENERAL_FAILURE;
+      }
+      gate.release(need);
+      if (err_j != CIRCUIT_GENERATION_SUCCESS) {
+        std::lock_guard<std::mutex> lock(mu);
+        if (err == CIRCUIT_GENERATION_SUCCESS) {
+          err = err_j;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < nthreads; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  if (err != CIRCUIT_GENERATION_SUCCESS) {
+    for (size_t i = 0; i < nspecs; ++i) {
+      free(cb[i]);
+      cb[i] = nullptr;
+      clen[i] = 0;
+    }
+  }
+  return err;
 }
 
 } /* extern "C" */
@@ -15,13 +15,16 @@
 #ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_MDOC_MDOC_REVOCATION_H_
 #define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_MDOC_MDOC_REVOCATION_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <vector>
 
 #include "circuits/compiler/compiler.h"
 #include "circuits/ecdsa/verify_circuit.h"
 #include "circuits/logic/bit_plucker.h"
 #include "circuits/mdoc/mdoc_revocation_constants.h"
 #include "circuits/sha/flatsha256_circuit.h"
+#include "util/panic.h"
 
 namespace proofs {
 
@@ -48,6 +51,81 @@ class MdocRevocationList {
   const LogicCircuit& lc_;
 };
 
+// A variant of the list approach for public lists.  Instead of the list
+// itself, the verifier supplies the coefficients z[0..list_size] of
+// Z(x) = Prod_i (x - list[i]), and the prover asserts that Z(id) != 0.
+// The prover supplies the powers id^j for 1 <= j <= m (baby steps) and
+// id^{m k} for 1 <= k < g (giant steps), where m and g are given by
+// revocation_polynomial_{baby,giant}_steps().  Each power is checked with
+// one multiplication, and Z(id) costs list_size + g multiplications in
+// a constant number of layers, instead of the depth log(list_size)
+// product tree of MdocRevocationList.
+template <class LogicCircuit>
+class MdocRevocationPolynomial {
+  using EltW = typename LogicCircuit::EltW;
+  using Field = typename LogicCircuit::Field;
+
+ public:
+  class Witness {
+   public:
+    std::vector<EltW> baby_;   // id^j for 1 <= j <= m
+    std::vector<EltW> giant_;  // id^{m k} for 1 <= k < g
+    EltW zinv_;
+
+    explicit Witness(size_t list_size)
+        : baby_(revocation_polynomial_baby_steps(list_size)),
+          giant_(revocation_polynomial_giant_steps(list_size) - 1) {}
+
+    void input(QuadCircuit<Field>& Q) {
+      for (auto& b : baby_) {
+        b = Q.input();
+      }
+      for (auto& g : giant_) {
+        g = Q.input();
+      }
+      zinv_ = Q.input();
+    }
+  };
+
+  explicit MdocRevocationPolynomial(const LogicCircuit& lc) : lc_(lc) {}
+
+  // Asserts that Z(id) != 0, where Z(x) = sum_i z[i] x^i has degree
+  // LIST_SIZE.
+  void assert_not_on_list(const EltW z[/*list_size + 1*/], size_t list_size,
+                          /* the witness */ EltW id, const Witness& w) const {
+    const LogicCircuit& L = lc_;  // shorthand
+    const size_t m = w.baby_.size();
+    const size_t g = w.giant_.size() + 1;
+    check(m == revocation_polynomial_baby_steps(list_size), "baby steps");
+    check(g == revocation_polynomial_giant_steps(list_size), "giant steps");
+
+    // baby_[j - 1] = id^j
+    L.assert_eq(&w.baby_[0], id);
+    for (size_t j = 1; j < m; ++j) {
+      L.assert_eq(&w.baby_[j], L.mul(&w.baby_[j - 1], id));
+    }
+    // giant_[k - 1] = id^{m k}
+    const EltW& idm = w.baby_[m - 1];
+    for (size_t k = 1; k < g; ++k) {
+      EltW prev = (k == 1) ? L.konst(L.one()) : w.giant_[k - 2];
+      L.assert_eq(&w.giant_[k - 1], L.mul(&prev, idm));
+    }
+
+    EltW zid = L.add(0, g, [&](size_t k) {
+      size_t j1 = std::min(m, list_size + 1 - m * k);
+      EltW inner = L.add(0, j1, [&](size_t j) {
+        const EltW& zi = z[m * k + j];
+        return (j == 0) ? zi : L.mul(&zi, w.baby_[j - 1]);
+      });
+      return (k == 0) ? inner : L.mul(&w.giant_[k - 1], inner);
+    });
+    EltW want_one = L.mul(&zid, w.zinv_);
+    L.assert_eq(&want_one, L.konst(L.one()));
+  }
+
+  const LogicCircuit& lc_;
+};
+
 // The second revocation approach works for larger lists. In this case, the
 // prover retrieves a witness that their credential is *not* on the revoked
 // list by presenting a signature of the span (l,r) and proving that their
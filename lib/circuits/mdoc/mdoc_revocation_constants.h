@@ -20,6 +20,21 @@ namespace proofs {
 
 static constexpr size_t kSHARevocationPluckerBits = 4u;
 
+// MdocRevocationPolynomial evaluates Z(id) = sum_i z[i] id^i, of degree
+// LIST_SIZE, as sum_k id^{m k} (sum_j z[m k + j] id^j).  This is the
+// number m of baby steps, the least m such that m * m > list_size.
+inline size_t revocation_polynomial_baby_steps(size_t list_size) {
+  size_t m = 1;
+  while (m * m <= list_size) ++m;
+  return m;
+}
+
+// The number of giant steps, the least g such that g * m > list_size.
+inline size_t revocation_polynomial_giant_steps(size_t list_size) {
+  size_t m = revocation_polynomial_baby_steps(list_size);
+  return (list_size + m) / m;
+}
+
 }  // namespace proofs
 
 #endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_MDOC_MDOC_REVOCATION_CONSTANTS_H_
@@ -119,6 +119,106 @@ TEST(mdoc, mdoc_revocation_list_test) {
       1ull << 31);
 }
 
+std::unique_ptr<Circuit<Fp256Base>> make_polynomial_circuit(size_t list_size) {
+  using CompilerBackend = CompilerBackend<Fp256Base>;
+  using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
+  using EltW = LogicCircuit::EltW;
+  using MdocRevocation = MdocRevocationPolynomial<LogicCircuit>;
+  QuadCircuit<Fp256Base> Q(p256_base);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, p256_base);
+
+  MdocRevocation mdr(LC);
+  std::vector<EltW> z(list_size + 1);
+  for (size_t i = 0; i <= list_size; ++i) {
+    z[i] = Q.input();
+  }
+
+  Q.private_input();
+  EltW id = Q.input();
+  MdocRevocation::Witness w(list_size);
+  w.input(Q);
+
+  mdr.assert_not_on_list(z.data(), list_size, id, w);
+
+  auto CIRCUIT = Q.mkcircuit(/*nc=*/1);
+  dump_info("mdoc revocation polynomial", list_size, Q);
+  return CIRCUIT;
+}
+
+TEST(mdoc, mdoc_revocation_polynomial_test) {
+  using Elt = Fp256Base::Elt;
+  set_log_level(INFO);
+
+  constexpr size_t kListSize = 1000;
+  auto CIRCUIT = make_polynomial_circuit(kListSize);
+
+  std::vector<Elt> list(kListSize);
+  SecureRandomEngine rng;
+  for (size_t i = 0; i < kListSize; ++i) {
+    list[i] = rng.elt(p256_base);
+  }
+  std::vector<Elt> z =
+      mdoc_revocation_polynomial(list.data(), kListSize, p256_base);
+
+  // A revoked id has no witness.
+  MdocRevocationPolynomialWitness<Fp256Base> w(p256_base);
+  EXPECT_FALSE(w.compute_witness(list[17], z.data(), kListSize));
+
+  Elt id = rng.elt(p256_base);
+  ASSERT_TRUE(w.compute_witness(id, z.data(), kListSize));
+
+  auto W = Dense<Fp256Base>(1, CIRCUIT->ninputs);
+  auto pub = Dense<Fp256Base>(1, CIRCUIT->npub_in);
+  DenseFiller<Fp256Base> filler(W);
+  DenseFiller<Fp256Base> pub_filler(pub);
+
+  filler.push_back(p256_base.one());
+  pub_filler.push_back(p256_base.one());
+  for (size_t i = 0; i <= kListSize; ++i) {
+    filler.push_back(z[i]);
+    pub_filler.push_back(z[i]);
+  }
+  filler.push_back(id);
+  w.fill_witness(filler);
+
+  run2_test_zk(
+      *CIRCUIT, W, pub, p256_base,
+      p256_base.of_string("1126492241464102818735004576096902583730188404304894"
+                          "08729223714171582664680802"), /* omega_x*/
+      p256_base.of_string("3170409485181534106695698552158891296990397441810793"
+                          "5446220613054416637641043"), /* omega_y */
+      1ull << 31);
+}
+
+// Compare the circuit sizes of the list and polynomial approaches.
+TEST(mdoc, mdoc_revocation_list_vs_polynomial_size) {
+  using CompilerBackend = CompilerBackend<Fp256Base>;
+  using LogicCircuit = Logic<Fp256Base, CompilerBackend>;
+  using EltW = LogicCircuit::EltW;
+  set_log_level(INFO);
+
+  for (size_t list_size : {1000, 10000, 100000}) {
+    {
+      QuadCircuit<Fp256Base> Q(p256_base);
+      const CompilerBackend cbk(&Q);
+      const LogicCircuit LC(&cbk, p256_base);
+      MdocRevocationList<LogicCircuit> mdr(LC);
+      std::vector<EltW> list(list_size);
+      for (size_t i = 0; i < list_size; ++i) {
+        list[i] = Q.input();
+      }
+      Q.private_input();
+      EltW id = Q.input();
+      EltW inv = Q.input();
+      mdr.assert_not_on_list(list.data(), list_size, id, inv);
+      auto CIRCUIT = Q.mkcircuit(/*nc=*/1);
+      dump_info("mdoc revocation list", list_size, Q);
+    }
+    make_polynomial_circuit(list_size);
+  }
+}
+
 typedef struct {
   StaticString pkx, pky; /* public key of the crl issuer */
   StaticString left, right;
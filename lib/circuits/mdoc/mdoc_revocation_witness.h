@@ -40,6 +40,81 @@ typename Field::Elt compute_mdoc_revocation_list_witness(
   return prodinv;
 }
 
+// Coefficients z[0..list_size] of Z(x) = Prod_i (x - list[i]), as
+// expected by MdocRevocationPolynomial.  This is the quadratic schoolbook
+// product; the issuer of the list computes it once per list update.
+template <class Field>
+std::vector<typename Field::Elt> mdoc_revocation_polynomial(
+    const typename Field::Elt list[], size_t list_size, const Field& F) {
+  std::vector<typename Field::Elt> z(list_size + 1, F.zero());
+  z[0] = F.one();
+  for (size_t i = 0; i < list_size; ++i) {
+    // z := z * (x - list[i])
+    for (size_t j = i + 1; j > 0; --j) {
+      z[j] = F.subf(z[j - 1], F.mulf(z[j], list[i]));
+    }
+    z[0] = F.negf(F.mulf(z[0], list[i]));
+  }
+  return z;
+}
+
+template <class Field>
+class MdocRevocationPolynomialWitness {
+  using Elt = typename Field::Elt;
+  const Field& f_;
+
+ public:
+  std::vector<Elt> baby_;   // id^j for 1 <= j <= m
+  std::vector<Elt> giant_;  // id^{m k} for 1 <= k < g
+  Elt zinv_;
+
+  explicit MdocRevocationPolynomialWitness(const Field& F) : f_(F) {}
+
+  // Returns false if Z(id) = 0, i.e., if id is on the list.
+  bool compute_witness(Elt id, const Elt z[/*list_size + 1*/],
+                       size_t list_size) {
+    const Field& F = f_;  // shorthand
+    size_t m = revocation_polynomial_baby_steps(list_size);
+    size_t g = revocation_polynomial_giant_steps(list_size);
+
+    baby_.resize(m);
+    baby_[0] = id;
+    for (size_t j = 1; j < m; ++j) {
+      baby_[j] = F.mulf(baby_[j - 1], id);
+    }
+    giant_.resize(g - 1);
+    Elt gk = F.one();
+    for (size_t k = 1; k < g; ++k) {
+      gk = F.mulf(gk, baby_[m - 1]);
+      giant_[k - 1] = gk;
+    }
+
+    zinv_ = F.zero();
+    for (size_t k = 0; k < g; ++k) {
+      Elt inner = z[m * k];
+      for (size_t j = 1; j < m && m * k + j <= list_size; ++j) {
+        F.add(inner, F.mulf(z[m * k + j], baby_[j - 1]));
+      }
+      F.add(zinv_, k == 0 ? inner : F.mulf(inner, giant_[k - 1]));
+    }
+    if (zinv_ == F.zero()) {
+      return false;
+    }
+    F.invert(zinv_);
+    return true;
+  }
+
+  void fill_witness(DenseFiller<Field>& filler) const {
+    for (const Elt& b : baby_) {
+      filler.push_back(b);
+    }
+    for (const Elt& g : giant_) {
+      filler.push_back(g);
+    }
+    filler.push_back(zinv_);
+  }
+};
+
 template <class EC, class ScalarField>
 class MdocRevocationSpanWitness {
   using Field = typename EC::Field;
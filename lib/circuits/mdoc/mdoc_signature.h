@@ -34,14 +34,18 @@ namespace proofs {
 //       the signature is under a device public key that is specified in the
 //       MSO.  Thus, the signing key is private (and committed), but the
 //       message is public.
-template <class LogicCircuit, class Field, class EC>
+//
+// KECDSAWINDOW selects the VerifyCircuit window.  All ZK spec versions to
+// date use 1; a version that changes it must be paired with a
+// MdocSignatureWitness of the same window.
+template <class LogicCircuit, class Field, class EC, size_t kEcdsaWindow = 1>
 class MdocSignature {
   using EltW = typename LogicCircuit::EltW;
   using Elt = typename LogicCircuit::Elt;
   using Nat = typename Field::N;
   using v128 = typename LogicCircuit::v128;
   using v256 = typename LogicCircuit::v256;
-  using Ecdsa = VerifyCircuit<LogicCircuit, Field, EC>;
+  using Ecdsa = VerifyCircuit<LogicCircuit, Field, EC, kEcdsaWindow>;
   using EcdsaWitness = typename Ecdsa::Witness;
   using MacBitPlucker = BitPlucker<LogicCircuit, kMACPluckerBits>;
   using packed_v256 = typename MacBitPlucker::packed_v256;
@@ -25,6 +25,7 @@
 
 #include "arrays/dense.h"
 #include "cbor/host_decoder.h"
+#include "cbor/tape_decoder.h"
 #include "circuits/ecdsa/verify_witness.h"
 #include "circuits/logic/bit_plucker_encoder.h"
 #include "circuits/mac/mac_witness.h"
@@ -109,17 +110,18 @@ class ParsedMdoc {
   */
   bool parse_device_response(size_t len, const uint8_t resp[/* len */]) {
     size_t np = 0;
-    // When this object falls out of scope, all parsing objects will be
-    // garbage collected.
-    CborDoc root;
-    bool ok = root.decode(resp, len, np, 0);
+    // The tokens are owned by the tape, and all of the pointers below
+    // remain valid until the tape falls out of scope.
+    CborTape tape;
+    bool ok = tape.decode(resp, len, np, 0);
     if (!ok) {
       log(ERROR, "Failed to decode root");
       return false;
     }
+    const CborToken* root = tape.root();
 
     size_t di;
-    auto docs = root.lookup(resp, 9, (uint8_t*)"documents", di);
+    auto docs = root->lookup(resp, 9, (uint8_t*)"documents", di);
     if (docs == nullptr) return false;
     // Fields of Document are "docType", "issuerSigned", "deviceSigned", ?errors
 
@@ -148,26 +150,30 @@ class ParsedMdoc {
     auto ns = is[1].lookup(resp, 10, (uint8_t*)"nameSpaces", di);
     if (ns == nullptr) return false;
 
-    // Find the attribute witness we need from here.
+    // Find the attribute witness we need from here.  The tape of the
+    // encoded attributes is reused across attributes.
+    CborTape er_tape;
     for (const char* sn : kSupportedNamespaces) {
       auto mldns = ns[1].lookup(resp, strlen(sn), (const uint8_t*)sn, di);
       if (mldns == nullptr) continue;
-      size_t ai = 0;
-      auto tattr = mldns[1].index(ai++);
-      while (tattr != nullptr) {
-        CborDoc er;
+      const CborToken* attrs = &mldns[1];
+      size_t na = (attrs->t_ == ARRAY) ? attrs->u_.items.n : 0;
+      const CborToken* tattr = attrs + 1;
+      for (size_t ai = 0; ai < na; ++ai, tattr = tattr->next()) {
         // Decode the map in this tagged attribute.
-        size_t pos = tattr->children_[0].u_.string.pos;
-        size_t end = pos + tattr->children_[0].u_.string.len;
-        if (!er.decode(resp, end, pos, 0)) {
+        if (tattr->t_ != TAG || tattr[1].t_ != BYTES) return false;
+        size_t pos = tattr[1].u_.string.pos;
+        size_t end = pos + tattr[1].u_.string.len;
+        if (!er_tape.decode(resp, end, pos, 0)) {
           return false;
         }
+        const CborToken* er = er_tape.root();
 
-        auto ei = er.lookup(resp, 17, (uint8_t*)"elementIdentifier", di);
+        auto ei = er->lookup(resp, 17, (uint8_t*)"elementIdentifier", di);
         if (ei == nullptr) return false;
-        auto ev = er.lookup(resp, 12, (uint8_t*)"elementValue", di);
+        auto ev = er->lookup(resp, 12, (uint8_t*)"elementValue", di);
         if (ev == nullptr) return false;
-        auto digid = er.lookup(resp, 8, (uint8_t*)"digestID", di);
+        auto digid = er->lookup(resp, 8, (uint8_t*)"digestID", di);
         if (digid == nullptr) return false;
 
         attributes_.push_back((FullAttribute){
@@ -179,11 +185,8 @@ class ParsedMdoc {
             static_cast<size_t>(digid[1].u_.u64), /* digest_id */
             {0, 0, 0},                            /* default mso_ind */
             tattr->header_pos_,                   /* tag_ind */
-            tattr->children_[0].u_.string.len +
-                4, /* +4 for the D8 18 58 <> prefix */
+            tattr[1].u_.string.len + 4, /* +4 for the D8 18 58 <> prefix */
             resp});
-
-        tattr = mldns[1].index(ai++);
       }
     }
 
@@ -200,9 +203,10 @@ class ParsedMdoc {
     // Then parse tagged mso. Skip 5 bytes to skip the D8 18 59 <len2>.
     const uint8_t* pmso = resp + tmso->u_.string.pos + 5;
     size_t pos = 0;
-    CborDoc mso;
-    if (!mso.decode(pmso, tmso->u_.string.len - 5, pos, 0)) return false;
-    auto nv = mso.lookup(pmso, kValidityInfoLen, kValidityInfoID, valid_.ndx);
+    CborTape mso_tape;
+    if (!mso_tape.decode(pmso, tmso->u_.string.len - 5, pos, 0)) return false;
+    const CborToken* mso = mso_tape.root();
+    auto nv = mso->lookup(pmso, kValidityInfoLen, kValidityInfoID, valid_.ndx);
     if (nv == nullptr) return false;
     copy_kv_header(valid_, nv);
 
@@ -215,7 +219,7 @@ class ParsedMdoc {
     if (nvu == nullptr) return false;
     copy_kv_header(valid_until_, nvu);
 
-    auto ndki = mso.lookup(pmso, kDeviceKeyInfoLen, kDeviceKeyInfoID,
+    auto ndki = mso->lookup(pmso, kDeviceKeyInfoLen, kDeviceKeyInfoID,
                            dev_key_info_.ndx);
     if (ndki == nullptr) return false;
     copy_kv_header(dev_key_info_, ndki);
@@ -233,7 +237,7 @@ class ParsedMdoc {
     copy_kv_header(dev_key_pky_, npky);
 
     auto nvd =
-        mso.lookup(pmso, kValueDigestsLen, kValueDigestsID, value_digests_.ndx);
+        mso->lookup(pmso, kValueDigestsLen, kValueDigestsID, value_digests_.ndx);
     if (nvd == nullptr) return false;
     copy_kv_header(value_digests_, nvd);
 
@@ -269,7 +273,7 @@ class ParsedMdoc {
 
  private:
   // Used to copy the results of a map lookup.
-  static void copy_kv_header(CborIndex& ind, const CborDoc* n) {
+  static void copy_kv_header(CborIndex& ind, const CborToken* n) {
     ind.k = n[0].header_pos_;
     ind.v = n[1].header_pos_;
 
@@ -280,7 +284,7 @@ class ParsedMdoc {
   }
 
   // Used to copy the results of an index lookup.
-  static void copy_header(CborIndex& ind, const CborDoc* n) {
+  static void copy_header(CborIndex& ind, const CborToken* n) {
     ind.k = n->header_pos_;
     ind.pos = n->u_.string.pos;
     ind.len = n->u_.string.len;
@@ -473,12 +477,13 @@ bool fill_attribute(DenseFiller<Field>& filler, const RequestedAttribute& attr,
   return true;
 }
 
-template <class EC, class ScalarField>
+// KECDSAWINDOW must match the MdocSignature circuit.
+template <class EC, class ScalarField, size_t kEcdsaWindow = 1>
 class MdocSignatureWitness {
   using Field = typename EC::Field;
   using Elt = typename Field::Elt;
   using Nat = typename Field::N;
-  using EcdsaWitness = VerifyWitness3<EC, ScalarField>;
+  using EcdsaWitness = VerifyWitness3<EC, ScalarField, kEcdsaWindow>;
   using MacWitnessF = MacWitness<Field>;
   using f_128 = GF2_128<>;
   const EC& ec_;
@@ -514,35 +519,60 @@ class MdocSignatureWitness {
   bool compute_witness(Elt pkX, Elt pkY, const uint8_t mdoc[/* len */],
                        size_t len, const uint8_t transcript[/* tlen */],
                        size_t tlen) {
+    if (!parse(pkX, pkY, mdoc, len, transcript, tlen)) {
+      return false;
+    }
+    compute_issuer_witness();
+    compute_device_witness();
+    return true;
+  }
+
+  // The three steps of compute_witness().  After parse(), the issuer
+  // and device key witnesses are independent and can be computed
+  // concurrently.
+  bool parse(Elt pkX, Elt pkY, const uint8_t mdoc[/* len */], size_t len,
+             const uint8_t transcript[/* tlen */], size_t tlen) {
     ParsedMdoc pm;
 
     if (!pm.parse_device_response(len, mdoc)) {
       return false;
     }
 
-    Nat ne = nat_from_hash<Nat>(pm.tagged_mso_bytes_.data(),
-                                pm.tagged_mso_bytes_.size());
-    e_ = ec_.f_.to_montgomery(ne);
+    pkx_ = pkX;
+    pky_ = pkY;
+    ne_ = nat_from_hash<Nat>(pm.tagged_mso_bytes_.data(),
+                             pm.tagged_mso_bytes_.size());
+    e_ = ec_.f_.to_montgomery(ne_);
 
     // Parse (r,s).
     const size_t l = pm.sig_.len;
-    Nat nr = nat_from_be<Nat>(&mdoc[pm.sig_.pos]);
-    Nat ns = nat_from_be<Nat>(&mdoc[pm.sig_.pos + l / 2]);
-    ew_.compute_witness(pkX, pkY, ne, nr, ns);
+    nr_ = nat_from_be<Nat>(&mdoc[pm.sig_.pos]);
+    ns_ = nat_from_be<Nat>(&mdoc[pm.sig_.pos + l / 2]);
 
-    Nat ne2 = compute_transcript_hash<Nat>(transcript, tlen, &pm.doc_type_);
+    ne2_ = compute_transcript_hash<Nat>(transcript, tlen, &pm.doc_type_);
     const size_t l2 = pm.dksig_.len;
-    Nat nr2 = nat_from_be<Nat>(&mdoc[pm.dksig_.pos]);
-    Nat ns2 = nat_from_be<Nat>(&mdoc[pm.dksig_.pos + l2 / 2]);
+    nr2_ = nat_from_be<Nat>(&mdoc[pm.dksig_.pos]);
+    ns2_ = nat_from_be<Nat>(&mdoc[pm.dksig_.pos + l2 / 2]);
     size_t pmso = pm.t_mso_.pos + 5; /* skip the tag */
     dpkx_ = ec_.f_.to_montgomery(
         nat_from_be<Nat>(&mdoc[pmso + pm.dev_key_pkx_.pos]));
     dpky_ = ec_.f_.to_montgomery(
         nat_from_be<Nat>(&mdoc[pmso + pm.dev_key_pky_.pos]));
-    e2_ = ec_.f_.to_montgomery(ne2);
-    dkw_.compute_witness(dpkx_, dpky_, ne2, nr2, ns2);
+    e2_ = ec_.f_.to_montgomery(ne2_);
     return true;
   }
+
+  void compute_issuer_witness() {
+    ew_.compute_witness(pkx_, pky_, ne_, nr_, ns_);
+  }
+
+  void compute_device_witness() {
+    dkw_.compute_witness(dpkx_, dpky_, ne2_, nr2_, ns2_);
+  }
+
+ private:
+  Elt pkx_, pky_;
+  Nat ne_, nr_, ns_, ne2_, nr2_, ns2_;
 };
 
 // EC: implements the elliptic curve for the mdoc
@@ -611,9 +641,8 @@ class MdocHashWitness {
     // Fill sha of main mso.
     filler.push_back(numb_, 8, fn_);
     // Don't push the prefix.
-    for (size_t i = kCose1PrefixLen; i < kMaxSHABlocks * 64; ++i) {
-      filler.push_back(signed_bytes_[i], 8, fn_);
-    }
+    filler.push_back_bytes(signed_bytes_ + kCose1PrefixLen,
+                           kMaxSHABlocks * 64 - kCose1PrefixLen, fn_);
     for (size_t j = 0; j < kMaxSHABlocks; j++) {
       fill_sha(filler, bw_[j]);
     }
@@ -626,9 +655,7 @@ class MdocHashWitness {
 
     // Fill all attribute witnesses.
     for (size_t ai = 0; ai < num_attr_; ++ai) {
-      for (size_t i = 0; i < 2 * 64; ++i) {
-        filler.push_back(attr_bytes_[ai][i], 8, fn_);
-      }
+      filler.push_back_bytes(attr_bytes_[ai].data(), 2 * 64, fn_);
       for (size_t j = 0; j < 2; j++) {
         fill_sha(filler, atw_[ai][j]);
       }
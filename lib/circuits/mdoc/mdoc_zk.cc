@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "algebra/convolution.h"
@@ -227,10 +228,34 @@ bool fill_witness(DenseFiller<Fp256Base> &fill_b, DenseFiller<f_128> &fill_s,
     fill_gf2k<f_128, f_128>(Fs.zero(), fill_s, Fs);
   }
 
-  bool ok_h = hw->compute_witness(mdoc, mdoc_len, tr, tr_len, attrs, attrs_len,
-                                  now, version);
-  bool ok_s = sw->compute_witness(pkX, pkY, mdoc, mdoc_len, tr, tr_len);
-  if (!ok_h || !ok_s) return false;
+  // The hash witness and the two ECDSA witnesses are independent until
+  // the MACs below, so compute them concurrently.  Exceptions are
+  // caught in each thread, since an exception escaping a thread, or
+  // unwinding past a joinable one, calls std::terminate().
+  if (!sw->parse(pkX, pkY, mdoc, mdoc_len, tr, tr_len)) return false;
+  bool ok_h = false, ok_i = false, ok_d = false;
+  std::thread hash_thread([&] {
+    try {
+      ok_h = hw->compute_witness(mdoc, mdoc_len, tr, tr_len, attrs,
+                                 attrs_len, now, version);
+    } catch (...) {
+    }
+  });
+  std::thread issuer_thread([&] {
+    try {
+      sw->compute_issuer_witness();
+      ok_i = true;
+    } catch (...) {
+    }
+  });
+  try {
+    sw->compute_device_witness();
+    ok_d = true;
+  } catch (...) {
+  }
+  issuer_thread.join();
+  hash_thread.join();
+  if (!ok_h || !ok_i || !ok_d) return false;
 
   // signature public inputs
   fill_signature_inputs(fill_b, pkX, pkY, sw->e2_);
@@ -253,15 +278,26 @@ bool fill_witness(DenseFiller<Fp256Base> &fill_b, DenseFiller<f_128> &fill_s,
     fill_bit_string(fill_s, buf, 32, 32, Fs);
   }
 
-  // private witnesses
-  hw->fill_witness(fill_s);
-  for (auto &mac : state.macs) {
-    mac.fill_witness(fill_s);
+  // private witnesses, one filler per thread
+  bool ok_s = false, ok_b = false;
+  std::thread fill_thread([&] {
+    try {
+      hw->fill_witness(fill_s);
+      for (auto &mac : state.macs) {
+        mac.fill_witness(fill_s);
+      }
+      ok_s = true;
+    } catch (...) {
+    }
+  });
+  try {
+    sw->fill_witness(fill_b);
+    ok_b = true;
+  } catch (...) {
   }
+  fill_thread.join();
 
-  sw->fill_witness(fill_b);
-
-  return true;
+  return ok_s && ok_b;
 }
 
 gf2k generate_mac_key(Transcript &t) {
@@ -152,6 +152,19 @@ MdocVerifierErrorCode run_mdoc_verifier(
 CircuitGenerationErrorCode generate_circuit(const ZkSpecStruct* zk_spec_version,
                                             uint8_t** cb, size_t* clen);
 
+// Produces the compressed circuits of NSPECS specs at once, into CB[i] and
+// CLEN[i] for ZK_SPECS[i], byte-identical to generate_circuit().  The
+// signature circuit, which does not depend on the number of attributes,
+// is compiled once.  The hash circuits are compiled, serialized, and
+// compressed by up to MAX_THREADS workers, or one per hardware thread if
+// MAX_THREADS is 0.  A worker only starts a circuit when the estimated
+// peak memory of the circuits in progress stays within MEMORY_BUDGET
+// bytes, or when no other circuit is in progress; 0 means unbounded.
+// On error, no buffers are returned.
+CircuitGenerationErrorCode generate_circuits(
+    const ZkSpecStruct* const zk_specs[], size_t nspecs, uint8_t* cb[],
+    size_t clen[], size_t max_threads, size_t memory_budget);
+
 // Produces an identifier for a pair of circuits (c_1, c_2) over (Fp256, f_128)
 // respectively. This method parses the input bytes into two circuits, computes
 // the circuit's ids of each, and then computes the SHA256 hash of the two ids.
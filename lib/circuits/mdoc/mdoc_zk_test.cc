@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include "circuits/mdoc/mdoc_examples.h"
 #include "circuits/mdoc/mdoc_test_attributes.h"
@@ -40,10 +41,18 @@ class MdocZKTest : public testing::Test {
 
   static void SetUpTestCase() {
     if (circuit1_ == nullptr) {
-      EXPECT_EQ(generate_circuit(&kZkSpecs[0], &circuit1_, &circuit_len1_),
-                CIRCUIT_GENERATION_SUCCESS);
-      EXPECT_EQ(generate_circuit(&kZkSpecs[1], &circuit2_, &circuit_len2_),
+      const ZkSpecStruct *specs[2] = {&kZkSpecs[0], &kZkSpecs[1]};
+      uint8_t *cb[2];
+      size_t clen[2];
+      // Two workers, but a budget that admits one hash circuit at a
+      // time, so that concurrent test processes fit in memory.
+      EXPECT_EQ(generate_circuits(specs, 2, cb, clen, /*max_threads=*/2,
+                                  /*memory_budget=*/size_t(2) << 30),
                 CIRCUIT_GENERATION_SUCCESS);
+      circuit1_ = cb[0];
+      circuit_len1_ = clen[0];
+      circuit2_ = cb[1];
+      circuit_len2_ = clen[1];
     }
   }
 
@@ -525,6 +534,46 @@ TEST(CircuitGenerationTest, attempt_to_generate_old_circuit) {
             CIRCUIT_GENERATION_INVALID_ZK_SPEC_VERSION);
 }
 
+TEST(CircuitGenerationTest, generate_circuits_bad_arguments) {
+  set_log_level(ERROR);
+  const ZkSpecStruct *specs[2] = {&kZkSpecs[0], nullptr};
+  uint8_t *cb[2];
+  size_t clen[2];
+  EXPECT_EQ(generate_circuits(nullptr, 1, cb, clen, 1, 0),
+            CIRCUIT_GENERATION_NULL_INPUT);
+  EXPECT_EQ(generate_circuits(specs, 1, nullptr, clen, 1, 0),
+            CIRCUIT_GENERATION_NULL_INPUT);
+  EXPECT_EQ(generate_circuits(specs, 1, cb, nullptr, 1, 0),
+            CIRCUIT_GENERATION_NULL_INPUT);
+  EXPECT_EQ(generate_circuits(specs, 2, cb, clen, 1, 0),
+            CIRCUIT_GENERATION_NULL_INPUT);
+
+  // All the specs are validated before any circuit is compiled.
+  for (int i = 0; i < kNumZkSpecs; ++i) {
+    if (kZkSpecs[i].num_attributes == kZkSpecs[0].num_attributes &&
+        kZkSpecs[i].version < kZkSpecs[0].version) {
+      specs[1] = &kZkSpecs[i];
+      EXPECT_EQ(generate_circuits(specs, 2, cb, clen, 1, 0),
+                CIRCUIT_GENERATION_INVALID_ZK_SPEC_VERSION);
+    }
+  }
+
+  EXPECT_EQ(generate_circuits(specs, 0, cb, clen, 1, 0),
+            CIRCUIT_GENERATION_SUCCESS);
+}
+
+// The circuits of the parallel driver in SetUpTestCase() are those of
+// generate_circuit().
+TEST_F(MdocZKTest, generate_circuits_matches_generate_circuit) {
+  uint8_t *circuit = nullptr;
+  size_t circuit_len = 0;
+  ASSERT_EQ(generate_circuit(&kZkSpecs[0], &circuit, &circuit_len),
+            CIRCUIT_GENERATION_SUCCESS);
+  ASSERT_EQ(circuit_len, circuit_len1_);
+  EXPECT_EQ(memcmp(circuit, circuit1_, circuit_len), 0);
+  free(circuit);
+}
+
 // ============================ Benchmarks ====================================
 static const Claims benchmark_claim = {
     "benchmark",
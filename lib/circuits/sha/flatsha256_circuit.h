@@ -55,6 +55,7 @@ class FlatSHA256Circuit {
   using v256 = typename Logic::v256;
   using v32 = typename Logic::v32;
   using EltW = typename Logic::EltW;
+  using BitW = typename Logic::BitW;
   using Field = typename Logic::Field;
   using packed_v32 = typename BitPlucker::packed_v32;
 
@@ -99,9 +100,13 @@ class FlatSHA256Circuit {
     return r;
   }
 
+  // If EN is not null, the round constants are multiplied by *EN, so
+  // that a disabled block (*EN = 0) with H0 = 0 is satisfied by the
+  // all-zero witness.
   void assert_transform_block(const v32 in[16], const v32 H0[8],
                               const v32 outw[48], const v32 oute[64],
-                              const v32 outa[64], const v32 H1[8]) const {
+                              const v32 outa[64], const v32 H1[8],
+                              const BitW* en = nullptr) const {
     const Logic& L = l_;  // shorthand
     BitAdder<Logic, 32> BA(L);
 
@@ -131,6 +136,9 @@ class FlatSHA256Circuit {
       auto s1e = Sigma1(e);
       auto ch = L.vCh(&e, &f, g);
       auto rt = L.vbit32(kSha256Round[t]);
+      if (en != nullptr) {
+        rt = L.vand(en, rt);
+      }
       std::vector<v32> t1_terms = {h, s1e, ch, rt, w[t]};
       EltW t1 = BA.add(t1_terms);
       EltW sigma0 = BA.as_field_element(Sigma0(a));
@@ -166,7 +174,8 @@ class FlatSHA256Circuit {
                               const packed_v32 poutw[48],
                               const packed_v32 poute[64],
                               const packed_v32 pouta[64],
-                              const packed_v32 pH1[8]) const {
+                              const packed_v32 pH1[8],
+                              const BitW* en = nullptr) const {
     std::vector<v32> H1(8);
     std::vector<v32> outw(48);
     std::vector<v32> oute(64), outa(64);
@@ -181,7 +190,7 @@ class FlatSHA256Circuit {
       outa[i] = bp_.unpack_v32(pouta[i]);
     }
     assert_transform_block(in, H0, outw.data(), oute.data(), outa.data(),
-                           H1.data());
+                           H1.data(), en);
   }
 
   // all packed
@@ -202,30 +211,22 @@ class FlatSHA256Circuit {
   */
   void assert_message(size_t max, const v8& nb, const v8 in[/* 64*max */],
                       const BlockWitness bw[/*max*/]) const {
-    const Logic& L = l_;  // shorthand
-    const packed_v32* H = nullptr;
-    std::vector<v32> tmp(16);
+    assert_blocks(max, nb, in, bw, /*gated=*/false);
+  }
 
-    for (size_t b = 0; b < max; ++b) {
-      const v8* inb = &in[64 * b];
-      for (size_t i = 0; i < 16; ++i) {
-        // big-endian mapping of v8[4] into v32.  The first
-        // argument of vappend() is the LSB, and thus +3 is
-        // the LSB and +0 is the MSB, hence big-endian.
-        tmp[i] = L.vappend(L.vappend(inb[4 * i + 3], inb[4 * i + 2]),
-                           L.vappend(inb[4 * i + 1], inb[4 * i + 0]));
-      }
-      if (b == 0) {
-        v32 H0[8];
-        initial_context(H0);
-        assert_transform_block(tmp.data(), H0, bw[b].outw, bw[b].oute,
-                               bw[b].outa, bw[b].h1);
-      } else {
-        assert_transform_block(tmp.data(), H, bw[b].outw, bw[b].oute,
-                               bw[b].outa, bw[b].h1);
-      }
-      H = bw[b].h1;
-    }
+  /* As assert_message(), but only the first nb blocks are checked against
+     the sha block transform.  Each block b has an enable bit (b < nb), and
+     a disabled block is checked with zero round constants and a zero
+     chaining value, which the all-zero block witness satisfies.  The
+     prover thus computes only the transforms that the message uses (see
+     FlatSHA256Witness::transform_and_witness_enabled_message()), and the
+     witness of the remaining blocks is a run of zeros.  This costs 256
+     AND gates per block over assert_message().
+  */
+  void assert_message_enabled(size_t max, const v8& nb,
+                              const v8 in[/* 64*max */],
+                              const BlockWitness bw[/*max*/]) const {
+    assert_blocks(max, nb, in, bw, /*gated=*/true);
   }
 
   /* This method checks that the block witness corresponds to the iterated
@@ -235,17 +236,7 @@ class FlatSHA256Circuit {
                                   const v8 in[/* < 64*max */],
                                   const uint8_t prefix[/* len */], size_t len,
                                   const BlockWitness bw[/*max*/]) const {
-    const Logic& L = l_;  // shorthand
-    std::vector<v32> tmp(16);
-
-    std::vector<v8> bbuf(64 * max);
-    for (size_t i = 0; i < len; ++i) {
-      L.bits(8, bbuf[i].data(), prefix[i]);
-    }
-    for (size_t i = 0; i + len < 64 * max; ++i) {
-      bbuf[i + len] = in[i];
-    }
-
+    std::vector<v8> bbuf = with_prefix(max, in, prefix, len);
     assert_message(max, nb, bbuf.data(), bw);
   }
 
@@ -275,6 +266,32 @@ class FlatSHA256Circuit {
     assert_hash(max, target, nb, bw);
   }
 
+  // The variants of the three methods above for assert_message_enabled().
+  void assert_message_with_prefix_enabled(
+      size_t max, const v8& nb, const v8 in[/* < 64*max */],
+      const uint8_t prefix[/* len */], size_t len,
+      const BlockWitness bw[/*max*/]) const {
+    std::vector<v8> bbuf = with_prefix(max, in, prefix, len);
+    assert_message_enabled(max, nb, bbuf.data(), bw);
+  }
+
+  void assert_message_hash_enabled(size_t max, const v8& nb,
+                                   const v8 in[/* 64*max */],
+                                   const v256& target,
+                                   const BlockWitness bw[/*max*/]) const {
+    assert_message_enabled(max, nb, in, bw);
+    assert_hash(max, target, nb, bw);
+  }
+
+  void assert_message_hash_with_prefix_enabled(
+      size_t max, const v8& nb, const v8 in[/* 64*max */],
+      const uint8_t prefix[/* len */], size_t len, const v256& target,
+      const BlockWitness bw[/*max*/]) const {
+    std::vector<v8> bbuf = with_prefix(max, in, prefix, len);
+    assert_message_enabled(max, nb, bbuf.data(), bw);
+    assert_hash(max, target, nb, bw);
+  }
+
   // Verifies that the nb_th element of the block witness is equal to e.
   // The block witness keeps track of the intermediate output of each
   // block transform.  Therefore, this method can be used to verify that the
@@ -309,6 +326,62 @@ class FlatSHA256Circuit {
   }
 
  private:
+  void assert_blocks(size_t max, const v8& nb, const v8 in[/* 64*max */],
+                     const BlockWitness bw[/*max*/], bool gated) const {
+    const Logic& L = l_;  // shorthand
+    const packed_v32* H = nullptr;
+    std::vector<v32> tmp(16);
+
+    for (size_t b = 0; b < max; ++b) {
+      const v8* inb = &in[64 * b];
+      for (size_t i = 0; i < 16; ++i) {
+        // big-endian mapping of v8[4] into v32.  The first
+        // argument of vappend() is the LSB, and thus +3 is
+        // the LSB and +0 is the MSB, hence big-endian.
+        tmp[i] = L.vappend(L.vappend(inb[4 * i + 3], inb[4 * i + 2]),
+                           L.vappend(inb[4 * i + 1], inb[4 * i + 0]));
+      }
+      if (gated) {
+        const BitW en = L.vlt(b, nb);
+        v32 H0[8];
+        if (b == 0) {
+          initial_context(H0);
+        } else {
+          for (size_t i = 0; i < 8; ++i) {
+            H0[i] = bp_.unpack_v32(H[i]);
+          }
+        }
+        for (size_t i = 0; i < 8; ++i) {
+          H0[i] = L.vand(&en, H0[i]);
+        }
+        assert_transform_block(tmp.data(), H0, bw[b].outw, bw[b].oute,
+                               bw[b].outa, bw[b].h1, &en);
+      } else if (b == 0) {
+        v32 H0[8];
+        initial_context(H0);
+        assert_transform_block(tmp.data(), H0, bw[b].outw, bw[b].oute,
+                               bw[b].outa, bw[b].h1);
+      } else {
+        assert_transform_block(tmp.data(), H, bw[b].outw, bw[b].oute,
+                               bw[b].outa, bw[b].h1);
+      }
+      H = bw[b].h1;
+    }
+  }
+
+  std::vector<v8> with_prefix(size_t max, const v8 in[/* < 64*max */],
+                              const uint8_t prefix[/* len */],
+                              size_t len) const {
+    std::vector<v8> bbuf(64 * max);
+    for (size_t i = 0; i < len; ++i) {
+      l_.bits(8, bbuf[i].data(), prefix[i]);
+    }
+    for (size_t i = 0; i + len < 64 * max; ++i) {
+      bbuf[i + len] = in[i];
+    }
+    return bbuf;
+  }
+
   void initial_context(v32 H[8]) const {
     static const uint64_t initial[8] = {0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u,
                                         0xa54ff53au, 0x510e527fu, 0x9b05688cu,
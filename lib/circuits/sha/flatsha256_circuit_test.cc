@@ -69,6 +69,33 @@ constexpr const Field& F = p256_base;
 // Evaluation tests verify the correctness of circuit construction by
 // comparing the output of the circuit against the reference implementation.
 
+// The SHA instruction path of the witness must agree with the portable
+// implementation, including the recovered round states.
+TEST(FlatSHA256_Witness, accelerated_matches_portable) {
+  SecureRandomEngine rng;
+  for (size_t iter = 0; iter < 100; ++iter) {
+    uint32_t in[16], H0[8];
+    rng.bytes(reinterpret_cast<uint8_t*>(in), sizeof(in));
+    rng.bytes(reinterpret_cast<uint8_t*>(H0), sizeof(H0));
+
+    FlatSHA256Witness::BlockWitness want, got;
+    FlatSHA256Witness::transform_and_witness_block_portable(
+        in, H0, want.outw, want.oute, want.outa, want.h1);
+    FlatSHA256Witness::transform_and_witness_block(in, H0, got.outw, got.oute,
+                                                   got.outa, got.h1);
+    for (size_t k = 0; k < 48; ++k) {
+      EXPECT_EQ(got.outw[k], want.outw[k]);
+    }
+    for (size_t k = 0; k < 64; ++k) {
+      EXPECT_EQ(got.oute[k], want.oute[k]);
+      EXPECT_EQ(got.outa[k], want.outa[k]);
+    }
+    for (size_t k = 0; k < 8; ++k) {
+      EXPECT_EQ(got.h1[k], want.h1[k]);
+    }
+  }
+}
+
 // Test the circuit via evaluation and comparison against reference.
 TEST(FlatSHA256_Circuit, p256_assert_block) {
   using EvalBackend = EvaluationBackend<Field>;
@@ -313,6 +340,78 @@ TEST(FlatSHA256_Circuit, assert_message_prefix) {
   }
 }
 
+// The enabled variant only checks the first numb blocks, which lets the
+// witness of the remaining blocks be zero.
+TEST(FlatSHA256_Circuit, assert_message_enabled) {
+  using EvalBackend = EvaluationBackend<Field>;
+  using Logic = Logic<Field, EvalBackend>;
+  using v8 = typename Logic::v8;
+  using v256 = typename Logic::v256;
+  using FlatSha = FlatSHA256Circuit<Logic, BitPlucker<Logic, kShaPluckerSize>>;
+  const EvalBackend ebk(F, /*panic_on_assertion_failure=*/false);
+  const Logic L(&ebk, F);
+  const FlatSha FSHA(L);
+  BitPluckerEncoder<Field, kShaPluckerSize> BPENC(F);
+
+  constexpr size_t max = 16;
+  std::vector<uint8_t> in(64 * max);
+  std::vector<FlatSHA256Witness::BlockWitness> bw(max);
+
+  std::vector<v8> inW(64 * max);
+  std::vector<FlatSha::BlockWitness> bwW(max);
+
+  for (size_t i = 0; i < sizeof(SHA256_TV) / sizeof(SHA256_TV[0]); ++i) {
+    size_t len = SHA256_TV[i].len;
+    if (len + 9 > 64 * (max - 1)) {
+      continue;  // leave room for one disabled block
+    }
+
+    uint8_t numb;
+    FlatSHA256Witness::transform_and_witness_enabled_message(
+        len, (const uint8_t*)SHA256_TV[i].str, max, numb, in.data(), bw.data());
+
+    for (size_t j = 0; j < 8; ++j) {
+      uint32_t h1j = SHA256_ru32be(&SHA256_TV[i].hash[j * 4]);
+      EXPECT_EQ(bw[numb - 1].h1[j], h1j);
+      EXPECT_EQ(bw[max - 1].h1[j], 0);
+    }
+
+    v256 target;
+    for (size_t j = 0; j < 256; ++j) {
+      target[j] = L.bit((SHA256_TV[i].hash[(255 - j) / 8] >> (j % 8)) & 0x1);
+    }
+
+    for (size_t j = 0; j < max * 64; j++) {
+      inW[j] = L.vbit8(in[j]);
+    }
+    for (size_t j = 0; j < max; j++) {
+      for (size_t k = 0; k < 48; ++k) {
+        bwW[j].outw[k] = L.konst(BPENC.mkpacked_v32(bw[j].outw[k]));
+      }
+      for (size_t k = 0; k < 64; ++k) {
+        bwW[j].oute[k] = L.konst(BPENC.mkpacked_v32(bw[j].oute[k]));
+        bwW[j].outa[k] = L.konst(BPENC.mkpacked_v32(bw[j].outa[k]));
+      }
+      for (size_t k = 0; k < 8; ++k) {
+        bwW[j].h1[k] = L.konst(BPENC.mkpacked_v32(bw[j].h1[k]));
+      }
+    }
+
+    FSHA.assert_message_hash_enabled(max, L.vbit8(numb), inW.data(), target,
+                                     bwW.data());
+    EXPECT_FALSE(ebk.assertion_failed());
+
+    // The zero witness does not satisfy an enabled block.
+    FSHA.assert_message_enabled(max, L.vbit8(numb + 1), inW.data(),
+                                bwW.data());
+    EXPECT_TRUE(ebk.assertion_failed());
+
+    // The zero witness does not satisfy the ungated circuit.
+    FSHA.assert_message(max, L.vbit8(numb), inW.data(), bwW.data());
+    EXPECT_TRUE(ebk.assertion_failed());
+  }
+}
+
 // =============================================================================
 // Compiler tests are used to assess the circuit size and verify that the
 // circuit works in sumcheck or zk proof processes. These tests use different
@@ -441,7 +540,8 @@ namespace bench {
 
 template <class Field, size_t pluckerSize>
 std::unique_ptr<Circuit<Field>> make_circuit(size_t numBlocks, size_t numCopies,
-                                             const Field& f) {
+                                             const Field& f,
+                                             bool enabled = false) {
   set_log_level(ERROR);
   using CompilerBackend = CompilerBackend<Field>;
   using LogicCircuit = Logic<Field, CompilerBackend>;
@@ -469,13 +569,31 @@ std::unique_ptr<Circuit<Field>> make_circuit(size_t numBlocks, size_t numCopies,
     bw[j].input(Q);
   }
 
-  sha.assert_message_hash(numBlocks, nb, &in[0], target, &bw[0]);
+  if (enabled) {
+    sha.assert_message_hash_enabled(numBlocks, nb, &in[0], target, &bw[0]);
+  } else {
+    sha.assert_message_hash(numBlocks, nb, &in[0], target, &bw[0]);
+  }
 
   auto circuit = Q.mkcircuit(numCopies);
   dump_info("assert_message_hash", Q);
   return circuit;
 }
 
+TEST(FlatSHA256_Circuit, message_size_enabled) {
+  for (size_t numBlocks : {2, 7, 35}) {
+    auto c0 = make_circuit<Field, kShaPluckerSize>(numBlocks, 1, F);
+    auto c1 = make_circuit<Field, kShaPluckerSize>(numBlocks, 1, F,
+                                                   /*enabled=*/true);
+    // Same witness layout, so the callers can switch between the two.
+    EXPECT_EQ(c0->ninputs, c1->ninputs);
+    EXPECT_EQ(c0->npub_in, c1->npub_in);
+    set_log_level(INFO);
+    log(INFO, "blocks %zu: depth %zu -> %zu, terms %zu -> %zu", numBlocks,
+        c0->nl, c1->nl, c0->nterms(), c1->nterms());
+  }
+}
+
 template <class Field, size_t N>
 void push(const std::array<typename Field::Elt, N>& a, size_t& wi, size_t c,
           size_t numCopies, Dense<Field>& W) {
@@ -564,6 +682,81 @@ void BM_ShaSumcheckProver_fp2_128(benchmark::State& state) {
 }
 BENCHMARK(BM_ShaSumcheckProver_fp2_128)->RangeMultiplier(2)->Range(1, 33);
 
+// A one-block message in a circuit for numBlocks blocks.  With
+// assert_message_enabled(), the witness of the other blocks is zero, and
+// the prover skips the zero extents of the wires.
+void BM_ShaSumcheckProverShortMessage_fp2_128(benchmark::State& state) {
+  using f_128 = GF2_128<>;
+  const f_128 Fs;
+
+  size_t numBlocks = state.range(0);
+  std::unique_ptr<Circuit<f_128>> CIRCUIT =
+      make_circuit<f_128, 2>(numBlocks, 1, Fs, /*enabled=*/true);
+
+  auto W = Dense<f_128>(1, CIRCUIT->ninputs);
+  std::vector<uint8_t> message(55, 'a');
+  uint8_t numb;
+  std::vector<uint8_t> inb(64 * numBlocks);
+  std::vector<FlatSHA256Witness::BlockWitness> bwb(numBlocks);
+  FlatSHA256Witness::transform_and_witness_enabled_message(
+      message.size(), message.data(), numBlocks, numb, &inb[0], &bwb[0]);
+
+  DenseFiller<f_128> filler(W);
+  BitPluckerEncoder<f_128, 2> BPENC(Fs);
+  filler.push_back(Fs.one());
+  filler.push_back(numb, 8, Fs);
+  for (size_t j = 0; j < numBlocks * 64; j++) {
+    filler.push_back(inb[j], 8, Fs);
+  }
+  for (size_t j = 0; j < 256; ++j) {
+    // The target is H1 of block numb in reverse byte-order.
+    uint32_t h = bwb[numb - 1].h1[7 - j / 32];
+    filler.push_back((h >> (j % 32)) & 1, 1, Fs);
+  }
+  for (size_t j = 0; j < numBlocks; j++) {
+    for (size_t k = 0; k < 48; ++k) {
+      filler.push_back(BPENC.mkpacked_v32(bwb[j].outw[k]));
+    }
+    for (size_t k = 0; k < 64; ++k) {
+      filler.push_back(BPENC.mkpacked_v32(bwb[j].oute[k]));
+      filler.push_back(BPENC.mkpacked_v32(bwb[j].outa[k]));
+    }
+    for (size_t k = 0; k < 8; ++k) {
+      filler.push_back(BPENC.mkpacked_v32(bwb[j].h1[k]));
+    }
+  }
+
+  for (auto s : state) {
+    Proof<f_128> proof(CIRCUIT->nl);
+    run_prover(CIRCUIT.get(), W.clone(), &proof, Fs);
+    benchmark::DoNotOptimize(proof);
+  }
+}
+BENCHMARK(BM_ShaSumcheckProverShortMessage_fp2_128)
+    ->RangeMultiplier(2)
+    ->Range(1, 16);
+
+void BM_ShaWitness(benchmark::State& state) {
+  const bool portable = state.range(0);
+  uint32_t in[16] = {}, H[8] = {};
+  FlatSHA256Witness::BlockWitness bw;
+  for (auto s : state) {
+    if (portable) {
+      FlatSHA256Witness::transform_and_witness_block_portable(
+          in, H, bw.outw, bw.oute, bw.outa, bw.h1);
+    } else {
+      FlatSHA256Witness::transform_and_witness_block(in, H, bw.outw, bw.oute,
+                                                     bw.outa, bw.h1);
+    }
+    in[0] = bw.h1[0];
+    benchmark::DoNotOptimize(bw);
+  }
+  state.SetLabel(portable ? "portable"
+                 : FlatSHA256Witness::accelerated() ? "accelerated"
+                                                    : "portable (no SHA)");
+}
+BENCHMARK(BM_ShaWitness)->Arg(1)->Arg(0);
+
 void BM_ShaSumcheckCopyProver_fp2_128(benchmark::State& state) {
   using f_128 = GF2_128<>;
   const f_128 F;
@@ -611,6 +804,80 @@ void BM_ShaZK_fp2_128(benchmark::State& state) {
 }
 BENCHMARK(BM_ShaZK_fp2_128)->RangeMultiplier(2)->Range(1, 33);
 
+template <class Field, class RSFactory, size_t kPluckerBits>
+void sha_zk_plucker(benchmark::State& state, const Field& F,
+                    const RSFactory& rsf) {
+  const size_t numBlocks = state.range(0);
+  std::unique_ptr<Circuit<Field>> CIRCUIT =
+      make_circuit<Field, kPluckerBits>(numBlocks, 1, F);
+
+  auto W = Dense<Field>(1, CIRCUIT->ninputs);
+  fill_input<Field, kPluckerBits>(W, numBlocks, CIRCUIT->ninputs, 1, F);
+
+  Transcript tp((uint8_t*)"test", 4);
+  SecureRandomEngine rng;
+  for (auto s : state) {
+    ZkProof<Field> zkpr(*CIRCUIT, 4, 128);
+    ZkProver<Field, RSFactory> prover(*CIRCUIT, F, rsf);
+    prover.commit(zkpr, W, tp, rng);
+    check(prover.prove(zkpr, W, tp), "prove failed");
+    benchmark::DoNotOptimize(zkpr);
+  }
+
+  // The quantities of the cost model.
+  ZkProof<Field> zkpr(*CIRCUIT, 4, 128);
+  state.counters["terms"] = CIRCUIT->nterms();
+  state.counters["encoded"] = zkpr.param.nrow * zkpr.param.block_enc;
+}
+
+// ZK prover time as a function of the packing density of the block
+// witnesses, for calibrating the model in bit_plucker_cost.h.  The
+// second argument is LOGN.
+void BM_ShaZKPlucker_fp2_128(benchmark::State& state) {
+  using f_128 = GF2_128<>;
+  const f_128 Fs;
+  using RSFactory = LCH14ReedSolomonFactory<f_128>;
+  const RSFactory rsf(Fs);
+  switch (state.range(1)) {
+    case 1: return sha_zk_plucker<f_128, RSFactory, 1>(state, Fs, rsf);
+    case 2: return sha_zk_plucker<f_128, RSFactory, 2>(state, Fs, rsf);
+    case 3: return sha_zk_plucker<f_128, RSFactory, 3>(state, Fs, rsf);
+    case 4: return sha_zk_plucker<f_128, RSFactory, 4>(state, Fs, rsf);
+    case 5: return sha_zk_plucker<f_128, RSFactory, 5>(state, Fs, rsf);
+    case 6: return sha_zk_plucker<f_128, RSFactory, 6>(state, Fs, rsf);
+  }
+}
+BENCHMARK(BM_ShaZKPlucker_fp2_128)->ArgsProduct({{8}, {1, 2, 3, 4, 5, 6}});
+
+void BM_ShaZKPlucker_p256(benchmark::State& state) {
+  const Fp256Base& F = p256_base;
+  using f2_p256 = Fp2<Fp256Base>;
+  using Elt2 = f2_p256::Elt;
+  using FftExtConvolutionFactory = FFTExtConvolutionFactory<Fp256Base, f2_p256>;
+  using RSFactory = ReedSolomonFactory<Fp256Base, FftExtConvolutionFactory>;
+  const f2_p256 p256_2(F);
+
+  // Root of unity for the f_p256^2 extension field.
+  static constexpr char kRootX[] =
+      "112649224146410281873500457609690258373018840430489408729223714171582664"
+      "680802";
+  static constexpr char kRootY[] =
+      "317040948518153410669569855215889129699039744181079354462206130544166376"
+      "41043";
+  const Elt2 omega = p256_2.of_string(kRootX, kRootY);
+  const FftExtConvolutionFactory fft_b(F, p256_2, omega, 1ull << 31);
+  const RSFactory rsf(fft_b, F);
+  switch (state.range(1)) {
+    case 1: return sha_zk_plucker<Fp256Base, RSFactory, 1>(state, F, rsf);
+    case 2: return sha_zk_plucker<Fp256Base, RSFactory, 2>(state, F, rsf);
+    case 3: return sha_zk_plucker<Fp256Base, RSFactory, 3>(state, F, rsf);
+    case 4: return sha_zk_plucker<Fp256Base, RSFactory, 4>(state, F, rsf);
+    case 5: return sha_zk_plucker<Fp256Base, RSFactory, 5>(state, F, rsf);
+    case 6: return sha_zk_plucker<Fp256Base, RSFactory, 6>(state, F, rsf);
+  }
+}
+BENCHMARK(BM_ShaZKPlucker_p256)->ArgsProduct({{2}, {1, 2, 3, 4, 5, 6}});
+
 void BM_ShaZK_Fp64_2(benchmark::State& state) {
   using f_goldi = Fp<1>;
   using Field2 = Fp2<f_goldi>;
@@ -21,6 +21,18 @@
 #include "util/ceildiv.h"
 #include "util/panic.h"
 
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>  // IWYU pragma: keep
+#define FLATSHA256_WITNESS_SHA_NI 1
+#elif defined(FLATSHA256_WITNESS_ENABLE_ARMV8) && defined(__aarch64__) && \
+    (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+// The ARMv8 path has not yet been run on arm64 hardware, so it must
+// be requested explicitly with -DFLATSHA256_WITNESS_ENABLE_ARMV8.
+#include <arm_neon.h>  // IWYU pragma: keep
+#define FLATSHA256_WITNESS_ARMV8_SHA2 1
+#endif
+
 namespace proofs {
 
 static inline uint32_t shr(uint32_t x, size_t b) { return (x >> b); }
@@ -69,9 +81,143 @@ void SHA256_wu64be(uint8_t *d, uint64_t n) {
   }
 }
 
+// The hardware paths below compute the message schedule and the rounds
+// with the SHA instructions of the CPU.  Each instruction leaves the
+// working variables a and e of every round it executes in its output
+// state, and thus the round states can be read back as the witness.
+
+#if defined(FLATSHA256_WITNESS_SHA_NI)
+// SHA-NI keeps the state as ABEF = {f, e, b, a} and CDGH = {h, g, d, c}
+// in lanes 0..3, and sha256rnds2 executes two rounds.  After rounds t
+// and t+1, ABEF = {e_t, e_{t+1}, a_t, a_{t+1}}.
+__attribute__((target("sha,sse4.1"))) static void
+transform_and_witness_block_sha_ni(const uint32_t in[16], const uint32_t H0[8],
+                                   uint32_t outw[48], uint32_t oute[64],
+                                   uint32_t outa[64]) {
+  __m128i w[16];
+  for (size_t i = 0; i < 4; ++i) {
+    w[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[4 * i]));
+  }
+  for (size_t i = 4; i < 16; ++i) {
+    __m128i t = _mm_alignr_epi8(w[i - 1], w[i - 2], 4);  // w[4i-7..4i-4]
+    t = _mm_add_epi32(_mm_sha256msg1_epu32(w[i - 4], w[i - 3]), t);
+    w[i] = _mm_sha256msg2_epu32(t, w[i - 1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&outw[4 * (i - 4)]), w[i]);
+  }
+
+  __m128i abef = _mm_set_epi32(H0[0], H0[1], H0[4], H0[5]);
+  __m128i cdgh = _mm_set_epi32(H0[2], H0[3], H0[6], H0[7]);
+  for (size_t i = 0; i < 16; ++i) {
+    __m128i k =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&kSha256Round[4 * i]));
+    __m128i wk = _mm_add_epi32(w[i], k);
+    for (size_t j = 0; j < 2; ++j) {
+      __m128i next = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+      cdgh = abef;
+      abef = next;
+      wk = _mm_shuffle_epi32(wk, 0x0E);
+
+      size_t t = 4 * i + 2 * j;
+      oute[t] = _mm_extract_epi32(abef, 0);
+      oute[t + 1] = _mm_extract_epi32(abef, 1);
+      outa[t] = _mm_extract_epi32(abef, 2);
+      outa[t + 1] = _mm_extract_epi32(abef, 3);
+    }
+  }
+}
+
+static bool have_sha_ni() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  bool sha = (ebx >> 29) & 1;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  bool sse41 = (ecx >> 19) & 1;
+  return sha && sse41;
+}
+#endif
+
+#if defined(FLATSHA256_WITNESS_ARMV8_SHA2)
+// ARMv8 keeps the state as ABCD = {a, b, c, d} and EFGH = {e, f, g, h},
+// and sha256h/sha256h2 execute four rounds.  After rounds t..t+3,
+// ABCD = {a_{t+3}, a_{t+2}, a_{t+1}, a_t}, and similarly for EFGH.
+static void transform_and_witness_block_armv8(const uint32_t in[16],
+                                              const uint32_t H0[8],
+                                              uint32_t outw[48],
+                                              uint32_t oute[64],
+                                              uint32_t outa[64]) {
+  uint32x4_t w[16];
+  for (size_t i = 0; i < 4; ++i) {
+    w[i] = vld1q_u32(&in[4 * i]);
+  }
+  for (size_t i = 4; i < 16; ++i) {
+    w[i] = vsha256su1q_u32(vsha256su0q_u32(w[i - 4], w[i - 3]), w[i - 2],
+                           w[i - 1]);
+    vst1q_u32(&outw[4 * (i - 4)], w[i]);
+  }
+
+  uint32x4_t abcd = vld1q_u32(&H0[0]);
+  uint32x4_t efgh = vld1q_u32(&H0[4]);
+  for (size_t i = 0; i < 16; ++i) {
+    uint32x4_t wk = vaddq_u32(w[i], vld1q_u32(&kSha256Round[4 * i]));
+    uint32x4_t abcd0 = abcd;
+    abcd = vsha256hq_u32(abcd0, efgh, wk);
+    efgh = vsha256h2q_u32(efgh, abcd0, wk);
+
+    uint32_t a[4], e[4];
+    vst1q_u32(a, abcd);
+    vst1q_u32(e, efgh);
+    for (size_t j = 0; j < 4; ++j) {
+      outa[4 * i + j] = a[3 - j];
+      oute[4 * i + j] = e[3 - j];
+    }
+  }
+}
+#endif
+
+bool FlatSHA256Witness::accelerated() {
+#if defined(FLATSHA256_WITNESS_SHA_NI)
+  static const bool sha_ni = have_sha_ni();
+  return sha_ni;
+#elif defined(FLATSHA256_WITNESS_ARMV8_SHA2)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// The final state is (a_63, a_62, a_61, a_60, e_63, e_62, e_61, e_60).
+static void final_context(const uint32_t H0[8], const uint32_t oute[64],
+                          const uint32_t outa[64], uint32_t H1[8]) {
+  for (size_t i = 0; i < 4; ++i) {
+    H1[i] = H0[i] + outa[63 - i];
+    H1[4 + i] = H0[4 + i] + oute[63 - i];
+  }
+}
+
 void FlatSHA256Witness::transform_and_witness_block(
     const uint32_t in[16], const uint32_t H0[8], uint32_t outw[48],
     uint32_t oute[64], uint32_t outa[64], uint32_t H1[8]) {
+#if defined(FLATSHA256_WITNESS_SHA_NI)
+  if (accelerated()) {
+    transform_and_witness_block_sha_ni(in, H0, outw, oute, outa);
+    final_context(H0, oute, outa, H1);
+    return;
+  }
+#elif defined(FLATSHA256_WITNESS_ARMV8_SHA2)
+  transform_and_witness_block_armv8(in, H0, outw, oute, outa);
+  final_context(H0, oute, outa, H1);
+  return;
+#endif
+  transform_and_witness_block_portable(in, H0, outw, oute, outa, H1);
+}
+
+void FlatSHA256Witness::transform_and_witness_block_portable(
+    const uint32_t in[16], const uint32_t H0[8], uint32_t outw[48],
+    uint32_t oute[64], uint32_t outa[64], uint32_t H1[8]) {
   uint32_t w[64];
   for (size_t i = 0; i < 16; ++i) {
     w[i] = in[i];
@@ -118,11 +264,13 @@ static const uint32_t initial_h0[8] = {0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u,
                                        0xa54ff53au, 0x510e527fu, 0x9b05688cu,
                                        0x1f83d9abu, 0x5be0cd19u};
 
-void FlatSHA256Witness::transform_and_witness_message(
-    size_t n, const uint8_t msg[/*n*/], size_t max, uint8_t &numb,
-    uint8_t in[/* 64*max */], BlockWitness bw[/*max*/]) {
+// Pad MSG into IN[0..64*max) and return the number of blocks that the
+// padded message occupies.
+static size_t pad_message(size_t n, const uint8_t msg[/*n*/], size_t max,
+                          uint8_t in[/* 64*max */]) {
   // Compute the exact number of blocks needed for hashing.
-  numb = ceildiv<size_t>(n + 9, 64);
+  size_t numb = ceildiv<size_t>(n + 9, 64);
+  check(numb <= max, "message too long");
 
   size_t ii = 0;
   for (size_t i = 0; i < n; ++i, ++ii) {
@@ -145,19 +293,40 @@ void FlatSHA256Witness::transform_and_witness_message(
   while (ii < 64 * max) {
     in[ii++] = 0;
   }
+  return numb;
+}
 
-  // Compute all of the intermediate hashes and witnesses.
+// Compute the intermediate hashes and witnesses of the first NB blocks.
+static void witness_blocks(size_t nb, const uint8_t in[/* 64*nb */],
+                           FlatSHA256Witness::BlockWitness bw[/*nb*/]) {
   uint32_t data[16];
   const uint32_t *H = initial_h0;
-  for (size_t bl = 0; bl < max; bl++) {
+  for (size_t bl = 0; bl < nb; bl++) {
     for (size_t i = 0; i < 16; ++i) {
       data[i] = SHA256_ru32be(&in[bl * 64 + i * 4]);
     }
 
-    transform_and_witness_block(data, H, bw[bl].outw, bw[bl].oute, bw[bl].outa,
-                                bw[bl].h1);
+    FlatSHA256Witness::transform_and_witness_block(
+        data, H, bw[bl].outw, bw[bl].oute, bw[bl].outa, bw[bl].h1);
     H = bw[bl].h1;
   }
 }
 
+void FlatSHA256Witness::transform_and_witness_message(
+    size_t n, const uint8_t msg[/*n*/], size_t max, uint8_t &numb,
+    uint8_t in[/* 64*max */], BlockWitness bw[/*max*/]) {
+  numb = pad_message(n, msg, max, in);
+  witness_blocks(max, in, bw);
+}
+
+void FlatSHA256Witness::transform_and_witness_enabled_message(
+    size_t n, const uint8_t msg[/*n*/], size_t max, uint8_t &numb,
+    uint8_t in[/* 64*max */], BlockWitness bw[/*max*/]) {
+  numb = pad_message(n, msg, max, in);
+  witness_blocks(numb, in, bw);
+  for (size_t bl = numb; bl < max; bl++) {
+    bw[bl] = BlockWitness{};
+  }
+}
+
 }  // namespace proofs
@@ -36,10 +36,29 @@ class FlatSHA256Witness {
                                           uint32_t outw[48], uint32_t oute[64],
                                           uint32_t outa[64], uint32_t H1[8]);
 
+  // The scalar implementation of transform_and_witness_block(), which
+  // the latter uses unless the CPU has SHA instructions (SHA-NI on
+  // x86_64, or the ARMv8 SHA2 extension if the build defines
+  // FLATSHA256_WITNESS_ENABLE_ARMV8).
+  static void transform_and_witness_block_portable(
+      const uint32_t in[16], const uint32_t H0[8], uint32_t outw[48],
+      uint32_t oute[64], uint32_t outa[64], uint32_t H1[8]);
+
+  // True if transform_and_witness_block() uses SHA instructions.
+  static bool accelerated();
+
   static void transform_and_witness_message(size_t n, const uint8_t msg[/*n*/],
                                             size_t max, uint8_t &numb,
                                             uint8_t in[/* 64*max */],
                                             BlockWitness bw[/*max*/]);
+
+  // As transform_and_witness_message(), but for the circuit
+  // FlatSHA256Circuit::assert_message_enabled(), which only checks the
+  // first numb blocks.  The witness of the remaining blocks is zero, and
+  // the cost is proportional to the length of the message instead of MAX.
+  static void transform_and_witness_enabled_message(
+      size_t n, const uint8_t msg[/*n*/], size_t max, uint8_t &numb,
+      uint8_t in[/* 64*max */], BlockWitness bw[/*max*/]);
 };
 
 }  // namespace proofs
@@ -34,53 +34,102 @@ class Sha3Circuit {
  public:
   explicit Sha3Circuit(const LogicCircuit& lc) : lc_(lc) {}
 
-  void keccak_f_1600(v64 A[5][5]) {
+  void keccak_f_1600(v64 A[5][5]) const {
     for (size_t round = 0; round < 24; ++round) {
-      // FIPS 202 3.2.1, theta
-      v64 C[5];
-      for (size_t x = 0; x < 5; ++x) {
-        auto a01 = lc_.vxor(&A[x][0], A[x][1]);
-        auto a23 = lc_.vxor(&A[x][2], A[x][3]);
-        C[x] = lc_.vxor(&a01, lc_.vxor(&a23, A[x][4]));
-      }
+      keccak_round(A, round);
+    }
+  }
 
-      for (size_t x = 0; x < 5; ++x) {
-        v64 D_x = lc_.vxor(&C[(x + 4) % 5], lc_.vrotl(C[(x + 1) % 5], 1));
-        for (size_t y = 0; y < 5; ++y) {
-          A[x][y] = lc_.vxor(&A[x][y], D_x);
+  // Flattened keccak_f_1600.  The prover commits to the state after
+  // every KSTRIDE rounds, and the circuit checks each group of KSTRIDE
+  // rounds independently, starting from the committed state of the
+  // previous group.  The depth of the circuit is thus the depth of
+  // KSTRIDE rounds instead of 24, at the cost of 1600 witness bits per
+  // group.  The state after the last group is computed and not
+  // witnessed, so that keccak_f_1600_flat() can be used as a drop-in
+  // replacement for keccak_f_1600().  See Sha3Witness for the
+  // corresponding witness generator.
+  template <size_t kStride>
+  struct FlatWitness {
+    static_assert(24 % kStride == 0 && kStride < 24,
+                  "kStride must be a proper divisor of 24");
+    static constexpr size_t kNw = 24 / kStride - 1;
+    v64 a[kNw][5][5];
+
+    void input(const LogicCircuit& lc) {
+      for (size_t i = 0; i < kNw; ++i) {
+        for (size_t x = 0; x < 5; ++x) {
+          for (size_t y = 0; y < 5; ++y) {
+            a[i][x][y] = lc.template vinput<64>();
+          }
         }
       }
+    }
+  };
 
-      // FIPS 202 3.2.2, rho
-      {
-        size_t x = 1, y = 0;
-        for (size_t t = 0; t < 24; ++t) {
-          A[x][y] = lc_.vrotl(A[x][y], sha3_rotc[t]);
-          size_t nx = y, ny = (2 * x + 3 * y) % 5;
-          x = nx;
-          y = ny;
+  template <size_t kStride>
+  void keccak_f_1600_flat(v64 A[5][5], const FlatWitness<kStride>& fw) const {
+    for (size_t i = 0; i <= FlatWitness<kStride>::kNw; ++i) {
+      for (size_t r = 0; r < kStride; ++r) {
+        keccak_round(A, i * kStride + r);
+      }
+      if (i < FlatWitness<kStride>::kNw) {
+        for (size_t x = 0; x < 5; ++x) {
+          for (size_t y = 0; y < 5; ++y) {
+            lc_.vassert_eq(&A[x][y], fw.a[i][x][y]);
+            A[x][y] = fw.a[i][x][y];
+          }
         }
       }
+    }
+  }
 
-      // FIPS 202 3.2.3, pi
-      v64 A1[5][5];
-      for (size_t x = 0; x < 5; ++x) {
-        for (size_t y = 0; y < 5; ++y) {
-          A1[x][y] = A[(x + 3 * y) % 5][x];
-        }
+ private:
+  void keccak_round(v64 A[5][5], size_t round) const {
+    // FIPS 202 3.2.1, theta
+    v64 C[5];
+    for (size_t x = 0; x < 5; ++x) {
+      auto a01 = lc_.vxor(&A[x][0], A[x][1]);
+      auto a23 = lc_.vxor(&A[x][2], A[x][3]);
+      C[x] = lc_.vxor(&a01, lc_.vxor(&a23, A[x][4]));
+    }
+
+    for (size_t x = 0; x < 5; ++x) {
+      v64 D_x = lc_.vxor(&C[(x + 4) % 5], lc_.vrotl(C[(x + 1) % 5], 1));
+      for (size_t y = 0; y < 5; ++y) {
+        A[x][y] = lc_.vxor(&A[x][y], D_x);
       }
+    }
 
-      // FIPS 202 3.2.4, chi
-      for (size_t x = 0; x < 5; ++x) {
-        for (size_t y = 0; y < 5; ++y) {
-          A[x][y] = lc_.vxor(&A1[x][y], lc_.vand(&A1[(x + 2) % 5][y],
-                                                 lc_.vnot(A1[(x + 1) % 5][y])));
-        }
+    // FIPS 202 3.2.2, rho
+    {
+      size_t x = 1, y = 0;
+      for (size_t t = 0; t < 24; ++t) {
+        A[x][y] = lc_.vrotl(A[x][y], sha3_rotc[t]);
+        size_t nx = y, ny = (2 * x + 3 * y) % 5;
+        x = nx;
+        y = ny;
       }
+    }
 
-      // FIPS 202 3.2.5, iota
-      A[0][0] = lc_.vxor(&A[0][0], of_scalar(sha3_rc[round]));
+    // FIPS 202 3.2.3, pi
+    v64 A1[5][5];
+    for (size_t x = 0; x < 5; ++x) {
+      for (size_t y = 0; y < 5; ++y) {
+        A1[x][y] = A[(x + 3 * y) % 5][x];
+      }
     }
+
+    // FIPS 202 3.2.4, chi
+    for (size_t x = 0; x < 5; ++x) {
+      for (size_t y = 0; y < 5; ++y) {
+        A[x][y] = lc_.vxor(&A1[x][y], lc_.vand(&A1[(x + 2) % 5][y],
+                                               lc_.vnot(A1[(x + 1) % 5][y])));
+      }
+    }
+
+    // FIPS 202 3.2.5, iota
+    A[0][0] = lc_.vxor(&A[0][0], of_scalar(sha3_rc[round]));
   }
 };
 
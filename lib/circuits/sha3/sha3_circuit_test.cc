@@ -28,6 +28,7 @@
 #include "circuits/logic/evaluation_backend.h"
 #include "circuits/logic/logic.h"
 #include "circuits/sha3/sha3_reference.h"
+#include "circuits/sha3/sha3_witness.h"
 #include "gf2k/gf2_128.h"
 #include "random/transcript.h"
 #include "sumcheck/circuit.h"
@@ -35,6 +36,7 @@
 #include "sumcheck/verifier.h"
 #include "util/log.h"
 #include "util/panic.h"
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 namespace proofs {
@@ -175,5 +177,204 @@ TEST(SHA3_Circuit, Keccak_F_1600_Copies) {
   }
 }
 
+TEST(SHA3_Witness, MatchesReference) {
+  for (size_t stride : {1, 2, 3, 4, 6, 8, 12}) {
+    uint64_t st[5][5], ref[5][5], W[23][5][5];
+    for (size_t x = 0; x < 5; ++x) {
+      for (size_t y = 0; y < 5; ++y) {
+        ref[x][y] = st[x][y] = 0x9e3779b97f4a7c15ull * (1 + x + 5 * y);
+      }
+    }
+    Sha3Witness::keccak_f_1600_and_witness(st, stride, W);
+    Sha3Reference::keccak_f_1600_DEBUG_ONLY(ref);
+    for (size_t x = 0; x < 5; ++x) {
+      for (size_t y = 0; y < 5; ++y) {
+        EXPECT_EQ(st[x][y], ref[x][y]);
+      }
+    }
+
+    // The witnessed states are consistent with single rounds.
+    for (size_t i = 0; i + 1 < 24 / stride; ++i) {
+      uint64_t a[5][5];
+      for (size_t x = 0; x < 5; ++x) {
+        for (size_t y = 0; y < 5; ++y) {
+          a[x][y] = W[i][x][y];
+        }
+      }
+      for (size_t r = 0; r < stride; ++r) {
+        Sha3Reference::keccak_round(a, (i + 1) * stride + r);
+      }
+      const uint64_t(*next)[5] = (i + 2 < 24 / stride) ? W[i + 1] : st;
+      for (size_t x = 0; x < 5; ++x) {
+        for (size_t y = 0; y < 5; ++y) {
+          EXPECT_EQ(a[x][y], next[x][y]);
+        }
+      }
+    }
+  }
+}
+
+// KSTRIDE = 24 is the unflattened keccak_f_1600().
+template <size_t kStride>
+std::unique_ptr<Circuit<Field>> mk_flat_keccak_circuit(size_t nc) {
+  QuadCircuit<Field> Q(F);
+  const CompilerBackend cbk(&Q);
+  const LogicCircuit LC(&cbk, F);
+  Sha3Circuit<LogicCircuit> SHAC(LC);
+
+  struct awrap {
+    v64 a[5][5];
+  };
+
+  auto aw = std::make_unique<awrap>();
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      aw->a[x][y] = LC.vinput<64>();
+    }
+  }
+
+  if constexpr (kStride == 24) {
+    SHAC.keccak_f_1600(aw->a);
+  } else {
+    using FlatWitness =
+        typename Sha3Circuit<LogicCircuit>::template FlatWitness<kStride>;
+    auto fw = std::make_unique<FlatWitness>();
+    fw->input(LC);
+    SHAC.keccak_f_1600_flat(aw->a, *fw);
+  }
+
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      LC.voutput(aw->a[x][y], 64 * (y + 5 * x));
+    }
+  }
+
+  auto CIRCUIT = Q.mkcircuit(nc);
+  dump_info("sha3 flat", kStride, Q);
+  return CIRCUIT;
+}
+
+void push_state(DenseFiller<Field>& filler, const uint64_t st[5][5]) {
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      filler.push_back(st[x][y], 64, F);
+    }
+  }
+}
+
+// Fill the input and witness for keccak_f_1600 on ST, and return the
+// expected output in ST.
+template <size_t kStride>
+void fill_flat_input(Dense<Field>& W, uint64_t st[5][5]) {
+  DenseFiller<Field> filler(W);
+  filler.push_back(F.one());
+  push_state(filler, st);
+  if constexpr (kStride == 24) {
+    Sha3Reference::keccak_f_1600_DEBUG_ONLY(st);
+  } else {
+    uint64_t wit[24 / kStride - 1][5][5];
+    Sha3Witness::keccak_f_1600_and_witness(st, kStride, wit);
+    for (size_t i = 0; i + 1 < 24 / kStride; ++i) {
+      push_state(filler, wit[i]);
+    }
+  }
+}
+
+template <size_t kStride>
+void test_flat_keccak() {
+  const EvalBackend ebk(F);
+  const Logic L(&ebk, F);
+
+  auto CIRCUIT = mk_flat_keccak_circuit<kStride>(1);
+  EXPECT_EQ(CIRCUIT->ninputs, 1 + 1600 * (24 / kStride));
+
+  uint64_t st[5][5];
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      st[x][y] = 3 * x + 1000 * y;
+    }
+  }
+  auto W = std::make_unique<Dense<Field>>(1, CIRCUIT->ninputs);
+  fill_flat_input<kStride>(*W, st);
+
+  {
+    Prover<Field>::inputs pin;
+    Prover<Field> prover(F);
+    auto V = prover.eval_circuit(&pin, CIRCUIT.get(), W->clone(), F);
+    ASSERT_NE(V, nullptr);
+    for (size_t x = 0; x < 5; ++x) {
+      for (size_t y = 0; y < 5; ++y) {
+        for (size_t z = 0; z < 64; ++z) {
+          EXPECT_EQ(V->v_[z + 64 * (y + 5 * x)],
+                    L.eval(L.bit((st[x][y] >> z) & 1)).elt());
+        }
+      }
+    }
+    for (size_t i = 1600; i < V->n1_; ++i) {
+      EXPECT_EQ(V->v_[i], F.zero());
+    }
+
+    Transcript tsp((uint8_t *)"test", 4);
+    Proof<Field> proof(CIRCUIT->nl);
+    prover.prove(&proof, nullptr, CIRCUIT.get(), pin, tsp);
+
+    const char *why = "ok";
+    Transcript tsv((uint8_t *)"test", 4);
+    EXPECT_TRUE(Verifier<Field>::verify(&why, CIRCUIT.get(), &proof,
+                                        std::move(V), W->clone(), tsv, F));
+  }
+
+  // A wrong bit in the last witnessed state must be caught.
+  {
+    size_t bad = CIRCUIT->ninputs - 17;
+    W->v_[bad] = F.addf(W->v_[bad], F.one());
+    Prover<Field>::inputs pin;
+    Prover<Field> prover(F);
+    auto V = prover.eval_circuit(&pin, CIRCUIT.get(), W->clone(), F);
+    bool caught = (V == nullptr);
+    for (size_t i = 1600; V != nullptr && i < V->n1_; ++i) {
+      caught |= (V->v_[i] != F.zero());
+    }
+    EXPECT_TRUE(caught);
+  }
+}
+
+TEST(SHA3_Circuit, Keccak_F_1600_Flat1) { test_flat_keccak<1>(); }
+TEST(SHA3_Circuit, Keccak_F_1600_Flat4) { test_flat_keccak<4>(); }
+TEST(SHA3_Circuit, Keccak_F_1600_Flat12) { test_flat_keccak<12>(); }
+
+// ================ Benchmarks =================================================
+// Compare the flattened circuits against the unflattened one (KSTRIDE = 24).
+template <size_t kStride>
+void BM_Keccak_F_1600_Prover(benchmark::State& state) {
+  auto CIRCUIT = mk_flat_keccak_circuit<kStride>(1);
+  size_t nwires = 0;
+  for (const auto& layer : CIRCUIT->l) {
+    nwires += layer.nw;
+  }
+  state.counters["depth"] = CIRCUIT->nl;
+  state.counters["wires"] = nwires;
+  state.counters["terms"] = CIRCUIT->nterms();
+  state.counters["inputs"] = CIRCUIT->ninputs;
+
+  uint64_t st[5][5] = {};
+  auto W = std::make_unique<Dense<Field>>(1, CIRCUIT->ninputs);
+  fill_flat_input<kStride>(*W, st);
+
+  for (auto s : state) {
+    Prover<Field>::inputs pin;
+    Prover<Field> prover(F);
+    auto V = prover.eval_circuit(&pin, CIRCUIT.get(), W->clone(), F);
+    Transcript tsp((uint8_t *)"test", 4);
+    Proof<Field> proof(CIRCUIT->nl);
+    prover.prove(&proof, nullptr, CIRCUIT.get(), pin, tsp);
+  }
+}
+BENCHMARK_TEMPLATE(BM_Keccak_F_1600_Prover, 24);
+BENCHMARK_TEMPLATE(BM_Keccak_F_1600_Prover, 12);
+BENCHMARK_TEMPLATE(BM_Keccak_F_1600_Prover, 4);
+BENCHMARK_TEMPLATE(BM_Keccak_F_1600_Prover, 2);
+BENCHMARK_TEMPLATE(BM_Keccak_F_1600_Prover, 1);
+
 }  // namespace
 }  // namespace proofs
@@ -28,49 +28,53 @@ void Sha3Reference::keccak_f_1600_DEBUG_ONLY(uint64_t A[5][5]) {
   return keccak_f_1600(A);
 }
 
-void Sha3Reference::keccak_f_1600(uint64_t A[5][5]) {
-  for (size_t round = 0; round < 24; ++round) {
-    // FIPS 202 3.2.1, theta
-    uint64_t C[5];
-    for (size_t x = 0; x < 5; ++x) {
-      C[x] = A[x][0] ^ A[x][1] ^ A[x][2] ^ A[x][3] ^ A[x][4];
-    }
+void Sha3Reference::keccak_round(uint64_t A[5][5], size_t round) {
+  // FIPS 202 3.2.1, theta
+  uint64_t C[5];
+  for (size_t x = 0; x < 5; ++x) {
+    C[x] = A[x][0] ^ A[x][1] ^ A[x][2] ^ A[x][3] ^ A[x][4];
+  }
 
-    for (size_t x = 0; x < 5; ++x) {
-      uint64_t D_x = C[(x + 4) % 5] ^ rotl(C[(x + 1) % 5], 1);
-      for (size_t y = 0; y < 5; ++y) {
-        A[x][y] ^= D_x;
-      }
+  for (size_t x = 0; x < 5; ++x) {
+    uint64_t D_x = C[(x + 4) % 5] ^ rotl(C[(x + 1) % 5], 1);
+    for (size_t y = 0; y < 5; ++y) {
+      A[x][y] ^= D_x;
     }
+  }
 
-    // FIPS 202 3.2.2, rho
-    {
-      size_t x = 1, y = 0;
-      for (size_t t = 0; t < 24; ++t) {
-        A[x][y] = rotl(A[x][y], sha3_rotc[t]);
-        size_t nx = y, ny = (2 * x + 3 * y) % 5;
-        x = nx;
-        y = ny;
-      }
+  // FIPS 202 3.2.2, rho
+  {
+    size_t x = 1, y = 0;
+    for (size_t t = 0; t < 24; ++t) {
+      A[x][y] = rotl(A[x][y], sha3_rotc[t]);
+      size_t nx = y, ny = (2 * x + 3 * y) % 5;
+      x = nx;
+      y = ny;
     }
+  }
 
-    // FIPS 202 3.2.3, pi
-    uint64_t A1[5][5];
-    for (size_t x = 0; x < 5; ++x) {
-      for (size_t y = 0; y < 5; ++y) {
-        A1[x][y] = A[(x + 3 * y) % 5][x];
-      }
+  // FIPS 202 3.2.3, pi
+  uint64_t A1[5][5];
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      A1[x][y] = A[(x + 3 * y) % 5][x];
     }
+  }
 
-    // FIPS 202 3.2.4, chi
-    for (size_t x = 0; x < 5; ++x) {
-      for (size_t y = 0; y < 5; ++y) {
-        A[x][y] = A1[x][y] ^ ((~A1[(x + 1) % 5][y]) & A1[(x + 2) % 5][y]);
-      }
+  // FIPS 202 3.2.4, chi
+  for (size_t x = 0; x < 5; ++x) {
+    for (size_t y = 0; y < 5; ++y) {
+      A[x][y] = A1[x][y] ^ ((~A1[(x + 1) % 5][y]) & A1[(x + 2) % 5][y]);
     }
+  }
+
+  // FIPS 202 3.2.5, iota
+  A[0][0] ^= sha3_rc[round];
+}
 
-    // FIPS 202 3.2.5, iota
-    A[0][0] ^= sha3_rc[round];
+void Sha3Reference::keccak_f_1600(uint64_t A[5][5]) {
+  for (size_t round = 0; round < 24; ++round) {
+    keccak_round(A, round);
   }
 }
 
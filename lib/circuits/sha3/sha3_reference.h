@@ -41,6 +41,10 @@ class Sha3Reference {
   void final(uint8_t digest[/*mdlen*/]);
 
   static void keccak_f_1600_DEBUG_ONLY(uint64_t A[5][5]);
+
+  // Apply round ROUND of keccak_f_1600 to A.  Shared with the witness
+  // generator, which needs the states between rounds.
+  static void keccak_round(uint64_t A[5][5], size_t round);
 };
 }  // namespace proofs
 #endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_SHA3_SHA3_REFERENCE_H_
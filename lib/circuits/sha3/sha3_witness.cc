@@ -0,0 +1,42 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "circuits/sha3/sha3_witness.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "circuits/sha3/sha3_reference.h"
+#include "util/panic.h"
+
+namespace proofs {
+
+void Sha3Witness::keccak_f_1600_and_witness(uint64_t A[5][5], size_t stride,
+                                            uint64_t W[][5][5]) {
+  check(stride > 0 && stride < 24 && 24 % stride == 0,
+        "stride must be a proper divisor of 24");
+  for (size_t round = 0; round < 24; ++round) {
+    Sha3Reference::keccak_round(A, round);
+    if ((round + 1) % stride == 0 && round + 1 < 24) {
+      uint64_t(*w)[5] = W[(round + 1) / stride - 1];
+      for (size_t x = 0; x < 5; ++x) {
+        for (size_t y = 0; y < 5; ++y) {
+          w[x][y] = A[x][y];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace proofs
@@ -0,0 +1,36 @@
+// Copyright 2025 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PRIVACY_PROOFS_ZK_LIB_CIRCUITS_SHA3_SHA3_WITNESS_H_
+#define PRIVACY_PROOFS_ZK_LIB_CIRCUITS_SHA3_SHA3_WITNESS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace proofs {
+
+// Witness generator for Sha3Circuit::keccak_f_1600_flat().
+class Sha3Witness {
+ public:
+  // Apply keccak_f_1600 to A, and store the state after rounds
+  // STRIDE, 2*STRIDE, ..., 24-STRIDE into W[0], W[1], ..., i.e.,
+  // 24/STRIDE - 1 states in total.  STRIDE must be a proper divisor
+  // of 24.
+  static void keccak_f_1600_and_witness(uint64_t A[5][5], size_t stride,
+                                        uint64_t W[/*24/stride-1*/][5][5]);
+};
+
+}  // namespace proofs
+
+#endif  // PRIVACY_PROOFS_ZK_LIB_CIRCUITS_SHA3_SHA3_WITNESS_H_
@@ -17,11 +17,21 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "algebra/nat.h"
+#include "algebra/utility.h"
 #include "util/panic.h"
 
 namespace proofs {
+
+// The shape of the coefficient a of the curve y^2 = x^3 + ax + b, which
+// selects the addition and doubling formulas.  With kAnyA, the special
+// cases a = 0 and a = -3 are detected when the curve is constructed and
+// dispatched at run time.  kZeroA and kMinus3A fix the formulas at
+// compile time, and the constructor checks that a has the given shape.
+enum CurveShape { kAnyA, kZeroA, kMinus3A };
+
 // Elliptic curve class that supports basic operations such as addition,
 // doubling. The algorithms are described in
 // https://eprint.iacr.org/2015/1060.pdf.
@@ -30,7 +40,8 @@ namespace proofs {
 // digits of the coordinate field prime in base-10 to name a curve.
 // The kN template parameter describes the number of bits in the curve
 // order, e.g., to handle curves like P-521, K-283, etc.
-template <class Field_, size_t W, size_t kN>
+// The kShape template parameter is described at CurveShape.
+template <class Field_, size_t W, size_t kN, CurveShape kShape = kAnyA>
 class EllipticCurve {
  public:
   using Field = Field_;
@@ -70,6 +81,8 @@ class EllipticCurve {
         k24b(F.mulf(F.of_scalar(24), b_)) {
     is_minus_3_a_ = (a_ == F.negf(k3));
     is_zero_a_ = (a_ == F.zero());
+    check(kShape != kZeroA || is_zero_a_, "curve shape requires a = 0");
+    check(kShape != kMinus3A || is_minus_3_a_, "curve shape requires a = -3");
   }
 
   // This equality method makes no assumptions about whether the inputs
@@ -120,6 +133,23 @@ class EllipticCurve {
     p.z = f_.one();
   }
 
+  // Same as normalize(p[i]) for 0 <= i < n, with a single field
+  // inversion by Montgomery's trick.
+  void batch_normalize(size_t n, ECPoint p[/*n*/]) const {
+    std::vector<Elt> z(n), zi(n);
+    for (size_t i = 0; i < n; ++i) {
+      z[i] = p[i].z;
+    }
+    AlgebraUtil<Field>::batch_invert_or_zero(n, zi.data(), z.data(), f_);
+    for (size_t i = 0; i < n; ++i) {
+      if (p[i].z != f_.zero()) {
+        f_.mul(p[i].x, zi[i]);
+        f_.mul(p[i].y, zi[i]);
+        p[i].z = f_.one();
+      }
+    }
+  }
+
   void addE(ECPoint& p3, const ECPoint& p2) const {
     addE(p3.x, p3.y, p3.z, p3.x, p3.y, p3.z, p2.x, p2.y, p2.z);
   }
@@ -172,6 +202,114 @@ class EllipticCurve {
     }
   }
 
+  // Computes p * scalar from the width-kWidth NAF of the scalar.  After
+  // 2^(kWidth-2) - 1 additions to tabulate the odd multiples of p, the
+  // method costs one doubling per bit of the scalar and, on average, one
+  // addition per kWidth + 1 bits, versus one addition per two bits for
+  // scalar_multf().  This method is not constant time.
+  template <size_t kWidth = 5>
+  ECPoint scalar_multf_wnaf(const ECPoint& p, const N& scalar) const {
+    int8_t naf[kNafDigits];
+    size_t len = wnaf<kWidth>(naf, scalar);
+    ECPoint tbl[size_t(1) << (kWidth - 2)];
+    odd_multiples<kWidth>(tbl, p);
+
+    ECPoint r = zero();
+    for (size_t i = len; i-- > 0;) {
+      doubleE(r);
+      add_digit(r, tbl, naf[i]);
+    }
+    return r;
+  }
+
+  // Computes p1 * s1 + p2 * s2, the shape of ECDSA verification, by
+  // interleaving the wNAF of the two scalars (Straus' method, a.k.a.
+  // Shamir's trick), so that both products share one chain of doublings.
+  // This method is not constant time.
+  template <size_t kWidth = 5>
+  ECPoint double_scalar_multf(const ECPoint& p1, const N& s1,
+                              const ECPoint& p2, const N& s2) const {
+    int8_t naf1[kNafDigits], naf2[kNafDigits];
+    size_t len1 = wnaf<kWidth>(naf1, s1);
+    size_t len2 = wnaf<kWidth>(naf2, s2);
+    ECPoint tbl1[size_t(1) << (kWidth - 2)], tbl2[size_t(1) << (kWidth - 2)];
+    odd_multiples<kWidth>(tbl1, p1);
+    odd_multiples<kWidth>(tbl2, p2);
+
+    ECPoint r = zero();
+    for (size_t i = (len1 > len2 ? len1 : len2); i-- > 0;) {
+      doubleE(r);
+      if (i < len1) add_digit(r, tbl1, naf1[i]);
+      if (i < len2) add_digit(r, tbl2, naf2[i]);
+    }
+    return r;
+  }
+
+  // Table for fixed-base scalar multiplication by the comb method of
+  // Lim and Lee.  The kBits scalar bits are arranged in kTeeth rows of
+  // kSpacing = ceil(kBits / kTeeth) bits, and entry j of the table is
+  //    T[j] = SUM_{i : bit i of j is set} 2^(i * kSpacing) * base,
+  // in affine form.  A scalar multiplication then costs kSpacing
+  // doublings and kSpacing mixed additions, e.g., 32 + 32 for P-256 with
+  // kTeeth = 8, at the price of a table of 2^kTeeth points.
+  template <size_t kTeeth = 8>
+  class CombTable {
+   public:
+    static constexpr size_t kSpacing = (kBits + kTeeth - 1) / kTeeth;
+
+    CombTable(const EllipticCurve& ec, const ECPoint& base)
+        : ec_(ec), base_(base), tbl_(size_t(1) << kTeeth) {
+      ECPoint row = base;
+      tbl_[0] = ec.zero();
+      for (size_t i = 0; i < kTeeth; ++i) {
+        // row = 2^(i * kSpacing) * base
+        size_t bi = size_t(1) << i;
+        tbl_[bi] = row;
+        for (size_t j = 1; j < bi; ++j) {
+          tbl_[bi + j] = ec.addEf(tbl_[j], row);
+        }
+        for (size_t k = 0; k < kSpacing && i + 1 < kTeeth; ++k) {
+          ec.doubleE(row);
+        }
+      }
+
+      // Entries at infinity, if any, stay projective.
+      ec.batch_normalize(tbl_.size(), tbl_.data());
+    }
+
+    // Computes base * scalar.  Scalars of more than kBits bits fall back
+    // to scalar_multf_wnaf().
+    ECPoint scalar_multf(const N& scalar) const {
+      for (size_t i = kTeeth * kSpacing; i < kNatBits; ++i) {
+        if (scalar.bit(i)) {
+          return ec_.scalar_multf_wnaf(base_, scalar);
+        }
+      }
+
+      const Field& F = ec_.f_;
+      ECPoint r = ec_.zero();
+      for (size_t col = kSpacing; col-- > 0;) {
+        ec_.doubleE(r);
+        size_t j = 0;
+        for (size_t i = 0; i < kTeeth; ++i) {
+          j |= static_cast<size_t>(scalar.bit(i * kSpacing + col)) << i;
+        }
+        const ECPoint& t = tbl_[j];
+        if (t.z == F.one()) {
+          ec_.addEAffine(r.x, r.y, r.z, r.x, r.y, r.z, t.x, t.y);
+        } else if (j != 0) {
+          ec_.addE(r, t);
+        }
+      }
+      return r;
+    }
+
+   private:
+    const EllipticCurve& ec_;
+    ECPoint base_;
+    std::vector<ECPoint> tbl_;
+  };
+
   ECPoint zero() const { return ECPoint(f_.zero(), f_.one(), f_.zero()); }
   ECPoint generator() const { return ECPoint(gx_, gy_, gz_); }
 
@@ -186,8 +324,8 @@ class EllipticCurve {
   void addE(Elt& X3o, Elt& Y3o, Elt& Z3o, const Elt& X1, const Elt& Y1,
             const Elt& Z1, const Elt& X2, const Elt& Y2, const Elt& Z2) const {
     // Optimized special cases.
-    if (is_zero_a_) return addEZeroA(X3o, Y3o, Z3o, X1, Y1, Z1, X2, Y2, Z2);
-    if (is_minus_3_a_)
+    if (zero_a()) return addEZeroA(X3o, Y3o, Z3o, X1, Y1, Z1, X2, Y2, Z2);
+    if (minus_3_a())
       return addEMinus3A(X3o, Y3o, Z3o, X1, Y1, Z1, X2, Y2, Z2);
 
     /*
@@ -249,8 +387,8 @@ class EllipticCurve {
   void doubleE(Elt& X3o, Elt& Y3o, Elt& Z3o, const Elt& X, const Elt& Y,
                const Elt& Z) const {
     // Optimized special cases.
-    if (is_zero_a_) return doubleEZeroA(X3o, Y3o, Z3o, X, Y, Z);
-    if (is_minus_3_a_) return doubleEMinus3A(X3o, Y3o, Z3o, X, Y, Z);
+    if (zero_a()) return doubleEZeroA(X3o, Y3o, Z3o, X, Y, Z);
+    if (minus_3_a()) return doubleEMinus3A(X3o, Y3o, Z3o, X, Y, Z);
 
     /*
     // 1998 Cohen–Miyaji–Ono "Efficient elliptic curve exponentiation using
@@ -296,6 +434,57 @@ class EllipticCurve {
     Z3o = Z3;
   }
 
+  // Same result as addE(X3o, Y3o, Z3o, X1, Y1, Z1, X2, Y2, 1), i.e.,
+  // the second point is affine.  For a = -3, Algorithm 4 below
+  // with Z2 = 1 substituted saves one multiplication; the output is
+  // the same projective triple, not merely the same point, which
+  // matters to callers that replay addE() in a circuit.
+  void addEAffine(Elt& X3o, Elt& Y3o, Elt& Z3o, const Elt& X1, const Elt& Y1,
+                  const Elt& Z1, const Elt& X2, const Elt& Y2) const {
+    if (!minus_3_a()) {
+      return addE(X3o, Y3o, Z3o, X1, Y1, Z1, X2, Y2, f_.one());
+    }
+    Elt t0 = f_.mulf(X1, X2);
+    Elt t1 = f_.mulf(Y1, Y2);
+    const Elt& t2z = Z1;
+    Elt t3 = f_.addf(X1, Y1);
+    Elt t4 = f_.addf(X2, Y2);
+    t3 = f_.mulf(t3, t4);
+    t4 = f_.addf(t0, t1);
+    t3 = f_.subf(t3, t4);
+    t4 = f_.addf(f_.mulf(Y2, Z1), Y1);
+    Elt Y3 = f_.addf(f_.mulf(X2, Z1), X1);
+    Elt Z3 = f_.mulf(b_, t2z);
+    Elt X3 = f_.subf(Y3, Z3);
+    Z3 = f_.addf(X3, X3);
+    X3 = f_.addf(X3, Z3);
+    Z3 = f_.subf(t1, X3);
+    X3 = f_.addf(t1, X3);
+    Y3 = f_.mulf(b_, Y3);
+    t1 = f_.addf(t2z, t2z);
+    Elt t2 = f_.addf(t1, t2z);
+    Y3 = f_.subf(Y3, t2);
+    Y3 = f_.subf(Y3, t0);
+    t1 = f_.addf(Y3, Y3);
+    Y3 = f_.addf(t1, Y3);
+    t1 = f_.addf(t0, t0);
+    t0 = f_.addf(t1, t0);
+    t0 = f_.subf(t0, t2);
+    t1 = f_.mulf(t4, Y3);
+    t2 = f_.mulf(t0, Y3);
+    Y3 = f_.mulf(X3, Z3);
+    Y3 = f_.addf(Y3, t2);
+    X3 = f_.mulf(t3, X3);
+    X3 = f_.subf(X3, t1);
+    Z3 = f_.mulf(t4, Z3);
+    t1 = f_.mulf(t3, t0);
+    Z3 = f_.addf(Z3, t1);
+
+    X3o = X3;
+    Y3o = Y3;
+    Z3o = Z3;
+  }
+
  private:
   /* From Algorithm 7: Complete, projective point addition for prime order
     j-invariant 0 short Weierstrass curves E/Fq : y^2 = x^3 + b.
@@ -450,6 +639,68 @@ class EllipticCurve {
     Z3o = f_.mulf(k8, f_.mulf(t1, t4));
   }
 
+  //------------------------------------------------------------
+  // Windowed NAF recoding.
+
+  static constexpr size_t kNatBits = N::kLimbs * N::kBitsPerLimb;
+
+  // The wNAF of a kNatBits scalar may carry into one extra digit.
+  static constexpr size_t kNafDigits = kNatBits + 1;
+
+  // Writes the width-kWidth NAF of SCALAR into naf[0..len), where len is
+  // the returned value, so that scalar = SUM_i naf[i] 2^i.  Each nonzero
+  // digit is odd and in (-2^(kWidth-1), 2^(kWidth-1)), and is followed by
+  // at least kWidth - 1 zero digits.  This is the carry-based recoding of
+  // libsecp256k1, which reads the scalar without modifying it.
+  template <size_t kWidth>
+  static size_t wnaf(int8_t naf[/*kNafDigits*/], const N& scalar) {
+    static_assert(kWidth >= 2 && kWidth <= 7, "unsupported wNAF width");
+    size_t len = 0;
+    uint32_t carry = 0;
+    for (size_t bit = 0; bit < kNafDigits;) {
+      naf[bit] = 0;
+      if (scalar.bit(bit) == carry) {
+        ++bit;
+        continue;
+      }
+      size_t now = kWidth;
+      if (now > kNafDigits - bit) now = kNafDigits - bit;
+      uint32_t word = carry;
+      for (size_t k = 0; k < now; ++k) {
+        word += static_cast<uint32_t>(scalar.bit(bit + k)) << k;
+      }
+      carry = (word >> (kWidth - 1)) & 1;
+      naf[bit] = static_cast<int8_t>(static_cast<int32_t>(word) -
+                                     static_cast<int32_t>(carry << kWidth));
+      for (size_t k = 1; k < now; ++k) {
+        naf[bit + k] = 0;
+      }
+      bit += now;
+      len = bit - now + 1;
+    }
+    return len;
+  }
+
+  // tbl[k] = (2k + 1) * p for 0 <= k < 2^(kWidth-2).
+  template <size_t kWidth>
+  void odd_multiples(ECPoint tbl[/*2^(kWidth-2)*/], const ECPoint& p) const {
+    ECPoint p2 = doubleEf(p);
+    tbl[0] = p;
+    for (size_t k = 1; k < (size_t(1) << (kWidth - 2)); ++k) {
+      tbl[k] = addEf(tbl[k - 1], p2);
+    }
+  }
+
+  // r += d * p, where tbl holds the odd multiples of p.
+  void add_digit(ECPoint& r, const ECPoint tbl[], int8_t d) const {
+    if (d > 0) {
+      addE(r, tbl[(d - 1) / 2]);
+    } else if (d < 0) {
+      const ECPoint& t = tbl[(-d - 1) / 2];
+      addE(r, ECPoint(t.x, f_.negf(t.y), t.z));
+    }
+  }
+
   //------------------------------------------------------------
   // Multi-exponentiation SUM_i scalarMult(p[i], s[i])
 
@@ -588,6 +839,14 @@ class EllipticCurve {
     return res;
   }
 
+  // The formulas to use, folded at compile time unless kShape = kAnyA.
+  bool zero_a() const {
+    return kShape == kZeroA || (kShape == kAnyA && is_zero_a_);
+  }
+  bool minus_3_a() const {
+    return kShape == kMinus3A || (kShape == kAnyA && is_minus_3_a_);
+  }
+
   bool is_zero_a_;
   bool is_minus_3_a_;
 };
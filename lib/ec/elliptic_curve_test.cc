@@ -44,7 +44,8 @@ const Field secp_base(
 
 typedef EllipticCurve<Field, 4, 256> EC32543;
 typedef EllipticCurve<Field, 4, 256> EC53951;
-typedef EllipticCurve<Field, 4, 256> SECP256K1;
+typedef EllipticCurve<Field, 4, 256, kZeroA> SECP256K1;
+typedef EllipticCurve<Field, 4, 256, kMinus3A> EC53951Minus3A;
 
 // The following curve from https://arxiv.org/pdf/2208.01635.pdf has prime
 // order =
@@ -225,6 +226,30 @@ TEST(EllipticCurve, addEMinus3A) {
   EXPECT_TRUE(ec_53951.equal(want, got));
 }
 
+// addEAffine() must produce the same projective triple as addE().
+TEST(EllipticCurve, addEAffineMinus3A) {
+  auto p = ec_53951.point(
+      f_53951.of_string("565152197906911714131090579040116886954248101558029299"
+                        "73526481321309856242040"),
+      f_53951.of_string("337703184371225825922371145149145259808867551975154856"
+                        "7112458094635497583569"));
+  auto q = ec_53951.point(
+      f_53951.of_string("112408679900023231809246133755790494075208376728748483"
+                        "995370618426422155115628"),
+      f_53951.of_string("498237100143848652850565955106356993462945737819513433"
+                        "11221423895961832974253"));
+  // first operands with z != 1, the identity, and q itself
+  auto p2 = ec_53951.doubleEf(ec_53951.addEf(p, q));
+  for (const auto& a : {p, p2, q, ec_53951.zero(), ec_53951.addEf(q, p2)}) {
+    auto want = ec_53951.addEf(a, q);
+    decltype(want) got;
+    ec_53951.addEAffine(got.x, got.y, got.z, a.x, a.y, a.z, q.x, q.y);
+    EXPECT_EQ(want.x, got.x);
+    EXPECT_EQ(want.y, got.y);
+    EXPECT_EQ(want.z, got.z);
+  }
+}
+
 // Test with secp256r1 curve where a = -3.
 TEST(EllipticCurve, doubleEMinus3A) {
   auto p1 = ec_53951.point(
@@ -395,6 +420,114 @@ TEST(EllipticCurve, P256MultiExponentiation) {
   }
 }
 
+template <class EC>
+void test_fast_scalar_mult(const EC& ec) {
+  using N = typename EC::N;
+  std::mt19937 rng;
+  std::uniform_int_distribution<uint64_t> dist;
+  auto random_nat = [&]() {
+    std::array<uint64_t, N::kU64> init;
+    for (size_t j = 0; j < N::kU64; ++j) {
+      init[j] = dist(rng);
+    }
+    return N(init);
+  };
+
+  std::vector<N> scalars = {N(0), N(1), N(2), N(31), N(0xdeadbeefabadcafe),
+                            N(std::array<uint64_t, N::kU64>{~0ull, ~0ull,
+                                                            ~0ull, ~0ull})};
+  for (size_t i = 0; i < 20; ++i) {
+    scalars.push_back(random_nat());
+  }
+
+  const typename EC::template CombTable<> comb(ec, ec.generator());
+  const typename EC::template CombTable<5> comb5(ec, ec.generator());
+  auto q = ec.scalar_multf(ec.generator(), random_nat());
+  for (const N& s : scalars) {
+    auto want = ec.scalar_multf(ec.generator(), s);
+    EXPECT_TRUE(ec.equal(want, ec.scalar_multf_wnaf(ec.generator(), s)));
+    EXPECT_TRUE(ec.equal(want, ec.template scalar_multf_wnaf<2>(
+                                   ec.generator(), s)));
+    EXPECT_TRUE(ec.equal(want, ec.template scalar_multf_wnaf<7>(
+                                   ec.generator(), s)));
+    EXPECT_TRUE(ec.equal(want, comb.scalar_multf(s)));
+    EXPECT_TRUE(ec.equal(want, comb5.scalar_multf(s)));
+
+    for (const N& t : {N(0), N(1), random_nat()}) {
+      auto want2 = ec.addEf(want, ec.scalar_multf(q, t));
+      EXPECT_TRUE(
+          ec.equal(want2, ec.double_scalar_multf(ec.generator(), s, q, t)));
+      EXPECT_TRUE(
+          ec.equal(want2, ec.double_scalar_multf(q, t, ec.generator(), s)));
+    }
+  }
+}
+
+TEST(EllipticCurve, FastScalarMultMinus3A) { test_fast_scalar_mult(p256); }
+TEST(EllipticCurve, FastScalarMultZeroA) { test_fast_scalar_mult(secp256k1); }
+TEST(EllipticCurve, FastScalarMultGeneral) { test_fast_scalar_mult(ec_32543); }
+
+TEST(EllipticCurve, P256GeneratorTable) {
+  // n * G = 0 and (n - 1) * G = -G.
+  auto inf = p256_generator_table().scalar_multf(n256_order);
+  EXPECT_TRUE(p256.equal(p256.zero(), inf));
+  P256::N nm1 = n256_order;
+  nm1.sub(P256::N(1));
+  auto mg = p256_generator_table().scalar_multf(nm1);
+  auto g = p256.generator();
+  EXPECT_TRUE(p256.equal(p256.zero(), p256.addEf(mg, g)));
+}
+
+TEST(EllipticCurve, CurveShape) {
+  // The same curve, with the a = -3 formulas selected at run time and at
+  // compile time, must produce the same projective triples.
+  const EC53951Minus3A ec(ec_53951.a_, ec_53951.b_, ec_53951.gx_,
+                          ec_53951.gy_, f_53951);
+  auto p = ec_53951.generator();
+  auto q = ec.generator();
+  auto p2 = ec_53951.doubleEf(p);
+  auto q2 = ec.doubleEf(q);
+  for (size_t i = 0; i < 100; ++i) {
+    ec_53951.addE(p, p2);
+    ec.addE(q, q2);
+    ec_53951.doubleE(p2);
+    ec.doubleE(q2);
+    EXPECT_EQ(p.x, q.x);
+    EXPECT_EQ(p.y, q.y);
+    EXPECT_EQ(p.z, q.z);
+    EXPECT_EQ(p2.x, q2.x);
+    EXPECT_EQ(p2.y, q2.y);
+    EXPECT_EQ(p2.z, q2.z);
+  }
+
+  EXPECT_DEATH(EC53951Minus3A(ec_32543.a_, ec_32543.b_, ec_32543.gx_,
+                              ec_32543.gy_, f_32543),
+               "a = -3");
+  EXPECT_DEATH(SECP256K1(ec_53951.a_, ec_53951.b_, ec_53951.gx_,
+                         ec_53951.gy_, f_53951),
+               "a = 0");
+}
+
+TEST(EllipticCurve, BatchNormalize) {
+  std::vector<P256::ECPoint> p(10);
+  p[0] = p256.generator();
+  for (size_t i = 1; i < p.size(); ++i) {
+    p[i] = p256.addEf(p256.doubleEf(p[i - 1]), p[0]);
+  }
+  p[4] = p256.zero();
+  std::vector<P256::ECPoint> want = p;
+  for (auto& w : want) {
+    p256.normalize(w);
+  }
+  p256.batch_normalize(p.size(), p.data());
+  for (size_t i = 0; i < p.size(); ++i) {
+    EXPECT_EQ(p[i].x, want[i].x);
+    EXPECT_EQ(p[i].y, want[i].y);
+    EXPECT_EQ(p[i].z, want[i].z);
+  }
+  EXPECT_TRUE(p256.equal(p[4], p256.zero()));
+}
+
 // ============================= Benchmarks ================================
 
 void BM_add_p256(benchmark::State& state) {
@@ -445,6 +578,95 @@ void BM_scalar(benchmark::State& state) {
 }
 BENCHMARK(BM_scalar);
 
+P256::N bm_p256_scalar(uint64_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<uint64_t> dist;
+  std::array<uint64_t, P256::N::kU64> init;
+  for (size_t j = 0; j < P256::N::kU64; ++j) {
+    init[j] = dist(rng);
+  }
+  return P256::N(init);
+}
+
+void BM_scalar_p256(benchmark::State& state) {
+  auto g = p256.generator();
+  auto n = bm_p256_scalar(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p256.scalar_multf(g, n));
+  }
+}
+BENCHMARK(BM_scalar_p256);
+
+void BM_scalar_wnaf_p256(benchmark::State& state) {
+  auto g = p256.generator();
+  auto n = bm_p256_scalar(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p256.scalar_multf_wnaf(g, n));
+  }
+}
+BENCHMARK(BM_scalar_wnaf_p256);
+
+void BM_scalar_comb_p256(benchmark::State& state) {
+  auto n = bm_p256_scalar(1);
+  const P256GeneratorTable& tbl = p256_generator_table();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tbl.scalar_multf(n));
+  }
+}
+BENCHMARK(BM_scalar_comb_p256);
+
+void BM_normalize_p256(benchmark::State& state) {
+  std::vector<P256::ECPoint> p(state.range(0));
+  p[0] = p256.generator();
+  for (size_t i = 1; i < p.size(); ++i) {
+    p[i] = p256.addEf(p256.doubleEf(p[i - 1]), p[0]);
+  }
+  for (auto _ : state) {
+    std::vector<P256::ECPoint> q = p;
+    for (auto& x : q) {
+      p256.normalize(x);
+    }
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK(BM_normalize_p256)->Arg(64);
+
+void BM_batch_normalize_p256(benchmark::State& state) {
+  std::vector<P256::ECPoint> p(state.range(0));
+  p[0] = p256.generator();
+  for (size_t i = 1; i < p.size(); ++i) {
+    p[i] = p256.addEf(p256.doubleEf(p[i - 1]), p[0]);
+  }
+  for (auto _ : state) {
+    std::vector<P256::ECPoint> q = p;
+    p256.batch_normalize(q.size(), q.data());
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK(BM_batch_normalize_p256)->Arg(64);
+
+// u1 * G + u2 * Q, as in ECDSA verification.
+void BM_double_scalar_bos_coster_p256(benchmark::State& state) {
+  auto q = p256.scalar_multf(p256.generator(), bm_p256_scalar(2));
+  P256::N u1 = bm_p256_scalar(3), u2 = bm_p256_scalar(4);
+  for (auto _ : state) {
+    P256::ECPoint p[2] = {p256.generator(), q};
+    P256::N s[2] = {u1, u2};
+    benchmark::DoNotOptimize(p256.scalar_multf(2, p, s));
+  }
+}
+BENCHMARK(BM_double_scalar_bos_coster_p256);
+
+void BM_double_scalar_straus_p256(benchmark::State& state) {
+  auto q = p256.scalar_multf(p256.generator(), bm_p256_scalar(2));
+  P256::N u1 = bm_p256_scalar(3), u2 = bm_p256_scalar(4);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        p256.double_scalar_multf(p256.generator(), u1, q, u2));
+  }
+}
+BENCHMARK(BM_double_scalar_straus_p256);
+
 void BM_commit(benchmark::State& state) {
   auto p = ec_32543.point(
       f_32543.of_string("104494200016653967385948977022237419181744316220626192"
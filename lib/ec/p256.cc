@@ -33,4 +33,10 @@ const P256 p256(
                         "71877198253568414405109"), /* generator y coordinate */
     p256_base);
 
+const P256GeneratorTable& p256_generator_table() {
+  static const P256GeneratorTable* tbl =
+      new P256GeneratorTable(p256, p256.generator());
+  return *tbl;
+}
+
 }  // namespace proofs
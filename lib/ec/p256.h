@@ -52,9 +52,14 @@ extern const Fp256Nat n256_order;
 // This field allows operations mod the order of the curve.
 extern const Fp256Scalar p256_scalar;
 
-typedef EllipticCurve<Fp256Base, 4, 256> P256;
+typedef EllipticCurve<Fp256Base, 4, 256, kMinus3A> P256;
 
 extern const P256 p256;
+
+// Comb table for multiplications of the generator of P256, built on
+// first use.
+using P256GeneratorTable = P256::CombTable<8>;
+const P256GeneratorTable& p256_generator_table();
 }  // namespace proofs
 
 #endif  // PRIVACY_PROOFS_ZK_LIB_EC_P256_H_
@@ -113,15 +113,36 @@
 
 namespace proofs {
 
+// Largest supported number of proof-of-work bits.  Bounds the work of an
+// honest prover, which is 2^GRIND_BITS hashes on average.
+constexpr size_t kLigeroMaxGrindBits = 32;
+
+// Return the number of opened columns that, together with GRIND_BITS
+// bits of proof of work, achieves the same conjectured soundness as
+// NREQ columns without proof of work, where NREQ columns provide
+// SOUNDNESS_BITS bits.
+//
+// The soundness of the column check is (1 - delta)^NREQ for some
+// distance delta that depends on the code, i.e., each column
+// contributes SOUNDNESS_BITS / NREQ bits.  Grinding multiplies the
+// cost of each attempt of a cheating prover by 2^GRIND_BITS, and thus
+// replaces GRIND_BITS bits of column soundness.
+inline size_t ligero_nreq_with_grinding(size_t nreq, size_t soundness_bits,
+                                        size_t grind_bits) {
+  check(grind_bits < soundness_bits, "grind_bits < soundness_bits");
+  return ceildiv((soundness_bits - grind_bits) * nreq, soundness_bits);
+}
+
 template <class Field>
 struct LigeroParam {
   using Elt = typename Field::Elt;
 
   // parameters passed by the user
-  size_t nw;       // total number of witnesses
-  size_t nq;       // total number of quadratic constraints
-  size_t rateinv;  // inverse rate of the error-correcting code
-  size_t nreq;     // number of opened columns
+  size_t nw;          // total number of witnesses
+  size_t nq;          // total number of quadratic constraints
+  size_t rateinv;     // inverse rate of the error-correcting code
+  size_t nreq;        // number of opened columns
+  size_t grind_bits;  // proof-of-work bits before choosing the columns
 
   // computed parameters
   size_t block_enc;   // total number of elts per row
@@ -150,7 +171,7 @@ struct LigeroParam {
   // a parameter in ZkSpecStruct.
   // TODO(shelat): Remove this constructor once version 3 is deprecated.
   LigeroParam(size_t nw, size_t nq, size_t rateinv, size_t nreq)
-      : nw(nw), nq(nq), rateinv(rateinv), nreq(nreq) {
+      : nw(nw), nq(nq), rateinv(rateinv), nreq(nreq), grind_bits(0) {
     r = nreq;
 
     size_t min_proof_size = SIZE_MAX;
@@ -170,8 +191,15 @@ struct LigeroParam {
 
   // Constructor that accepts a pre-computed block_enc.
   LigeroParam(size_t nw, size_t nq, size_t rateinv, size_t nreq,
-              size_t be)
-      : nw(nw), nq(nq), rateinv(rateinv), nreq(nreq), block_enc(be) {
+              size_t be, size_t grind_bits = 0)
+      : nw(nw),
+        nq(nq),
+        rateinv(rateinv),
+        nreq(nreq),
+        grind_bits(grind_bits),
+        block_enc(be) {
+    check(grind_bits <= kLigeroMaxGrindBits,
+          "grind_bits <= kLigeroMaxGrindBits");
     r = nreq;
     check(layout(block_enc) < SIZE_MAX, "block_enc too large");
     sanity();
@@ -286,6 +314,11 @@ struct LigeroParam {
     sz += static_cast<uint64_t>(nreq) *
           static_cast<uint64_t>(MerkleNonce::kLength);
 
+    // proof-of-work nonce
+    if (grind_bits > 0) {
+      sz += sizeof(uint64_t);
+    }
+
     // req.   Assume optimistically that all elements are in the subfield.
     sz += static_cast<uint64_t>(nrow) * static_cast<uint64_t>(nreq) *
           static_cast<uint64_t>(Field::kSubFieldBytes);
@@ -306,6 +339,39 @@ struct LigeroParam {
   }
 };
 
+// The costs of a Ligero proof that depend on the number of opened
+// columns, for comparing parameters with and without grinding.
+struct LigeroColumnCost {
+  size_t nreq;            // number of opened columns
+  size_t proof_bytes;     // estimated proof size, see LigeroParam::layout()
+  size_t column_elts;     // opened elements checked by the verifier
+  size_t merkle_hashes;   // estimated hashes to check the Merkle openings
+  uint64_t grind_hashes;  // expected prover hashes for the proof of work
+};
+
+// Parameter calculator: the column costs of a proof of NW witnesses and
+// NQ quadratic constraints with GRIND_BITS bits of proof of work, at the
+// same conjectured soundness as NREQ columns without grinding that
+// provide SOUNDNESS_BITS bits.  Uses the block_enc that minimizes the
+// proof size among the powers of two, as the legacy LigeroParam
+// constructor does.
+template <class Field>
+LigeroColumnCost ligero_column_cost(size_t nw, size_t nq, size_t rateinv,
+                                    size_t nreq, size_t soundness_bits,
+                                    size_t grind_bits) {
+  size_t n = ligero_nreq_with_grinding(nreq, soundness_bits, grind_bits);
+  LigeroParam<Field> lp(nw, nq, rateinv, n);
+  LigeroParam<Field> p(nw, nq, rateinv, n, lp.block_enc, grind_bits);
+  LigeroColumnCost c;
+  c.nreq = n;
+  c.proof_bytes = p.layout(p.block_enc);
+  c.column_elts = p.nrow * n;
+  c.merkle_hashes = p.mc_pathlen / 2 * n;
+  c.grind_hashes =
+      grind_bits == 0 ? 0 : static_cast<uint64_t>(1) << grind_bits;
+  return c;
+}
+
 template <class Field>
 struct LigeroCommitment {
   Digest root;
@@ -321,6 +387,7 @@ struct LigeroProof {
         block_enc(p->block_enc),
         nrow(p->nrow),
         nreq(p->nreq),
+        grind_bits(p->grind_bits),
         mc_pathlen(p->mc_pathlen),
         y_ldt(p->block),
         y_dot(p->dblock),
@@ -336,8 +403,10 @@ struct LigeroProof {
   size_t block_enc;
   size_t nrow;
   size_t nreq;
+  size_t grind_bits;
   size_t mc_pathlen;
 
+  uint64_t pow_nonce = 0;     // proof-of-work nonce, if grind_bits > 0
   std::vector<Elt> y_ldt;     // [block]
   std::vector<Elt> y_dot;     // [dblock]
   std::vector<Elt> y_quad_0;  // [r] first part of y_quad.
@@ -134,6 +134,9 @@ class LigeroProver {
 
     {
       std::vector<size_t> idx(p_.nreq);
+      // P -> V
+      proof.pow_nonce = LigeroTranscript<Field>::grind(p_, ts);
+
       // V -> P
       LigeroTranscript<Field>::gen_idx(&idx[0], p_, ts, F);
 
@@ -22,6 +22,7 @@
 #include "algebra/convolution.h"
 #include "algebra/fp.h"
 #include "algebra/reed_solomon.h"
+#include "benchmark/benchmark.h"
 #include "gf2k/gf2_128.h"
 #include "gf2k/lch14_reed_solomon.h"
 #include "ligero/ligero_param.h"
@@ -35,57 +36,47 @@
 namespace proofs {
 namespace {
 
-template <class Field, class ReedSolomonFactory>
-void ligero_test(const ReedSolomonFactory &rs_factory, const Field &F) {
+// NW random witnesses, with NQ quadratic constraints and NL linear
+// constraints that they satisfy.
+template <class Field>
+struct LigeroInstance {
   using Elt = typename Field::Elt;
-  set_log_level(INFO);
-  static const constexpr size_t nw = 300000;
-  static const constexpr size_t nq = 30000;
-  static const constexpr size_t nreq = 189;
-  static const constexpr size_t nl = 7;
-  LigeroParam<Field> param(nw, nq, /*rateinv=*/4, nreq);
-  log(INFO, "%zd %zd %zd %zd %zd %zd\n", param.r, param.w, param.block,
-      param.block_enc, param.nrow, param.nqtriples);
-
-  std::vector<Elt> W(nw);
-  std::vector<Elt> A(nw);
-  for (size_t i = 0; i < nw; ++i) {
-    W[i] = F.of_scalar_field(random());
-    A[i] = F.of_scalar_field(random());
-  }
 
-  // Set up semi-random quadratic constraints.  For simplicity
-  // of testing, say that the first NQ odd-index witnesses are
-  // the product of two even-index witnesses
-  std::vector<LigeroQuadraticConstraint> lqc(nq);
-  for (size_t i = 0; i < nq; ++i) {
-    lqc[i].z = 2 * i + 1;
-    lqc[i].x = 2 * ((random() % nw) / 2);
-    lqc[i].y = 2 * ((random() % nw) / 2);
-    W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
+  LigeroInstance(size_t nw, size_t nq, size_t nl, const Field &F)
+      : nl(nl), W(nw), lqc(nq), b(nl) {
+    std::vector<Elt> A(nw);
+    for (size_t i = 0; i < nw; ++i) {
+      W[i] = F.of_scalar_field(random());
+      A[i] = F.of_scalar_field(random());
+    }
+
+    // Set up semi-random quadratic constraints.  For simplicity
+    // of testing, say that the first NQ odd-index witnesses are
+    // the product of two even-index witnesses
+    for (size_t i = 0; i < nq; ++i) {
+      lqc[i].z = 2 * i + 1;
+      lqc[i].x = 2 * ((random() % nw) / 2);
+      lqc[i].y = 2 * ((random() % nw) / 2);
+      W[lqc[i].z] = F.mulf(W[lqc[i].x], W[lqc[i].y]);
+    }
+
+    // Generate NL linear constraints.
+    Blas<Field>::clear(nl, &b[0], 1, F);
+    for (size_t w = 0; w < nw; ++w) {
+      LigeroLinearConstraint<Field> term = {
+          w % nl,  // c
+          w,       // w
+          A[w],    // k
+      };
+      llterm.push_back(term);
+      F.add(b[term.c], F.mulf(W[w], term.k));
+    }
   }
 
-  // Generate NL linear constraints.
-  std::vector<LigeroLinearConstraint<Field>> llterm;
-  std::vector<Elt> b(nl);
-  Blas<Field>::clear(nl, &b[0], 1, F);
-  for (size_t w = 0; w < nw; ++w) {
-    LigeroLinearConstraint<Field> term = {
-        w % nl,  // c
-        w,       // w
-        A[w],    // k
-    };
-    llterm.push_back(term);
-    F.add(b[term.c], F.mulf(W[w], term.k));
-  }
-
-  LigeroCommitment<Field> commitment;
-  LigeroProof<Field> proof(&param);
-
-  const LigeroHash hash_of_llterm{0xde, 0xad, 0xbe, 0xef};
-
-  {
-    log(INFO, "start prover");
+  template <class ReedSolomonFactory>
+  void prove(const LigeroParam<Field> &param,
+             LigeroCommitment<Field> &commitment, LigeroProof<Field> &proof,
+             const ReedSolomonFactory &rs_factory, const Field &F) const {
     SecureRandomEngine rng;
     LigeroProver<Field, ReedSolomonFactory> prover(param);
     Transcript ts((uint8_t *)"test", 4);
@@ -93,20 +84,84 @@ void ligero_test(const ReedSolomonFactory &rs_factory, const Field &F) {
                   rs_factory, rng, F);
     prover.prove(proof, ts, nl, llterm.size(), &llterm[0], hash_of_llterm,
                  &lqc[0], rs_factory, F);
-    log(INFO, "end prover");
   }
 
-  {
-    log(INFO, "start verifier");
+  template <class ReedSolomonFactory>
+  bool verify(const char **why, const LigeroParam<Field> &param,
+              const LigeroCommitment<Field> &commitment,
+              const LigeroProof<Field> &proof,
+              const ReedSolomonFactory &rs_factory, const Field &F) const {
     Transcript ts((uint8_t *)"test", 4);
     LigeroVerifier<Field, ReedSolomonFactory>::receive_commitment(commitment,
                                                                   ts);
-    const char *why = "";
-    bool ok = LigeroVerifier<Field, ReedSolomonFactory>::verify(
-        &why, param, commitment, proof, ts, nl, llterm.size(), &llterm[0],
+    return LigeroVerifier<Field, ReedSolomonFactory>::verify(
+        why, param, commitment, proof, ts, nl, llterm.size(), &llterm[0],
         hash_of_llterm, &b[0], &lqc[0], rs_factory, F);
-    EXPECT_TRUE(ok);
-    log(INFO, "end verifier");
+  }
+
+  size_t nl;
+  std::vector<Elt> W;
+  std::vector<LigeroQuadraticConstraint> lqc;
+  std::vector<LigeroLinearConstraint<Field>> llterm;
+  std::vector<Elt> b;
+  const LigeroHash hash_of_llterm{0xde, 0xad, 0xbe, 0xef};
+};
+
+template <class Field, class ReedSolomonFactory>
+void ligero_test(const ReedSolomonFactory &rs_factory, const Field &F,
+                 size_t grind_bits = 0) {
+  set_log_level(INFO);
+  static const constexpr size_t nw = 300000;
+  static const constexpr size_t nq = 30000;
+  static const constexpr size_t nreq = 189;
+  static const constexpr size_t nl = 7;
+  const LigeroParam<Field> lp(nw, nq, /*rateinv=*/4, nreq);
+  const LigeroParam<Field> param(nw, nq, /*rateinv=*/4, nreq, lp.block_enc,
+                                 grind_bits);
+  log(INFO, "%zd %zd %zd %zd %zd %zd\n", param.r, param.w, param.block,
+      param.block_enc, param.nrow, param.nqtriples);
+
+  const LigeroInstance<Field> inst(nw, nq, nl, F);
+  LigeroCommitment<Field> commitment;
+  LigeroProof<Field> proof(&param);
+
+  log(INFO, "start prover");
+  inst.prove(param, commitment, proof, rs_factory, F);
+  log(INFO, "end prover");
+
+  log(INFO, "start verifier");
+  const char *why = "";
+  EXPECT_TRUE(inst.verify(&why, param, commitment, proof, rs_factory, F));
+  log(INFO, "end verifier");
+
+  if (grind_bits > 0) {
+    // A wrong proof-of-work nonce either fails the proof of work, or
+    // selects other columns than the opened ones.
+    LigeroProof<Field> bad = proof;
+    bad.pow_nonce ^= 1;
+    EXPECT_FALSE(inst.verify(&why, param, commitment, bad, rs_factory, F));
+  }
+
+  // Every response takes part in the column checks.
+  {
+    LigeroProof<Field> bad = proof;
+    F.add(bad.y_ldt[param.block - 1], F.one());
+    EXPECT_FALSE(inst.verify(&why, param, commitment, bad, rs_factory, F));
+  }
+  {
+    LigeroProof<Field> bad = proof;
+    F.add(bad.y_dot[param.dblock - 1], F.one());
+    EXPECT_FALSE(inst.verify(&why, param, commitment, bad, rs_factory, F));
+  }
+  {
+    LigeroProof<Field> bad = proof;
+    F.add(bad.y_quad_0[0], F.one());
+    EXPECT_FALSE(inst.verify(&why, param, commitment, bad, rs_factory, F));
+  }
+  {
+    LigeroProof<Field> bad = proof;
+    F.add(bad.y_quad_2[0], F.one());
+    EXPECT_FALSE(inst.verify(&why, param, commitment, bad, rs_factory, F));
   }
 }
 
@@ -132,5 +187,69 @@ TEST(Ligero, GF2_128) {
   ligero_test(rs_factory, F);
 }
 
+TEST(Ligero, GF2_128Grinding) {
+  using Field = GF2_128<>;
+  const Field F;
+  using ReedSolomonFactory = LCH14ReedSolomonFactory<Field>;
+  const ReedSolomonFactory rs_factory(F);
+
+  ligero_test(rs_factory, F, /*grind_bits=*/12);
+}
+
+TEST(Ligero, NreqWithGrinding) {
+  EXPECT_EQ(ligero_nreq_with_grinding(128, 86, 0), 128u);
+  EXPECT_EQ(ligero_nreq_with_grinding(128, 86, 20), 99u);
+  EXPECT_EQ(ligero_nreq_with_grinding(189, 100, 10), 171u);
+}
+
+// Report the savings of grinding at the scale of the mdoc hash circuit.
+TEST(Ligero, GrindingCalculator) {
+  using Field = GF2_128<>;
+  set_log_level(INFO);
+  LigeroColumnCost prev = ligero_column_cost<Field>(
+      300000, 30000, /*rateinv=*/4, /*nreq=*/128, /*soundness_bits=*/86, 0);
+  const LigeroColumnCost base = prev;
+  for (size_t g : {8, 12, 16, 20, 24}) {
+    LigeroColumnCost c =
+        ligero_column_cost<Field>(300000, 30000, 4, 128, 86, g);
+    log(INFO,
+        "grind %2zu: nreq %3zu  proof %zu bytes (%.1f%%)  column elts %zu "
+        "(%.1f%%)  merkle hashes %zu  prover hashes %llu",
+        g, c.nreq, c.proof_bytes,
+        100.0 * (1.0 - double(c.proof_bytes) / double(base.proof_bytes)),
+        c.column_elts,
+        100.0 * (1.0 - double(c.column_elts) / double(base.column_elts)),
+        c.merkle_hashes, static_cast<unsigned long long>(c.grind_hashes));
+    EXPECT_LT(c.nreq, prev.nreq);
+    EXPECT_LT(c.proof_bytes, prev.proof_bytes);
+    prev = c;
+  }
+}
+
+// Verifier time as a function of the grinding bits, at equal conjectured
+// soundness.
+void BM_LigeroVerifyGrinding(benchmark::State &state) {
+  using Field = GF2_128<>;
+  using ReedSolomonFactory = LCH14ReedSolomonFactory<Field>;
+  const Field F;
+  const ReedSolomonFactory rs_factory(F);
+  size_t grind_bits = state.range(0);
+  constexpr size_t nw = 1 << 16, nq = 1 << 12, nl = 7;
+  size_t nreq = ligero_nreq_with_grinding(128, 86, grind_bits);
+  const LigeroParam<Field> lp(nw, nq, /*rateinv=*/4, nreq);
+  const LigeroParam<Field> param(nw, nq, 4, nreq, lp.block_enc, grind_bits);
+
+  const LigeroInstance<Field> inst(nw, nq, nl, F);
+  LigeroCommitment<Field> commitment;
+  LigeroProof<Field> proof(&param);
+  inst.prove(param, commitment, proof, rs_factory, F);
+  for (auto s : state) {
+    const char *why = "";
+    benchmark::DoNotOptimize(
+        inst.verify(&why, param, commitment, proof, rs_factory, F));
+  }
+}
+BENCHMARK(BM_LigeroVerifyGrinding)->Arg(0)->Arg(16)->Arg(20);
+
 }  // namespace
 }  // namespace proofs
@@ -18,9 +18,13 @@
 #include <stddef.h>
 
 #include <array>
+#include <cstdint>
 
 #include "ligero/ligero_param.h"
 #include "random/transcript.h"
+#include "util/crypto.h"
+#include "util/panic.h"
+#include "util/serialization.h"
 
 namespace proofs {
 template <class Field>
@@ -54,6 +58,42 @@ class LigeroTranscript {
     ts.elt(u, p.nqtriples, F);
   }
 
+  // Proof of work before gen_idx().  The prover finds the least NONCE
+  // such that SHA-256(K || NONCE) starts with p.grind_bits zero bits,
+  // where K is the hash of the transcript so far, and appends NONCE to
+  // the transcript.  Does nothing if p.grind_bits == 0, so that the
+  // transcript is unchanged for parameters without grinding.
+  static uint64_t grind(const LigeroParam<Field>& p, Transcript& ts) {
+    uint64_t nonce = 0;
+    if (p.grind_bits > 0) {
+      uint8_t key[kSHA256DigestSize];
+      ts.get(key);
+      SHA256 prefix;
+      prefix.Update(key, sizeof(key));
+      while (!pow_ok(prefix, nonce, p.grind_bits)) {
+        check(++nonce != 0, "proof-of-work nonce overflow");
+      }
+      write_nonce(nonce, ts);
+    }
+    return nonce;
+  }
+
+  // Verifier side of grind(): one hash.
+  static bool check_grind(const LigeroParam<Field>& p, uint64_t nonce,
+                          Transcript& ts) {
+    if (p.grind_bits > 0) {
+      uint8_t key[kSHA256DigestSize];
+      ts.get(key);
+      SHA256 prefix;
+      prefix.Update(key, sizeof(key));
+      if (!pow_ok(prefix, nonce, p.grind_bits)) {
+        return false;
+      }
+      write_nonce(nonce, ts);
+    }
+    return true;
+  }
+
   // Choose p.nreq distinct naturals in [0, p.block_enc - p.dblock)
   static void gen_idx(size_t idx[/*p.nreq*/], const LigeroParam<Field>& p,
                       Transcript& ts, const Field& F) {
@@ -61,6 +101,27 @@ class LigeroTranscript {
     check(p.block_enc - p.dblock >= p.nreq, "p.block_enc - p.dblock >= p.nreq");
     ts.choose(idx, p.block_enc - p.dblock, p.nreq);
   }
+
+ private:
+  // Whether SHA-256(PREFIX || NONCE) starts with BITS zero bits.
+  static bool pow_ok(const SHA256& prefix, uint64_t nonce, size_t bits) {
+    SHA256 sha;
+    sha.CopyState(prefix);
+    sha.Update8(nonce);
+    uint8_t h[kSHA256DigestSize];
+    sha.DigestData(h);
+    size_t i = 0;
+    for (; bits >= 8; bits -= 8) {
+      if (h[i++] != 0) return false;
+    }
+    return (h[i] >> (8 - bits)) == 0;
+  }
+
+  static void write_nonce(uint64_t nonce, Transcript& ts) {
+    uint8_t buf[8];
+    u64_to_le(buf, nonce);
+    ts.write(buf, sizeof(buf));
+  }
 };
 }  // namespace proofs
 
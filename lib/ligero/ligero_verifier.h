@@ -80,6 +80,12 @@ class LigeroVerifier {
     ts.write(&proof.y_quad_0[0], 1, p.r, F);
     ts.write(&proof.y_quad_2[0], 1, p.dblock - p.block, F);
 
+    // P -> V
+    if (!LigeroTranscript<Field>::check_grind(p, proof.pow_nonce, ts)) {
+      *why = "proof-of-work check failed";
+      return false;
+    }
+
     // V -> P
     LigeroTranscript<Field>::gen_idx(&idx[0], p, ts, F);
 
@@ -105,10 +111,7 @@ class LigeroVerifier {
         return false;
       }
 
-      // check the putative value of the inner product
-      Elt want_dot = Blas<Field>::dot(nl, b, 1, &alphal[0], 1, F);
-      Elt proof_dot = Blas<Field>::dot1(p.w, &proof.y_dot[p.r], 1, F);
-      if (want_dot != proof_dot) {
+      if (!dot_product_check(p, proof, nl, b, &alphal[0], F)) {
         *why = "wrong dot product";
         return false;
       }
@@ -151,6 +154,93 @@ class LigeroVerifier {
                                             p.nreq, updhash);
   }
 
+  // Check the putative value of the inner product.
+  static bool dot_product_check(const LigeroParam<Field>& p,
+                                const LigeroProof<Field>& proof, size_t nl,
+                                const Elt b[/*nl*/], const Elt alphal[/*nl*/],
+                                const Field& F) {
+    Elt want_dot = Blas<Field>::dot(nl, b, 1, alphal, 1, F);
+    Elt proof_dot = Blas<Field>::dot1(p.w, &proof.y_dot[p.r], 1, F);
+    return want_dot == proof_dot;
+  }
+
+  // The opened columns of the ILDT blinding row with coefficient 1,
+  // plus all remaining rows with coefficient u_ldt[].
+  static void low_degree_columns(Elt yc[/*nreq*/], const LigeroParam<Field>& p,
+                                 const LigeroProof<Field>& proof,
+                                 const Elt u_ldt[/*nrow*/], const Field& F) {
+    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.ildt, 0), 1);
+    for (size_t i = 0; i < p.nwqrow; ++i) {
+      Blas<Field>::axpy(p.nreq, &yc[0], 1, u_ldt[i], &proof.req_at(i + p.iw, 0),
+                        1, F);
+    }
+  }
+
+  // The opened columns of the IDOT blinding row with coefficient 1,
+  // plus A[i] \otimes W[i] for all witness rows.
+  static void dot_columns(Elt yc[/*nreq*/], const LigeroParam<Field>& p,
+                          const LigeroProof<Field>& proof,
+                          const size_t idx[/*nreq*/],
+                          const Elt A[/*nwqrow, w*/],
+                          const InterpolatorFactory& interpolator,
+                          const Field& F) {
+    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.idot, 0), 1);
+
+    const auto interpA = interpolator.make(p.block, p.block_enc);
+
+    std::vector<Elt> Aext(p.block_enc);
+    std::vector<Elt> Areq(p.nreq);
+
+    for (size_t i = 0; i < p.nwqrow; ++i) {
+      LigeroCommon<Field>::layout_Aext(&Aext[0], p, i, &A[0], F);
+      interpA->interpolate(&Aext[0]);
+      Blas<Field>::gather(p.nreq, &Areq[0], &Aext[p.dblock], idx);
+
+      // Accumulate z += A[j] \otimes W[j].
+      Blas<Field>::vaxpy(p.nreq, &yc[0], 1, &Areq[0], 1,
+                         &proof.req_at(i + p.iw, 0), 1, F);
+    }
+  }
+
+  // The opened columns of the IQUAD blinding row with coefficient 1,
+  // plus u_quad[i] * (z[i] - x[i] * y[i]) for all quadratic triples.
+  static void quadratic_columns(Elt yc[/*nreq*/], const LigeroParam<Field>& p,
+                                const LigeroProof<Field>& proof,
+                                const Elt u_quad[/*nqtriples*/],
+                                const Field& F) {
+    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.iquad, 0), 1);
+
+    std::vector<Elt> tmp(p.nreq);
+    size_t iqx = p.iq;
+    size_t iqy = iqx + p.nqtriples;
+    size_t iqz = iqy + p.nqtriples;
+
+    for (size_t i = 0; i < p.nqtriples; ++i) {
+      // yc += u_quad[i] * (z[i] - x[i] * y[i])
+
+      // tmp = z[i]
+      Blas<Field>::copy(p.nreq, &tmp[0], 1, &proof.req_at(iqz + i, 0), 1);
+
+      // tmp -= x[i] \otimes y[i]
+      Blas<Field>::vymax(p.nreq, &tmp[0], 1, &proof.req_at(iqx + i, 0), 1,
+                         &proof.req_at(iqy + i, 0), 1, F);
+
+      // yc += u_quad[i] * tmp
+      Blas<Field>::axpy(p.nreq, &yc[0], 1, u_quad[i], &tmp[0], 1, F);
+    }
+  }
+
+  // reconstruct y_quad from the two parts in the proof
+  static void reconstruct_y_quad(Elt yquad[/*dblock*/],
+                                 const LigeroParam<Field>& p,
+                                 const LigeroProof<Field>& proof,
+                                 const Field& F) {
+    Blas<Field>::copy(p.r, &yquad[0], 1, &proof.y_quad_0[0], 1);
+    Blas<Field>::clear(p.w, &yquad[p.r], 1, F);
+    Blas<Field>::copy(p.dblock - p.block, &yquad[p.block], 1,
+                      &proof.y_quad_2[0], 1);
+  }
+
   static bool low_degree_check(const LigeroParam<Field>& p,
                                const LigeroProof<Field>& proof,
                                const size_t idx[/*nreq*/],
@@ -158,25 +248,13 @@ class LigeroVerifier {
                                const InterpolatorFactory& interpolator,
                                const Field& F) {
     std::vector<Elt> yc(p.nreq);
-
-    // the ILDT blinding row with coefficient 1
-    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.ildt, 0), 1);
-
-    // all remaining rows with coefficient u_ldt[]
-    for (size_t i = 0; i < p.nwqrow; ++i) {
-      Blas<Field>::axpy(p.nreq, &yc[0], 1, u_ldt[i], &proof.req_at(i + p.iw, 0),
-                        1, F);
-    }
+    low_degree_columns(&yc[0], p, proof, u_ldt, F);
 
     std::vector<Elt> yp(p.nreq);
     interpolate_req_columns(&yp[0], p, p.block, &proof.y_ldt[0], idx,
                             interpolator, F);
 
-    if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
-      return false;
-    }
-
-    return true;
+    return Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F);
   }
 
   static bool dot_check(const LigeroParam<Field>& p,
@@ -185,35 +263,13 @@ class LigeroVerifier {
                         const InterpolatorFactory& interpolator,
                         const Field& F) {
     std::vector<Elt> yc(p.nreq);
-
-    // the IDOT blinding row with coefficient 1
-    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.idot, 0), 1);
-
-    {
-      const auto interpA = interpolator.make(p.block, p.block_enc);
-
-      std::vector<Elt> Aext(p.block_enc);
-      std::vector<Elt> Areq(p.nreq);
-
-      for (size_t i = 0; i < p.nwqrow; ++i) {
-        LigeroCommon<Field>::layout_Aext(&Aext[0], p, i, &A[0], F);
-        interpA->interpolate(&Aext[0]);
-        Blas<Field>::gather(p.nreq, &Areq[0], &Aext[p.dblock], idx);
-
-        // Accumulate z += A[j] \otimes W[j].
-        Blas<Field>::vaxpy(p.nreq, &yc[0], 1, &Areq[0], 1,
-                           &proof.req_at(i + p.iw, 0), 1, F);
-      }
-    }
+    dot_columns(&yc[0], p, proof, idx, A, interpolator, F);
 
     std::vector<Elt> yp(p.nreq);
     interpolate_req_columns(&yp[0], p, p.dblock, &proof.y_dot[0], idx,
                             interpolator, F);
 
-    if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
-      return false;
-    }
-    return true;
+    return Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F);
   }
 
   static bool quadratic_check(const LigeroParam<Field>& p,
@@ -223,48 +279,17 @@ class LigeroVerifier {
                               const InterpolatorFactory& interpolator,
                               const Field& F) {
     std::vector<Elt> yc(p.nreq);
+    quadratic_columns(&yc[0], p, proof, u_quad, F);
 
-    // the IQUAD blinding row with coefficient 1
-    Blas<Field>::copy(p.nreq, &yc[0], 1, &proof.req_at(p.iquad, 0), 1);
-
-    {
-      std::vector<Elt> tmp(p.nreq);
-      size_t iqx = p.iq;
-      size_t iqy = iqx + p.nqtriples;
-      size_t iqz = iqy + p.nqtriples;
-
-      // all quadratic triples with coefficient u_ldt[]
-      for (size_t i = 0; i < p.nqtriples; ++i) {
-        // yc += u_quad[i] * (z[i] - x[i] * y[i])
-
-        // tmp = z[i]
-        Blas<Field>::copy(p.nreq, &tmp[0], 1, &proof.req_at(iqz + i, 0), 1);
-
-        // tmp -= x[i] \otimes y[i]
-        Blas<Field>::vymax(p.nreq, &tmp[0], 1, &proof.req_at(iqx + i, 0), 1,
-                           &proof.req_at(iqy + i, 0), 1, F);
-
-        // yc += u_quad[i] * tmp
-        Blas<Field>::axpy(p.nreq, &yc[0], 1, u_quad[i], &tmp[0], 1, F);
-      }
-    }
-
-    // reconstruct y_quad from the two parts in the proof
     std::vector<Elt> yquad(p.dblock);
-    Blas<Field>::copy(p.r, &yquad[0], 1, &proof.y_quad_0[0], 1);
-    Blas<Field>::clear(p.w, &yquad[p.r], 1, F);
-    Blas<Field>::copy(p.dblock - p.block, &yquad[p.block], 1,
-                      &proof.y_quad_2[0], 1);
+    reconstruct_y_quad(&yquad[0], p, proof, F);
 
     // interpolate y_quad at the opened columns
     std::vector<Elt> yp(p.nreq);
     interpolate_req_columns(&yp[0], p, p.dblock, &yquad[0], idx, interpolator,
                             F);
 
-    if (!Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F)) {
-      return false;
-    }
-    return true;
+    return Blas<Field>::equal(p.nreq, &yp[0], 1, &yc[0], 1, F);
   }
 };
 }  // namespace proofs
@@ -31,6 +31,7 @@
 #include "sumcheck/circuit_id.h"
 #include "sumcheck/quad.h"
 #include "util/ceildiv.h"
+#include "util/crypto.h"
 #include "util/panic.h"
 #include "util/readbuffer.h"
 
@@ -83,43 +84,17 @@ class CircuitRep {
 
   void to_bytes(const Circuit<Field>& sc_c, std::vector<uint8_t>& bytes) {
     EltHash eh(f_);
-    bytes.push_back(0x1);  // version
-    serialize_field_id(bytes, field_id_);
-    serialize_size(bytes, sc_c.nv);
-    serialize_size(bytes, sc_c.nc);
-    serialize_size(bytes, sc_c.npub_in);
-    serialize_size(bytes, sc_c.subfield_boundary);
-    serialize_size(bytes, sc_c.ninputs);
-    serialize_size(bytes, sc_c.l.size());
+    serialize_header(bytes, sc_c, sc_c.l.size());
 
     // Scan the circuit to generate the constant table. To keep one
     // scan, write the quad to a separate byte vector and later copy it.
     std::vector<uint8_t> quadb;
     quadb.reserve(1 << 24);
     for (const auto& layer : sc_c.l) {
-      serialize_size(quadb, layer.logw);
-      serialize_size(quadb, layer.nw);
-      serialize_size(quadb, layer.quad->n_);
-
-      QuadCorner prevg(0), prevh0(0), prevh1(0);
-      for (size_t i = 0; i < layer.quad->n_; ++i) {
-        serialize_index(quadb, layer.quad->c_[i].g, prevg);
-        prevg = layer.quad->c_[i].g;
-        serialize_index(quadb, layer.quad->c_[i].h[0], prevh0);
-        prevh0 = layer.quad->c_[i].h[0];
-        serialize_index(quadb, layer.quad->c_[i].h[1], prevh1);
-        prevh1 = layer.quad->c_[i].h[1];
-        serialize_num(quadb, eh.kstore(layer.quad->c_[i].v));
-      }
-    }
-
-    serialize_size(bytes, eh.constants_.size());
-    for (const auto& v : eh.constants_) {
-      uint8_t buf[Field::kBytes];
-      f_.to_bytes_field(buf, v);
-      bytes.insert(bytes.end(), buf, buf + Field::kBytes);
+      serialize_layer(quadb, layer, eh);
     }
 
+    serialize_constants(bytes, eh);
     bytes.insert(bytes.end(), quadb.begin(), quadb.end());
     bytes.insert(bytes.end(), sc_c.id, sc_c.id + 32);
   }
@@ -248,6 +223,47 @@ class CircuitRep {
   }
 
  private:
+  void serialize_header(std::vector<uint8_t>& bytes, const Circuit<Field>& c,
+                        size_t nl) const {
+    bytes.push_back(0x1);  // version
+    serialize_field_id(bytes, field_id_);
+    serialize_size(bytes, c.nv);
+    serialize_size(bytes, c.nc);
+    serialize_size(bytes, c.npub_in);
+    serialize_size(bytes, c.subfield_boundary);
+    serialize_size(bytes, c.ninputs);
+    serialize_size(bytes, nl);
+  }
+
+  template <class EH>
+  static void serialize_layer(std::vector<uint8_t>& quadb,
+                              const Layer<Field>& layer, EH& eh) {
+    serialize_size(quadb, layer.logw);
+    serialize_size(quadb, layer.nw);
+    serialize_size(quadb, layer.quad->n_);
+
+    QuadCorner prevg(0), prevh0(0), prevh1(0);
+    for (size_t i = 0; i < layer.quad->n_; ++i) {
+      serialize_index(quadb, layer.quad->c_[i].g, prevg);
+      prevg = layer.quad->c_[i].g;
+      serialize_index(quadb, layer.quad->c_[i].h[0], prevh0);
+      prevh0 = layer.quad->c_[i].h[0];
+      serialize_index(quadb, layer.quad->c_[i].h[1], prevh1);
+      prevh1 = layer.quad->c_[i].h[1];
+      serialize_num(quadb, eh.kstore(layer.quad->c_[i].v));
+    }
+  }
+
+  template <class EH>
+  void serialize_constants(std::vector<uint8_t>& bytes, const EH& eh) const {
+    serialize_size(bytes, eh.constants_.size());
+    for (const auto& v : eh.constants_) {
+      uint8_t buf[Field::kBytes];
+      f_.to_bytes_field(buf, v);
+      bytes.insert(bytes.end(), buf, buf + Field::kBytes);
+    }
+  }
+
   static constexpr uint64_t kMaxValue = (1ULL << (kBytesWritten * 8)) - 1;
 
   // Multiplies arguments and checks for overflow.
@@ -365,6 +381,56 @@ class CircuitRep {
 
   const Field& f_;
   FieldID field_id_;
+
+ public:
+  // Streaming serializer, to be used as the sink of
+  // QuadCircuit::mkcircuit(nc, sink).  Each layer is serialized and
+  // dropped as soon as the compiler emits it, and the circuit id is
+  // computed on the fly, so that the full Circuit never exists in
+  // memory.  finish() produces the same bytes as to_bytes() on the
+  // equivalent Circuit.
+  class LayerWriter {
+   public:
+    explicit LayerWriter(const CircuitRep& rep)
+        : rep_(rep), eh_(rep.f_), nl_(0) {}
+
+    // no copies
+    LayerWriter(const LayerWriter&) = delete;
+    LayerWriter& operator=(const LayerWriter&) = delete;
+
+    void begin(const Circuit<Field>& hdr) {
+      rep_.serialize_header(header_, hdr, hdr.nl);
+      circuit_id_header(sha_, hdr, rep_.f_);
+      nl_ = hdr.nl;
+    }
+
+    void layer(Layer<Field> layer) {
+      check(nl_ > 0, "LayerWriter: too many layers");
+      --nl_;
+      rep_.serialize_layer(quadb_, layer, eh_);
+      circuit_id_layer(sha_, layer, rep_.f_);
+    }
+
+    // Append the serialized circuit to BYTES and store the circuit id
+    // into ID.  Can be called only once.
+    void finish(std::vector<uint8_t>& bytes, uint8_t id[/*32*/]) {
+      check(nl_ == 0, "LayerWriter: missing layers");
+      sha_.DigestData(id);
+      bytes.insert(bytes.end(), header_.begin(), header_.end());
+      rep_.serialize_constants(bytes, eh_);
+      bytes.insert(bytes.end(), quadb_.begin(), quadb_.end());
+      std::vector<uint8_t>().swap(quadb_);
+      bytes.insert(bytes.end(), id, id + 32);
+    }
+
+   private:
+    const CircuitRep& rep_;
+    EltHash eh_;
+    SHA256 sha_;
+    size_t nl_;  // number of layers still expected
+    std::vector<uint8_t> header_;
+    std::vector<uint8_t> quadb_;
+  };
 };
 }  // namespace proofs
 
@@ -197,5 +197,61 @@ TEST(circuit_io, SHA) {
   serialize_test3<Fp128>(*circuit, Fg, FP128_ID);
 }
 
+TEST(circuit_io, streaming) {
+  using Fp128 = Fp128<>;
+  using CompilerBackend = CompilerBackend<Fp128>;
+  using LogicCircuit = Logic<Fp128, CompilerBackend>;
+  using v8C = LogicCircuit::v8;
+  using FlatShaC = FlatSHA256Circuit<LogicCircuit, BitPlucker<LogicCircuit, 2>>;
+
+  const Fp128 Fg;
+  constexpr size_t kBlocks = 2;
+
+  auto build = [&](QuadCircuit<Fp128>& Q) {
+    const CompilerBackend cbk(&Q);
+    const LogicCircuit lc(&cbk, Fg);
+    FlatShaC fsha(lc);
+
+    v8C numbW = lc.vinput<8>();
+    Q.private_input();
+    std::vector<v8C> inW(64 * kBlocks);
+    for (size_t i = 0; i < kBlocks * 64; ++i) {
+      inW[i] = lc.vinput<8>();
+    }
+    Q.begin_full_field();
+    std::vector<FlatShaC::BlockWitness> bwW(kBlocks);
+    for (size_t j = 0; j < kBlocks; j++) {
+      bwW[j].input(Q);
+    }
+    fsha.assert_message(kBlocks, numbW, inW.data(), bwW.data());
+  };
+
+  std::vector<uint8_t> bytes0;
+  std::unique_ptr<Circuit<Fp128>> circuit;
+  {
+    QuadCircuit<Fp128> Q(Fg);
+    build(Q);
+    circuit = Q.mkcircuit(1);
+    CircuitRep<Fp128> cr(Fg, FP128_ID);
+    cr.to_bytes(*circuit, bytes0);
+  }
+
+  std::vector<uint8_t> bytes1;
+  uint8_t id[32];
+  {
+    QuadCircuit<Fp128> Q(Fg);
+    build(Q);
+    CircuitRep<Fp128> cr(Fg, FP128_ID);
+    CircuitRep<Fp128>::LayerWriter wr(cr);
+    Q.mkcircuit(1, wr);
+    wr.finish(bytes1, id);
+  }
+
+  EXPECT_EQ(bytes0, bytes1);
+  for (size_t i = 0; i < 32; ++i) {
+    EXPECT_EQ(id[i], circuit->id[i]);
+  }
+}
+
 }  // namespace
 }  // namespace proofs
@@ -24,13 +24,14 @@
 
 namespace proofs {
 
-// This method produces a unique name for a circuit. It does not match
-// the serialization method for the circuit.
+// The circuit id is computed incrementally, first over the header and
+// then over each layer in output-to-input order, so that it can be
+// computed by a streaming consumer that never holds the whole circuit.
+// The header fields of C (but not C.l) must be set.
 template <class Field>
-void circuit_id(uint8_t id[/*32*/], const Circuit<Field>& c, const Field& F) {
+void circuit_id_header(SHA256& sha, const Circuit<Field>& c, const Field& F) {
   const uint64_t CHAR2 = 0x2;
   const uint64_t ODD = 0x1;
-  SHA256 sha;
   uint8_t tmp[Field::kBytes];
   if (F.kCharacteristicTwo) {
     // Characteristic two fields are uniquely determined by their length
@@ -51,17 +52,31 @@ void circuit_id(uint8_t id[/*32*/], const Circuit<Field>& c, const Field& F) {
   sha.Update8(c.ninputs);
   sha.Update8(c.npub_in);
   sha.Update8(c.subfield_boundary);
+}
+
+template <class Field>
+void circuit_id_layer(SHA256& sha, const Layer<Field>& layer, const Field& F) {
+  uint8_t tmp[Field::kBytes];
+  sha.Update8(layer.nw);
+  sha.Update8(layer.logw);
+  sha.Update8(layer.quad->n_);
+  for (size_t i = 0; i < layer.quad->n_; ++i) {
+    sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].g));
+    sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].h[0]));
+    sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].h[1]));
+    F.to_bytes_field(tmp, layer.quad->c_[i].v);
+    sha.Update(tmp, sizeof(tmp));
+  }
+}
+
+// This method produces a unique name for a circuit. It does not match
+// the serialization method for the circuit.
+template <class Field>
+void circuit_id(uint8_t id[/*32*/], const Circuit<Field>& c, const Field& F) {
+  SHA256 sha;
+  circuit_id_header(sha, c, F);
   for (const auto& layer : c.l) {
-    sha.Update8(layer.nw);
-    sha.Update8(layer.logw);
-    sha.Update8(layer.quad->n_);
-    for (size_t i = 0; i < layer.quad->n_; ++i) {
-      sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].g));
-      sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].h[0]));
-      sha.Update8(static_cast<uint64_t>(layer.quad->c_[i].h[1]));
-      F.to_bytes_field(tmp, layer.quad->c_[i].v);
-      sha.Update(tmp, sizeof(tmp));
-    }
+    circuit_id_layer(sha, layer, F);
   }
   sha.DigestData(id);
 }
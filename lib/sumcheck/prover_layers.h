@@ -218,8 +218,13 @@ class ProverLayers {
     W->reshape(W->n1_);
     check(W->n1_ == 1, "W->n1_ == 1");
 
+    // Padded circuits carry long runs of zero wires, which the loops
+    // below skip.  The zero extents shrink along with W in bind().
+    W->track_zero_extents(F);
+
     auto Wclone = W->clone();                 // keep alive until function end
     Dense<Field>* WH[2] = {W, Wclone.get()};  // reuse W
+    std::vector<bool> zmask;  // reused across rounds
 
     for (size_t round = 0; round < logw; ++round) {
       for (size_t hand = 0; hand < 2; hand++) {
@@ -230,20 +235,27 @@ class ProverLayers {
         QW.clear(F);
         size_t ohand = 1 - hand;
 
-        // QW[l] = SUM_{r} Q[l,r] W[r]
+        // QW[l] = SUM_{r} Q[l,r] W[r], where the corners r in the zero
+        // extents of W contribute nothing.
+        WH[ohand]->zero_mask(zmask);
+        const bool sparse = !zmask.empty();
         for (index_t i = 0; i < QUAD->n_; ++i) {
           corner_t p0(QUAD->c_[i].h[hand]);
           corner_t p1(QUAD->c_[i].h[ohand]);
+          if (sparse && zmask[p1]) {
+            continue;
+          }
           F.add(QW.v_[p0], F.mulf(QUAD->c_[i].v, WH[ohand]->v_[p1]));
         }
 
-        // SUM_{l} QW[l] W[l].
+        // SUM_{l} QW[l] W[l], where the pairs of W[l] that are known
+        // to be zero contribute nothing.
         WPoly sum{};
-        for (corner_t l = 0; l < QW.n0_; l += 2) {
+        WH[hand]->for_each_nonzero_pair([&](corner_t l) {
           WPoly poly = wpoly_at_dense(WH[hand], l, 0, F)
                            .mul(wpoly_at_dense(&QW, l, 0, F), F);
           sum.add(poly, F);
-        }
+        });
 
         sum.mul_scalar(eq0, F);
         Elt rnd = round_h(pr, pad, ts, layer, hand, round, sum, F);
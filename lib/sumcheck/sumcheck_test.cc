@@ -231,14 +231,16 @@ TEST(Sumcheck, EvalCircuit) {
   Proof<Field> P(CIRCUIT->nl);
 }
 
-void one_test_sumcheck_without_com(const Circuit<Field>* CIRCUIT) {
+// Input wires at index ZERO_FROM and beyond are zero.
+void one_test_sumcheck_without_com(const Circuit<Field>* CIRCUIT,
+                                   corner_t zero_from) {
   auto nc = CIRCUIT->nc;
   auto nl = CIRCUIT->nl;
 
   // random inputs
   auto Wprover = std::make_unique<Dense<Field>>(nc, CIRCUIT->l[nl - 1].nw);
   for (corner_t i = 0; i < Wprover->n0_ * Wprover->n1_; ++i) {
-    Wprover->v_[i] = rng.next();
+    Wprover->v_[i] = (i / nc < zero_from) ? rng.next() : F.zero();
   }
   auto Wverifier = Wprover->clone();
 
@@ -258,8 +260,9 @@ void one_test_sumcheck_without_com(const Circuit<Field>* CIRCUIT) {
   EXPECT_EQ(why, "ok");
 }
 
-void one_test_sumcheck(const Circuit<Field>* CIRCUIT) {
-  one_test_sumcheck_without_com(CIRCUIT);
+void one_test_sumcheck(const Circuit<Field>* CIRCUIT,
+                       corner_t zero_from = ~corner_t(0)) {
+  one_test_sumcheck_without_com(CIRCUIT, zero_from);
 }
 
 TEST(Sumcheck, SumcheckAddE) {
@@ -318,5 +321,15 @@ TEST(Sumcheck, RandomCircuit) {
     one_test_sumcheck(CIRCUIT.get());
   }
 }
+
+// Inputs with long runs of zeros exercise the zero extents in the prover.
+TEST(Sumcheck, SparseInputs) {
+  for (size_t i = 0; i < 10; ++i) {
+    auto CIRCUIT = random_circuit();
+    CIRCUIT->nc = 1;
+    CIRCUIT->logc = 0;
+    one_test_sumcheck(CIRCUIT.get(), /*zero_from=*/i);
+  }
+}
 }  // namespace
 }  // namespace proofs
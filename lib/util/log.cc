@@ -17,6 +17,8 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <atomic>
+
 // The logic of these #ifdefs implements the following:
 //   1. If we are building for Android, use the android logging library.
 //   2. If we are building for google3, use the absl logging library.
@@ -31,15 +33,19 @@
 #else
 // The point of using std::chrono is to avoid the dependency on absl::time.
 #include <chrono>
+#include <mutex>
 #endif
 
 namespace proofs {
 
 // This implementation maintains its own error thresholds in order to
 // support future migration away from absl or android logging libraries.
-static enum LogLevel _LOG_LEVEL = INFO;
+// log() may be called from several threads.
+static std::atomic<LogLevel> _LOG_LEVEL(INFO);
 
 #if !defined(__ABSL__)
+// _last is guarded by _last_mu.
+static std::mutex _last_mu;
 static auto _last = std::chrono::steady_clock::now();
 const char* level_str(enum LogLevel l) {
   switch (l) {
@@ -96,6 +102,7 @@ void log(enum LogLevel l, const char* format, ...) {
   using microseconds = std::chrono::microseconds;
   using milliseconds = std::chrono::milliseconds;
   if (l <= _LOG_LEVEL) {
+    std::lock_guard<std::mutex> lock(_last_mu);
     auto nt = std::chrono::steady_clock::now();
     auto mus = std::chrono::duration_cast<microseconds>(nt - _last).count();
     auto ms = std::chrono::duration_cast<milliseconds>(nt - _last).count();
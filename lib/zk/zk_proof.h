@@ -68,11 +68,11 @@ struct ZkProof {
         com_proof(&param) {}
 
   explicit ZkProof(const Circuit<Field> &c, size_t rate, size_t req,
-                   size_t block_enc)
+                   size_t block_enc, size_t grind_bits = 0)
       : c(c),
         proof(c.nl),
         param((c.ninputs - c.npub_in) + ZkCommon<Field>::pad_size(c), c.nl,
-              rate, req, block_enc),
+              rate, req, block_enc, grind_bits),
         com_proof(&param) {}
 
   // Maximum size of the proof in bytes. The actual size will be smaller
@@ -84,7 +84,8 @@ struct ZkProof {
 
            com_proof.block * 2 * Field::kBytes +
            com_proof.nreq * com_proof.nrow * Field::kBytes +
-           com_proof.nreq * com_proof.mc_pathlen * Digest::kLength;
+           com_proof.nreq * com_proof.mc_pathlen * Digest::kLength +
+           (com_proof.grind_bits > 0 ? sizeof(uint64_t) : 0);
   }
 
   void write(std::vector<uint8_t> &buf, const Field &F) const {
@@ -149,6 +150,14 @@ struct ZkProof {
       write_elt(pr.y_quad_2[i], buf, F);
     }
 
+    // The proof-of-work nonce is only present with grinding, so that
+    // proofs without grinding are unchanged.
+    if (pr.grind_bits > 0) {
+      uint8_t tmp[8];
+      u64_to_le(tmp, pr.pow_nonce);
+      buf.insert(buf.end(), tmp, tmp + sizeof(tmp));
+    }
+
     // write all the Merkle nonces
     for (size_t i = 0; i < pr.nreq; ++i) {
       write_nonce(pr.merkle.nonce[i], buf);
@@ -298,6 +307,11 @@ struct ZkProof {
       }
     }
 
+    if (pr.grind_bits > 0) {
+      if (!buf.have(8)) return false;
+      pr.pow_nonce = u64_of_le(buf.next(8));
+    }
+
     if (!buf.have(pr.nreq * MerkleNonce::kLength)) return false;
     for (size_t i = 0; i < pr.nreq; ++i) {
       read_nonce(buf, pr.merkle.nonce[i]);
@@ -55,11 +55,11 @@ class ZkVerifier {
 
   explicit ZkVerifier(const Circuit<Field>& c, const RSFactory& rsf,
                       size_t rate, size_t nreq, size_t block_enc,
-                      const Field& F)
+                      const Field& F, size_t grind_bits = 0)
       : circ_(c),
         n_witness_(c.ninputs - c.npub_in),
         param_(n_witness_ + ZkCommon<Field>::pad_size(c), c.nl, rate, nreq,
-               block_enc),
+               block_enc, grind_bits),
         lqc_(c.nl),
         rsf_(rsf),
         f_(F) {